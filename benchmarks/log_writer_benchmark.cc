@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    log_writer_benchmark.cc
+ * \brief   Micro-benchmark of writing log lines (reopening the log file per write versus the batched log writer) & the log compression
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_writer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+//// Number of log lines written per implementation
+static const int Lines = 200000;
+//// Number of concurrent jobs (each job writes Lines / Jobs lines)
+static const int Jobs = 4;
+//// Size of the generated log file that is compressed
+static const std::size_t CompressLogSize = 256 * 1024 * 1024;
+//// Typical Wine debug output line
+static const string Line = "0024:fixme:ntdll:NtQuerySystemInformation info_class SYSTEM_PERFORMANCE_INFORMATION";
+
+/**
+ * \brief Count the lines of the log file generations, and the lines that are reported as dropped
+ */
+static std::size_t count_lines(const string& file_path, int generations, std::size_t& dropped_lines, std::size_t& max_file_size)
+{
+  std::size_t lines = 0;
+  dropped_lines = 0;
+  max_file_size = 0;
+  for (int generation = 0; generation <= generations; generation++)
+  {
+    string path = LogWriter::get_generation_path(file_path, generation);
+    if (!std::filesystem::exists(path))
+      continue;
+    max_file_size = std::max(max_file_size, static_cast<std::size_t>(std::filesystem::file_size(path)));
+    std::ifstream file(path);
+    string line;
+    while (std::getline(file, line))
+    {
+      if (line.starts_with("WineGUI: "))
+        dropped_lines += std::stoul(line.substr(9));
+      else
+        lines++;
+    }
+  }
+  return lines;
+}
+
+/**
+ * \brief Generate a Wine relay log file (varying addresses & values, like WINEDEBUG=+relay)
+ */
+static void generate_relay_log(const string& file_path)
+{
+  std::ofstream file(file_path, std::ios::binary);
+  char line[160];
+  std::size_t size = 0;
+  for (unsigned int i = 0; size < CompressLogSize; i++)
+  {
+    int length = std::snprintf(line, sizeof(line),
+                               "0024:Call KERNEL32.HeapAlloc(%08x,00000000,%08x) ret=7bc3%04x\n"
+                               "0024:Ret  KERNEL32.HeapAlloc() retval=%08x\n",
+                               0x00110000 + (i % 7) * 0x1000, (i * 37) % 4096, i % 65536, 0x0025a000 + i * 16);
+    file.write(line, length);
+    size += static_cast<std::size_t>(length);
+  }
+}
+
+/**
+ * \brief Compress the file with the number of threads, print the throughput & ratio and verify the decompressed file
+ * \return True when the decompressed file is equal to the original file
+ */
+static bool run_compression(const string& label, const string& file_path, int threads)
+{
+  string compressed_path = file_path + ".gz";
+  string decompressed_path = file_path + ".decompressed";
+  int input_fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  auto start = std::chrono::steady_clock::now();
+  bool is_compressed = LogCompressor::compress_file(input_fd, compressed_path, threads);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  close(input_fd);
+
+  double input_size = static_cast<double>(std::filesystem::file_size(file_path));
+  double compressed_size = static_cast<double>(std::filesystem::file_size(compressed_path));
+  std::printf("%-40s %10.1f ms %10.1f MB/s  ratio %.1f\n", label.c_str(), elapsed.count() * 1000.0, input_size / (1024.0 * 1024.0) / elapsed.count(),
+              input_size / compressed_size);
+
+  bool is_equal = is_compressed && LogCompressor::decompress_file(compressed_path, decompressed_path) &&
+                  std::filesystem::file_size(decompressed_path) == std::filesystem::file_size(file_path);
+  if (is_equal)
+  {
+    std::ifstream original(file_path, std::ios::binary);
+    std::ifstream decompressed(decompressed_path, std::ios::binary);
+    is_equal = std::equal(std::istreambuf_iterator<char>(original), std::istreambuf_iterator<char>(), std::istreambuf_iterator<char>(decompressed));
+  }
+  std::filesystem::remove(compressed_path);
+  std::filesystem::remove(decompressed_path);
+  return is_equal;
+}
+
+int main()
+{
+  std::filesystem::path directory = std::filesystem::temp_directory_path() / "winegui-log-benchmark";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  string legacy_path = (directory / "legacy.log").string();
+  string log_path = (directory / "winegui.log").string();
+
+  // Previous implementation: the log file is opened for appending on every write (like Gio::File::append_to)
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < Lines; i++)
+  {
+    std::ofstream file(legacy_path, std::ios::app);
+    file << Line << '\n';
+  }
+  std::chrono::duration<double, std::milli> legacy_elapsed = std::chrono::steady_clock::now() - start;
+  std::printf("%-40s %10.1f ms\n", "reopen per write (old)", legacy_elapsed.count());
+
+  const std::size_t max_file_size = 4 * 1024 * 1024;
+  const int generations = 3;
+  std::chrono::duration<double, std::milli> write_elapsed;
+  start = std::chrono::steady_clock::now();
+  {
+    // Compression is disabled (default), so the lines of the rotated log files can be counted
+    LogCompressor log_compressor;
+    LogWriter log_writer(log_compressor, max_file_size, generations, 1024 * 1024);
+    std::vector<LogChannel> channels;
+    for (int job = 0; job < Jobs; job++)
+      channels.push_back(LogWriter::open_channel(log_path, "Benchmark", "job" + std::to_string(job)));
+    for (int i = 0; i < Lines; i++)
+      log_writer.write(channels.at(static_cast<std::size_t>(i % Jobs)), static_cast<std::uint64_t>(i % Jobs + 1), Line);
+    write_elapsed = std::chrono::steady_clock::now() - start;
+    // Destructor writes the remaining lines
+  }
+  std::chrono::duration<double, std::milli> total_elapsed = std::chrono::steady_clock::now() - start;
+  std::printf("%-40s %10.1f ms (write calls: %.1f ms)\n", "log writer, batched", total_elapsed.count(), write_elapsed.count());
+
+  std::size_t dropped_lines = 0;
+  std::size_t largest_file = 0;
+  std::size_t lines = count_lines(log_path, generations, dropped_lines, largest_file);
+  std::printf("\nLines in the %d generations: %zu, dropped: %zu (the oldest generations are removed by the rotation)\n", generations + 1, lines,
+              dropped_lines);
+  std::printf("Largest log file: %zu bytes (maximum %zu bytes)\n", largest_file, max_file_size);
+
+  string relay_log_path = (directory / "relay.log").string();
+  generate_relay_log(relay_log_path);
+  int cpu_cores = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+  std::printf("\nCompression of a %zu MB relay log (gzip level 1, %d CPU cores)\n\n", CompressLogSize / (1024 * 1024), cpu_cores);
+  bool is_equal = run_compression("threads: 1", relay_log_path, 1);
+  int threads = LogCompressor::get_max_threads(25);
+  is_equal = run_compression("threads: " + std::to_string(threads) + " (25% CPU share)", relay_log_path, threads) && is_equal;
+  is_equal = run_compression("threads: " + std::to_string(cpu_cores) + " (100% CPU share)", relay_log_path, cpu_cores) && is_equal;
+  std::printf("\nDecompressed files equal: %s\n", is_equal ? "yes" : "NO");
+
+  std::filesystem::remove_all(directory);
+  return largest_file <= max_file_size && is_equal ? 0 : 1;
+}
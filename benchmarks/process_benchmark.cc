@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    process_benchmark.cc
+ * \brief   Micro-benchmark of starting programs: popen() via /bin/sh versus posix_spawn (latency & output throughput)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "process.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+//// Trivial program, an absolute path so the shell doesn't use its 'true' builtin
+static const string TrivialProgram = "/bin/true";
+//// Spawn-to-exit runs per implementation (the median is reported)
+static const int LatencyIterations = 300;
+//// Number of lines printed by the output throughput test
+static const string ThroughputLines = "2000000";
+
+/**
+ * \brief Previous implementation (shell command string, popen() & fgets() with a 128 bytes buffer), kept as baseline
+ */
+static std::pair<int, string> legacy_exec(const string& command)
+{
+  int exit_code = -1;
+  string output = "";
+  {
+    std::array<char, 128> buffer{};
+    auto deleter = [&exit_code](std::FILE* ptr) { exit_code = pclose(ptr); };
+    std::unique_ptr<std::FILE, decltype(deleter)> pipe(popen(command.c_str(), "r"), deleter);
+    if (!pipe)
+      throw std::runtime_error("popen() failed!");
+    while (std::fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
+      output += buffer.data();
+  }
+  return std::make_pair(exit_code, output);
+}
+
+/**
+ * \brief Run the function several times and print the median & best spawn-to-exit latency
+ */
+static void run_latency(const string& label, const std::function<void()>& function)
+{
+  std::vector<double> durations;
+  durations.reserve(LatencyIterations);
+  for (int i = 0; i < LatencyIterations; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    durations.push_back(elapsed.count());
+  }
+  std::sort(durations.begin(), durations.end());
+  std::printf("%-40s median %8.1f us   best %8.1f us\n", label.c_str(), durations.at(durations.size() / 2), durations.front());
+}
+
+/**
+ * \brief Run the function several times and print the best output throughput
+ * \return Output size of the last run
+ */
+static std::size_t run_throughput(const string& label, int iterations, const std::function<std::size_t()>& function)
+{
+  std::size_t size = 0;
+  double best_seconds = 1e9;
+  for (int i = 0; i < iterations; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    size = function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best_seconds = std::min(best_seconds, elapsed.count());
+  }
+  double mega_bytes = static_cast<double>(size) / (1024.0 * 1024.0);
+  std::printf("%-40s %10.3f ms %10.1f MB/s (%zu bytes)\n", label.c_str(), best_seconds * 1000.0, mega_bytes / best_seconds, size);
+  return size;
+}
+
+int main()
+{
+  // Same shape as a Wine launch: working directory, a few environment variables & stderr captured
+  string working_directory = std::filesystem::temp_directory_path().string();
+  ProcessOptions options{working_directory, {{"WINEDEBUG", "-all"}, {"WINEPREFIX", "/tmp/winegui-benchmark"}}, true};
+  string legacy_command = "cd \"" + working_directory + "\" && WINEDEBUG=-all WINEPREFIX=\"/tmp/winegui-benchmark\" ";
+
+  std::printf("Spawn-to-exit latency of '%s' (%d runs)\n\n", TrivialProgram.c_str(), LatencyIterations);
+  run_latency("popen + /bin/sh + fgets (old)", [&]() { legacy_exec(legacy_command + TrivialProgram + " 2>&1"); });
+  run_latency("posix_spawn (Process::run)", [&]() { Process::run({TrivialProgram}, options); });
+
+  std::printf("\nOutput throughput of 'seq 1 %s'\n\n", ThroughputLines.c_str());
+  vector<string> seq_argv{"seq", "1", ThroughputLines};
+  string seq_command = legacy_command + "seq 1 " + ThroughputLines + " 2>&1";
+  std::size_t legacy_size = run_throughput("popen + /bin/sh + fgets (old)", 3, [&]() { return legacy_exec(seq_command).second.size(); });
+  std::size_t capture_size = run_throughput("posix_spawn, captured", 3, [&]() { return Process::run(seq_argv, options).output.size(); });
+  std::size_t stream_size = run_throughput("posix_spawn, streamed", 3,
+                                           [&]()
+                                           {
+                                             std::size_t size = 0;
+                                             Process::run(seq_argv, options, [&size](std::string_view chunk) { size += chunk.size(); });
+                                             return size;
+                                           });
+
+  bool is_equal = legacy_size == capture_size && legacy_size == stream_size;
+  std::printf("\nOutput sizes equal: %s\n", is_equal ? "yes" : "NO");
+  return is_equal ? 0 : 1;
+}
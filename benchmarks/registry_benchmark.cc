@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_benchmark.cc
+ * \brief   Micro-benchmark of the Wine registry readers (MB/s)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "registry_hive.h"
+#include "registry_tokenizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using std::vector;
+
+static const string RegKeyMenuFiles = "[Software\\\\Wine\\\\MenuFiles]";
+static const string RegValueMenu = "\\Start Menu\\";
+static const string IgnoreFilter = "applications-merged";
+
+/**
+ * \brief Write a synthetic user.reg file, the menu files key is placed at the end (worst case for a sequential scan)
+ * \param[in] file_path Output file
+ * \param[in] target_size Approximate file size in bytes
+ */
+static void generate_registry(const string& file_path, std::size_t target_size)
+{
+  std::ofstream out(file_path, std::ios::trunc);
+  out << "WINE REGISTRY Version 2\n;; All keys relative to \\\\User\\\\S-1-5-21-0-0-0-1000\n\n#arch=win64\n\n";
+  std::size_t key_index = 0;
+  while (static_cast<std::size_t>(out.tellp()) < target_size)
+  {
+    out << "[Software\\\\Classes\\\\CLSID\\\\{" << key_index << "-0000-0000-C000-000000000046}] 1700000000\n#time=1d9a2b3c4d5e6f7\n";
+    out << "@=\"Some COM class " << key_index << "\"\n";
+    out << "\"ThreadingModel\"=\"Both\"\n";
+    out << "\"Flags\"=dword:00000001\n\n";
+    key_index++;
+  }
+  out << RegKeyMenuFiles << " 1700000000\n#time=1d9a2b3c4d5e6f7\n";
+  for (int i = 0; i < 2000; i++)
+  {
+    out << "\"/home/user/.local/share/applications/wine/Programs/App " << i << ".desktop\"=\"C:\\\\users\\\\user\\\\AppData\\\\Roaming\\\\Microsoft\\\\"
+        << "Windows\\\\Start Menu\\\\Programs\\\\App " << i << ".lnk\"\n";
+    if (i % 10 == 0)
+      out << "\"/home/user/.config/menus/applications-merged/wine-App " << i << ".menu\"=\"C:\\\\users\\\\user\\\\AppData\\\\Roaming\\\\"
+          << "Microsoft\\\\Windows\\\\Start Menu\\\\Programs\\\\App " << i << ".lnk\"\n";
+  }
+  out << "\n";
+}
+
+/**
+ * \brief Previous implementation (std::getline + unescape every line + split), kept as baseline
+ */
+static vector<string> legacy_value_data_filter_ignore(const string& file_path,
+                                                      const string& key_name,
+                                                      const string& key_value_filter,
+                                                      const string& key_name_ignore_filter)
+{
+  auto split = [](const string& s, const char delimiter)
+  {
+    size_t start = 0;
+    size_t end = s.find_first_of(delimiter);
+    vector<string> output;
+    output.reserve(3);
+    while (end <= string::npos)
+    {
+      output.emplace_back(s.substr(start, end - start));
+      if (end == string::npos)
+        break;
+      start = end + 1;
+      end = s.find_first_of(delimiter, start);
+    }
+    return output;
+  };
+
+  vector<string> keys;
+  keys.reserve(10);
+  std::ifstream reg_file(file_path);
+  if (!reg_file.is_open())
+    throw std::runtime_error("Could not open registry file!");
+  string line;
+  line.reserve(128);
+  bool match = false;
+  while (std::getline(reg_file, line))
+  {
+    if (!match)
+    {
+      match = line.starts_with(key_name);
+    }
+    else
+    {
+      if (line.empty() || reg_file.eof())
+        break;
+      line = RegistryTokenizer::unescape(line);
+      if (!line.starts_with('#') && (key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
+          (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
+      {
+        auto results = split(line, '"');
+        if (results.size() >= 5)
+        {
+          line = results.at(3);
+          line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
+          keys.emplace_back(line);
+        }
+      }
+    }
+  }
+  return keys;
+}
+
+/**
+ * \brief Current implementation, same as Helper::get_reg_keys_value_data_filter_ignore()
+ */
+static vector<string> tokenizer_value_data_filter_ignore(const string& file_path,
+                                                         const string& key_name,
+                                                         const string& key_value_filter,
+                                                         const string& key_name_ignore_filter)
+{
+  auto hive = RegistryHive::open(file_path);
+  if (!hive)
+    throw std::runtime_error("Could not open registry file!");
+  vector<string> keys;
+  keys.reserve(10);
+  string name_buffer, data_buffer;
+  RegistryTokenizer tokenizer(hive->get_key_body(key_name));
+  RegistryValue value;
+  while (tokenizer.next_value(value))
+  {
+    if (!value.is_string)
+      continue;
+    std::string_view name = value.name;
+    std::string_view data = value.data;
+    if (value.is_escaped)
+    {
+      name_buffer.clear();
+      data_buffer.clear();
+      RegistryTokenizer::unescape(value.name, name_buffer);
+      RegistryTokenizer::unescape(value.data, data_buffer);
+      name = name_buffer;
+      data = data_buffer;
+    }
+    bool is_matching = key_value_filter.empty() || name.find(key_value_filter) != std::string_view::npos ||
+                       data.find(key_value_filter) != std::string_view::npos;
+    bool is_ignored = !key_name_ignore_filter.empty() &&
+                      (name.find(key_name_ignore_filter) != std::string_view::npos || data.find(key_name_ignore_filter) != std::string_view::npos);
+    if (is_matching && !is_ignored)
+      keys.emplace_back(data);
+  }
+  return keys;
+}
+
+/**
+ * \brief Count all key sections with the tokenizer (raw scan speed, without file I/O)
+ */
+static vector<string> tokenizer_scan_all_keys(std::string_view buffer)
+{
+  RegistryTokenizer tokenizer(buffer);
+  std::string_view name, body;
+  std::size_t count = 0;
+  while (tokenizer.next_key(name, body))
+    count++;
+  return vector<string>(1, std::to_string(count));
+}
+
+/**
+ * \brief Run the function several times and print the best throughput
+ * \return Result of the last run (used to compare implementations)
+ */
+static vector<string> run(const string& label, std::size_t file_size, int iterations, const std::function<vector<string>()>& function)
+{
+  vector<string> result;
+  double best_seconds = 1e9;
+  for (int i = 0; i < iterations; i++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    result = function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best_seconds = std::min(best_seconds, elapsed.count());
+  }
+  double mega_bytes = static_cast<double>(file_size) / (1024.0 * 1024.0);
+  std::printf("%-36s %10.3f ms %12.1f MB/s (%zu results)\n", label.c_str(), best_seconds * 1000.0, mega_bytes / best_seconds, result.size());
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+  string file_path;
+  bool is_generated = false;
+  if (argc > 1)
+  {
+    file_path = argv[1];
+  }
+  else
+  {
+    file_path = (std::filesystem::temp_directory_path() / "winegui_benchmark_user.reg").string();
+    generate_registry(file_path, 40 * 1024 * 1024);
+    is_generated = true;
+  }
+  std::size_t file_size = std::filesystem::file_size(file_path);
+  std::printf("Registry file: %s (%.1f MB)\n\n", file_path.c_str(), static_cast<double>(file_size) / (1024.0 * 1024.0));
+
+  auto legacy = run("getline + unescape + split (old)", file_size, 3,
+                    [&]() { return legacy_value_data_filter_ignore(file_path, RegKeyMenuFiles, RegValueMenu, IgnoreFilter); });
+  auto cold = run("tokenizer, cold (map + index)", file_size, 3,
+                  [&]()
+                  {
+                    RegistryHive::invalidate(file_path);
+                    return tokenizer_value_data_filter_ignore(file_path, RegKeyMenuFiles, RegValueMenu, IgnoreFilter);
+                  });
+  auto warm = run("tokenizer, warm (cached hive)", file_size, 20,
+                  [&]() { return tokenizer_value_data_filter_ignore(file_path, RegKeyMenuFiles, RegValueMenu, IgnoreFilter); });
+  std::ifstream reg_file(file_path, std::ios::binary);
+  string buffer((std::istreambuf_iterator<char>(reg_file)), std::istreambuf_iterator<char>());
+  run("tokenizer, scan all keys (in memory)", file_size, 5, [&]() { return tokenizer_scan_all_keys(buffer); });
+
+  bool is_equal = legacy == cold && legacy == warm;
+  std::printf("\nResults equal: %s\n", is_equal ? "yes" : "NO");
+
+  if (is_generated)
+    std::filesystem::remove(file_path);
+  return is_equal ? 0 : 1;
+}
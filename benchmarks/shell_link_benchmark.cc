@@ -0,0 +1,301 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    shell_link_benchmark.cc
+ * \brief   Micro-benchmark of the Windows shortcut (*.lnk) readers (shortcuts/s)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "shell_link.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+using std::vector;
+
+//// Number of generated shortcuts, when no corpus directory is given
+static const int GeneratedShortcuts = 2000;
+
+/**
+ * \brief Generated shortcut file and its expected target path
+ */
+struct Shortcut
+{
+  string file_path;
+  string expected_target;
+};
+
+static void put_u16(string& out, std::uint16_t value)
+{
+  out += static_cast<char>(value & 0xFF);
+  out += static_cast<char>(value >> 8);
+}
+
+static void put_u32(string& out, std::uint32_t value)
+{
+  put_u16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+  put_u16(out, static_cast<std::uint16_t>(value >> 16));
+}
+
+/**
+ * \brief Counted UTF-16LE string of the StringData section (the generated strings are ASCII)
+ */
+static void put_counted_string(string& out, const string& text)
+{
+  put_u16(out, static_cast<std::uint16_t>(text.size()));
+  for (char c : text)
+    put_u16(out, static_cast<unsigned char>(c));
+}
+
+/**
+ * \brief Build a shortcut like Windows does: IDList (My Computer, drive, file entries), LinkInfo and Unicode strings
+ * \param[in] target Windows target path, eg. C:\\Program Files\\App\\app.exe
+ * \param[in] has_link_info Add the LinkInfo section, otherwise the target is only in the IDList
+ * \return Contents of the shortcut file
+ */
+static string build_shortcut(const string& target, bool has_link_info)
+{
+  const std::uint32_t flags = 0x01 | (has_link_info ? 0x02 : 0x00) | 0x04 | 0x10 | 0x20 | 0x40 | 0x80;
+  string out;
+  put_u32(out, 0x4C);
+  const unsigned char clsid[16] = {0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46};
+  out.append(reinterpret_cast<const char*>(clsid), sizeof(clsid));
+  put_u32(out, flags);
+  put_u32(out, 0x20);              // FileAttributes
+  out.append(24, '\0');            // Creation, access & write time
+  put_u32(out, 123456);            // FileSize
+  put_u32(out, 0);                 // IconIndex
+  put_u32(out, 1);                 // ShowCommand
+  out.append(2 + 2 + 4 + 4, '\0'); // HotKey & reserved
+
+  // LinkTargetIDList
+  string id_list;
+  const unsigned char my_computer[16] = {0xE0, 0x4F, 0xD0, 0x20, 0xEA, 0x3A, 0x69, 0x10, 0xA2, 0xD8, 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D};
+  put_u16(id_list, 0x14);
+  id_list += '\x1F';
+  id_list += '\x50';
+  id_list.append(reinterpret_cast<const char*>(my_computer), sizeof(my_computer));
+  put_u16(id_list, 0x19);
+  id_list += '\x2F';
+  id_list += target.substr(0, 3);
+  id_list.append(0x19 - 3 - 3, '\0');
+  std::size_t start = 3;
+  while (start < target.size())
+  {
+    std::size_t end = std::min(target.find('\\', start), target.size());
+    string name = target.substr(start, end - start);
+    std::size_t item_size = 14 + name.size() + 1;
+    item_size += item_size % 2;
+    put_u16(id_list, static_cast<std::uint16_t>(item_size));
+    id_list += end == target.size() ? '\x32' : '\x31';
+    id_list.append(11, '\0'); // Unknown, size, date, time & attributes
+    id_list += name;
+    id_list.append(item_size - 14 - name.size(), '\0');
+    start = end + 1;
+  }
+  put_u16(id_list, 0);
+  put_u16(out, static_cast<std::uint16_t>(id_list.size()));
+  out += id_list;
+
+  // LinkInfo, with a VolumeID and the local base path
+  if (has_link_info)
+  {
+    const std::uint32_t volume_id_size = 0x11;
+    const std::uint32_t base_path_offset = 0x1C + volume_id_size;
+    const std::uint32_t suffix_offset = base_path_offset + static_cast<std::uint32_t>(target.size()) + 1;
+    put_u32(out, suffix_offset + 1);
+    put_u32(out, 0x1C);
+    put_u32(out, 0x01);
+    put_u32(out, 0x1C);
+    put_u32(out, base_path_offset);
+    put_u32(out, 0);
+    put_u32(out, suffix_offset);
+    put_u32(out, volume_id_size);
+    // The old hex search expects the drive letter right before the VolumeLabelOffset (and an empty volume label),
+    // end the serial number with the drive letter so both implementations find the same targets
+    const std::uint32_t serial_number = 0x00345678 | (static_cast<std::uint32_t>(static_cast<unsigned char>(target[0])) << 24);
+    put_u32(out, 3);             // DriveType: fixed
+    put_u32(out, serial_number); // DriveSerialNumber
+    put_u32(out, 0x10);          // VolumeLabelOffset
+    out += '\0';
+    out += target;
+    out += '\0';
+    out += '\0';
+  }
+
+  string working_dir = target.substr(0, target.find_last_of('\\'));
+  put_counted_string(out, "Start the application");
+  put_counted_string(out, working_dir);
+  put_counted_string(out, "--fullscreen");
+  put_counted_string(out, target);
+  put_u32(out, 0); // TerminalBlock
+  return out;
+}
+
+/**
+ * \brief Write the synthetic shortcuts (every fourth shortcut has no LinkInfo section)
+ * \param[in] dir_path Output directory
+ * \return Shortcuts
+ */
+static vector<Shortcut> generate_shortcuts(const std::filesystem::path& dir_path)
+{
+  std::filesystem::create_directories(dir_path);
+  const string extensions[] = {".exe", ".bat", ".msi", ".txt", ".url"};
+  vector<Shortcut> shortcuts;
+  for (int i = 0; i < GeneratedShortcuts; i++)
+  {
+    string target = (i % 3 == 0 ? "D:\\Games\\Game " : "C:\\Program Files\\Vendor " + std::to_string(i % 7) + "\\App ") + std::to_string(i) +
+                    "\\bin\\app" + std::to_string(i) + extensions[i % 5];
+    string file_path = (dir_path / ("App " + std::to_string(i) + ".lnk")).string();
+    std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+    string data = build_shortcut(target, i % 4 != 0);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    shortcuts.push_back({file_path, target});
+  }
+  return shortcuts;
+}
+
+/**
+ * \brief Previous implementation (hex string search for C:\, D:\ and Z:\ drives), kept as baseline
+ */
+static string legacy_target_path(const string& file_path)
+{
+  auto string2hex = [](const string& str)
+  {
+    string hexstr;
+    hexstr.resize(str.size() * 2);
+    const size_t a = 'a' - 1;
+    for (size_t i = 0, c = str[0] & 0xFF; i < hexstr.size(); c = str[i / 2] & 0xFF)
+    {
+      hexstr[i++] = c > 0x9F ? (c / 16 - 9) | a : c / 16 | '0';
+      hexstr[i++] = (c & 0xF) > 9 ? (c % 16 - 9) | a : c % 16 | '0';
+    }
+    return hexstr;
+  };
+  auto hex2string = [](const string& hexstr)
+  {
+    string str;
+    str.resize((hexstr.size() + 1) / 2);
+    for (size_t i = 0, j = 0; i < str.size(); i++, j++)
+    {
+      str[i] = ((hexstr[j] & '@') ? hexstr[j] + 9 : hexstr[j]) << 4, j++;
+      str[i] |= ((hexstr[j] & '@') ? hexstr[j] + 9 : hexstr[j]) & 0xF;
+    }
+    return str;
+  };
+
+  std::ifstream file(file_path, std::ios::binary);
+  string file_content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  string hex_content = string2hex(file_content);
+  std::size_t target_path_starts = hex_content.find("431000000000");
+  if (target_path_starts == std::string::npos)
+    target_path_starts = hex_content.find("441000000000");
+  if (target_path_starts == std::string::npos)
+    target_path_starts = hex_content.find("5A1000000000");
+  string target_path;
+  if (target_path_starts != std::string::npos)
+  {
+    hex_content = hex_content.substr(target_path_starts + 12);
+    hex_content.resize(hex_content.find("00"));
+    target_path = hex2string(hex_content);
+  }
+  return target_path;
+}
+
+/**
+ * \brief Run the function several times and print the best throughput
+ * \return Target paths of the last run (used to compare implementations)
+ */
+static vector<string> run(const string& label,
+                          const vector<Shortcut>& shortcuts,
+                          int iterations,
+                          const std::function<string(const string&)>& function)
+{
+  vector<string> targets;
+  double best_seconds = 1e9;
+  for (int i = 0; i < iterations; i++)
+  {
+    targets.clear();
+    auto start = std::chrono::steady_clock::now();
+    for (const Shortcut& shortcut : shortcuts)
+      targets.push_back(function(shortcut.file_path));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best_seconds = std::min(best_seconds, elapsed.count());
+  }
+  std::size_t found = std::count_if(targets.begin(), targets.end(), [](const string& target) { return !target.empty(); });
+  std::printf("%-36s %10.3f ms %12.0f shortcuts/s (%zu/%zu targets found)\n", label.c_str(), best_seconds * 1000.0,
+              static_cast<double>(shortcuts.size()) / best_seconds, found, shortcuts.size());
+  return targets;
+}
+
+int main(int argc, char* argv[])
+{
+  vector<Shortcut> shortcuts;
+  std::filesystem::path generated_dir;
+  if (argc > 1)
+  {
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(argv[1]))
+    {
+      if (entry.is_regular_file() && entry.path().extension() == ".lnk")
+        shortcuts.push_back({entry.path().string(), ""});
+    }
+  }
+  else
+  {
+    generated_dir = std::filesystem::temp_directory_path() / "winegui_benchmark_shortcuts";
+    shortcuts = generate_shortcuts(generated_dir);
+  }
+  std::printf("Shortcut files: %zu\n\n", shortcuts.size());
+
+  auto parse_target = [](const string& file_path)
+  {
+    std::shared_ptr<const ShellLink> link = ShellLinkReader::open(file_path);
+    return link ? link->target_path : string();
+  };
+  auto legacy = run("hex string search (old)", shortcuts, 3, legacy_target_path);
+  auto cold = run("shell link reader, cold (parse)", shortcuts, 3,
+                  [&](const string& file_path)
+                  {
+                    ShellLinkReader::invalidate(file_path);
+                    return parse_target(file_path);
+                  });
+  auto warm = run("shell link reader, warm (cached)", shortcuts, 20, parse_target);
+
+  bool is_correct = cold == warm;
+  if (!generated_dir.empty())
+  {
+    std::size_t legacy_correct = 0;
+    for (std::size_t i = 0; i < shortcuts.size(); i++)
+    {
+      is_correct = is_correct && cold.at(i) == shortcuts.at(i).expected_target;
+      if (legacy.at(i) == shortcuts.at(i).expected_target)
+        legacy_correct++;
+    }
+    std::filesystem::remove_all(generated_dir);
+    std::printf("\nTargets correct: %s (old: %zu/%zu, shortcuts without LinkInfo are not found)\n", is_correct ? "yes" : "NO", legacy_correct,
+                shortcuts.size());
+  }
+  else
+  {
+    std::printf("\nCold & warm results equal: %s\n", is_correct ? "yes" : "NO");
+  }
+  return is_correct ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+# Compile a GResource bundle (eg. the images) into the binary, using glib-compile-resources.
+# The generated C source registers the resources automatically when the program starts.
+macro(add_resources RESOURCE_NAME SOURCE_DIR OUTPUT)
+
+    set(PKG_CONFIG_EXECUTABLE pkg-config)
+    set(_resource_file "${CMAKE_CURRENT_SOURCE_DIR}/src/resources/${RESOURCE_NAME}")
+    set(_resource_source "${PROJECT_BINARY_DIR}/${RESOURCE_NAME}.c")
+
+    execute_process(COMMAND ${PKG_CONFIG_EXECUTABLE} gio-2.0 --variable glib_compile_resources OUTPUT_VARIABLE _glib_compile_resources OUTPUT_STRIP_TRAILING_WHITESPACE)
+    if(NOT _glib_compile_resources)
+        message(FATAL_ERROR "glib-compile-resources not found (part of the GLib development files)")
+    endif()
+
+    # The files in the bundle, the bundle is compiled again when one of these files changes
+    execute_process(
+        COMMAND ${_glib_compile_resources} --generate-dependencies --sourcedir=${SOURCE_DIR} ${_resource_file}
+        OUTPUT_VARIABLE _resource_dependencies
+        ERROR_VARIABLE _resource_invalid
+        OUTPUT_STRIP_TRAILING_WHITESPACE)
+    if(_resource_invalid)
+        message(SEND_ERROR "Resource validation error: ${_resource_invalid}")
+    endif(_resource_invalid)
+    string(REPLACE "\n" ";" _resource_dependencies "${_resource_dependencies}")
+    # Configure again when files are added or removed from the bundle
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${_resource_file})
+
+    add_custom_command(
+        OUTPUT "${_resource_source}"
+        COMMAND
+            "${_glib_compile_resources}"
+        ARGS
+            "--generate-source"
+            "--sourcedir=${SOURCE_DIR}"
+            "--target=${_resource_source}"
+            "${_resource_file}"
+        DEPENDS
+            "${_resource_file}"
+            ${_resource_dependencies}
+        VERBATIM
+    )
+
+    message(STATUS "Resource bundle ${RESOURCE_NAME} will be compiled into the binary")
+    set(${OUTPUT} "${_resource_source}")
+endmacro()
@@ -23,7 +23,7 @@
 #include <gtkmm.h>
 
 // Forward declaration
-class BottleItem;
+class BottleRecord;
 
 /**
  * \class AddAppWindow
@@ -38,7 +38,7 @@ public:
   explicit AddAppWindow(Gtk::Window& parent);
   virtual ~AddAppWindow();
 
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
   void reset_active_bottle();
 
 protected:
@@ -59,7 +59,7 @@ protected:
   Gtk::Button cancel_button;            /*!< cancel button */
 
 private:
-  BottleItem* active_bottle_; /*!< Current active bottle */
+  BottleRecord* active_bottle_; /*!< Current active bottle */
 
   // Signal handlers
   void on_select_file();
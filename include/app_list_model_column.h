@@ -36,10 +36,18 @@ public:
     add(name);
     add(description);
     add(command);
+    add(markup);
+    add(name_key);
+    add(description_key);
+    add(order);
   }
 
   Gtk::TreeModelColumn<Glib::RefPtr<Gdk::Pixbuf>> icon;
   Gtk::TreeModelColumn<Glib::ustring> name;
   Gtk::TreeModelColumn<Glib::ustring> description;
   Gtk::TreeModelColumn<std::string> command;
+  Gtk::TreeModelColumn<Glib::ustring> markup;        // Rendered name + description
+  Gtk::TreeModelColumn<std::string> name_key;        // Normalized name for searching
+  Gtk::TreeModelColumn<std::string> description_key; // Normalized description for searching
+  Gtk::TreeModelColumn<int> order;                   // Insertion order, used for the search ranks & as tie-breaker when sorting
 };
@@ -27,4 +27,6 @@ struct ApplicationData
   std::string name;
   std::string description;
   std::string command;
+
+  bool operator==(const ApplicationData&) const = default;
 };
\ No newline at end of file
@@ -0,0 +1,42 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    app_search.h
+ * \brief   Normalized search keys & ranking of the application list search
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glibmm/ustring.h>
+#include <string>
+
+using std::string;
+
+/**
+ * \class AppSearch
+ * \brief Search keys are normalized once (when the application is added), a search only compares the normalized keys.
+ */
+class AppSearch
+{
+public:
+  static constexpr int NoMatch = -1; /*!< Rank of an application that doesn't match the search */
+
+  static string normalize(const Glib::ustring& text);
+  static int rank(const string& name_key, const string& description_key, const string& query);
+
+private:
+  static int fuzzy_rank(const string& name_key, const string& query);
+};
@@ -27,7 +27,7 @@
 using std::string;
 
 // Forward declaration
-class BottleItem;
+class BottleRecord;
 
 struct CloneBottleStruct
 {
@@ -50,7 +50,7 @@ public:
   virtual ~BottleCloneWindow();
 
   void show();
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
   void reset_active_bottle();
 
   // Signal handlers
@@ -81,5 +81,5 @@ private:
 
   // Member functions
 
-  BottleItem* active_bottle_; /*!< Current active bottle */
+  BottleRecord* active_bottle_; /*!< Current active bottle */
 };
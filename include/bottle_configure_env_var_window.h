@@ -23,7 +23,7 @@
 #include <gtkmm.h>
 
 // Forward declaration
-class BottleItem;
+class BottleRecord;
 
 // Tree model columns
 class ModelColumns : public Gtk::TreeModel::ColumnRecord
@@ -52,7 +52,7 @@ public:
   explicit BottleConfigureEnvVarWindow(Gtk::Window& parent);
   virtual ~BottleConfigureEnvVarWindow();
 
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
   void reset_active_bottle();
 
 protected:
@@ -74,7 +74,7 @@ protected:
   Glib::RefPtr<Gtk::ListStore> m_refTreeModel;
 
 private:
-  BottleItem* active_bottle_; /*!< Current active bottle */
+  BottleRecord* active_bottle_; /*!< Current active bottle */
 
   // Signal handlers
   void on_add_button_clicked();
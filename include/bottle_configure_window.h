@@ -25,7 +25,8 @@
 using std::string;
 
 // Forward declaration
-class BottleItem;
+class BottleRecord;
+class RegistryQuery;
 
 /**
  * \class BottleConfigureWindow
@@ -47,7 +48,7 @@ public:
   virtual ~BottleConfigureWindow();
 
   void show();
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
   void reset_active_bottle();
   void update_installed();
 
@@ -87,18 +88,18 @@ protected:
   Gtk::ToolButton install_dotnet6_button;     /*!< .NET v6.0 install button */
 
 private:
-  BottleItem* active_bottle_; /*!< Current active bottle */
+  BottleRecord* active_bottle_; /*!< Current active bottle */
 
-  bool is_d3dx9_installed();
-  bool is_dxvk_installed();
-  bool is_vkd3d_installed();
-  bool is_liberation_installed();
-  bool is_core_fonts_installed();
-  bool is_visual_cpp_2013_installed();
-  bool is_visual_cpp_2015_installed();
-  bool is_visual_cpp_2017_installed();
-  bool is_visual_cpp_2019_installed();
-  bool is_visual_cpp_2022_installed();
-  bool is_dotnet_installed(const string& uninstaller_key, const string& uninstaller_name);
-  bool is_dotnet_6_installed();
+  bool is_d3dx9_installed(const RegistryQuery& registry);
+  bool is_dxvk_installed(const RegistryQuery& registry);
+  bool is_vkd3d_installed(const RegistryQuery& registry);
+  bool is_liberation_installed(const RegistryQuery& registry);
+  bool is_core_fonts_installed(const RegistryQuery& registry);
+  bool is_visual_cpp_2013_installed(const RegistryQuery& registry);
+  bool is_visual_cpp_2015_installed(const RegistryQuery& registry);
+  bool is_visual_cpp_2017_installed(const RegistryQuery& registry);
+  bool is_visual_cpp_2019_installed(const RegistryQuery& registry);
+  bool is_visual_cpp_2022_installed(const RegistryQuery& registry);
+  bool is_dotnet_installed(const RegistryQuery& registry, const string& uninstaller_key, const string& uninstaller_name);
+  bool is_dotnet_6_installed(const RegistryQuery& registry);
 };
@@ -27,7 +27,7 @@
 using std::string;
 
 // Forward declaration
-class BottleItem;
+class BottleRecord;
 
 struct UpdateBottleStruct
 {
@@ -57,7 +57,7 @@ public:
   virtual ~BottleEditWindow();
 
   void show();
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
   void reset_active_bottle();
   void bottle_removed();
 
@@ -107,5 +107,5 @@ private:
   void virtual_desktop_resolution_sensitive(bool sensitive);
   void log_level_sensitive(bool sensitive);
 
-  BottleItem* active_bottle_; /*!< Current active bottle */
+  BottleRecord* active_bottle_; /*!< Current active bottle */
 };
@@ -20,22 +20,35 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <gtkmm.h>
-#include <list>
 #include <map>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "bottle_config_file.h"
+#include "bottle_record.h"
+#include "bottle_snapshot.h"
+#include "bottle_watcher.h"
 #include "bottle_types.h"
+#include "console_buffer.h"
 #include "general_config_struct.h"
+#include "log_compressor.h"
+#include "log_writer.h"
+#include "process_supervisor.h"
 
 using std::string;
 
 // Forward declaration
 class MainWindow;
 class SignalController;
-class BottleItem;
 
 /**
  * \class BottleManager
@@ -48,6 +61,7 @@ public:
   sigc::signal<void> reset_active_bottle;               /*!< Send signal: Clear the current active bottle */
   sigc::signal<void> bottle_removed;                    /*!< Send signal: When the bottle is confirmed to be removed */
   Glib::Dispatcher finished_package_install_dispatcher; /*!< Signal that Wine package install is completed */
+  Glib::Dispatcher console_output_dispatcher;           /*!< Signal that output lines are added to the console buffer */
 
   explicit BottleManager(MainWindow& main_window);
   virtual ~BottleManager();
@@ -61,7 +75,9 @@ public:
                   const Glib::ustring& virtual_desktop_resolution,
                   bool disable_gecko_mono,
                   BottleTypes::AudioDriver audio);
+  std::optional<BottleRecord> begin_update_bottle();
   void update_bottle(SignalController* caller,
+                     const std::optional<BottleRecord>& bottle,
                      const Glib::ustring& name,
                      const Glib::ustring& folder_name,
                      const Glib::ustring& description,
@@ -70,10 +86,14 @@ public:
                      BottleTypes::AudioDriver audio,
                      bool is_debug_logging,
                      int debug_log_level);
+  void end_update_bottle();
   void clone_bottle(SignalController* caller, const Glib::ustring& name, const Glib::ustring& folder_name, const Glib::ustring& description);
   void delete_bottle();
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
+  void load_bottle_details(std::size_t selected_index);
   const Glib::ustring& get_error_message() const;
+  ConsoleBuffer& get_console_buffer();
+  std::vector<JobInfo> get_running_jobs() const;
 
   // Signal handlers
   void run_executable(string program, bool is_msi_file);
@@ -82,6 +102,7 @@ public:
   void reboot();
   void update();
   void open_log_file();
+  void open_previous_log_file();
   void kill_processes();
   void install_d3dx9(Gtk::Window& parent, const string& version);
   void install_dxvk(Gtk::Window& parent, const string& version);
@@ -92,42 +113,127 @@ public:
   void install_liberation(Gtk::Window& parent);
 
 private:
+  /**
+   * \brief Result of inspecting a single bottle (filled by a worker thread)
+   */
+  struct BottleInspection
+  {
+    BottleSnapshot::Signature signature;
+    bool is_snapshot = false; /*!< Details are taken from the snapshot */
+    BottleConfigData config;
+    std::map<int, ApplicationData> app_list;
+    string folder_name;
+    BottleSnapshotData details;
+    std::vector<string> errors;        /*!< Error messages, shown after all bottles are inspected */
+    bool is_details_loaded = false;    /*!< Details are loaded (not only the summary) */
+    bool is_details_valid = false;     /*!< Details are loaded without errors, can be stored in the snapshot */
+    bool is_details_requested = false; /*!< Details are requested, but not yet loaded */
+    bool is_details_wanted = false;    /*!< Details are read during the inspection (the details were loaded before) */
+    bool is_applied = false;           /*!< Inspection is applied to the bottle row (only used by the GUI thread) */
+  };
+
+  /**
+   * \brief Request to load the bottle details (in the details thread)
+   */
+  struct BottleDetailsRequest
+  {
+    std::uint64_t generation; /*!< Generation of the bottle list, see bottles_generation_ */
+    std::size_t index;        /*!< Row index in the bottle list */
+    string prefix;
+    BottleSnapshotData details; /*!< Bottle summary, completed with the details */
+  };
+
+  /**
+   * \brief Loaded bottle details
+   */
+  struct BottleDetailsResult
+  {
+    std::uint64_t generation;
+    std::size_t index;
+    BottleSnapshotData details;
+    std::vector<string> errors;
+  };
+
   // Synchronizes access to data members using mutexes
   mutable std::mutex error_message_mutex_;
-  mutable std::mutex output_loging_mutex_;
   mutable std::mutex error_message_winetricks_mutex_;
   std::unique_ptr<std::thread> thread_install_update_winetricks_; /*!< Thread for installing/updating winetricks binary */
   Glib::Dispatcher update_bottles_dispatcher_;                    /*!< Dispatcher if the bottle list needs to be updated, from thread */
-  Glib::Dispatcher write_log_dispatcher_;                         /*!< Dispatcher if we can write the output logging to disk */
   Glib::Dispatcher error_message_winetricks_dispatcher_; /*!< Dispatcher when there is an error message during winetricks install/update thread */
   Glib::Dispatcher winetricks_finished_dispatcher_;      /*!< Dispatcher when the Winetricks install is completed */
+  std::unique_ptr<std::thread> thread_load_bottles_;     /*!< Thread for inspecting the bottles */
+  std::atomic<bool> is_load_bottles_cancelled_;          /*!< Stop inspecting the bottles (eg. the bottle list is reloaded) */
+  mutable std::mutex loaded_bottles_mutex_;              /*!< Synchronizes access to the loaded bottles and errors */
+  std::vector<std::size_t> loaded_bottles_;              /*!< Indices of the inspected bottles, not yet shown in the GUI */
+  bool is_all_bottles_loaded_;                           /*!< All bottles are inspected, the load thread is finished */
+  Glib::ustring load_bottles_errors_;                    /*!< Error messages of the load thread (besides the per bottle errors) */
+  Glib::ustring loaded_wine_version_;                    /*!< Wine version, read by the load thread */
+  Glib::Dispatcher bottles_loaded_dispatcher_;           /*!< Dispatcher when one or more bottles are inspected */
+  std::unique_ptr<std::thread> thread_load_details_;     /*!< Thread for loading the bottle details on demand */
+  mutable std::mutex load_details_mutex_;                /*!< Synchronizes access to the details requests & results */
+  std::deque<BottleDetailsRequest> details_requests_;    /*!< Pending details requests, the selected bottle first */
+  std::vector<BottleDetailsResult> details_results_;     /*!< Loaded details, not yet shown in the GUI */
+  bool is_load_details_running_;                         /*!< Details thread is running (processing the requests) */
+  Glib::Dispatcher details_loaded_dispatcher_;           /*!< Dispatcher when the details of one or more bottles are loaded */
+  std::mutex decompressed_log_mutex_;                    /*!< Synchronizes access to decompressed_log_path_ */
+  string decompressed_log_path_;                         /*!< Decompressed previous log file, empty on failure */
+  Glib::Dispatcher log_decompressed_dispatcher_;         /*!< Dispatcher when the previous log file is decompressed */
 
   MainWindow& main_window_;
   string bottle_location_;
-  std::list<BottleItem> bottles_;
-  BottleItem* active_bottle_;
+  std::vector<BottleRecord> bottles_; /*!< Bottles in the same order as bottle_dirs_ (the order of the listbox) */
+  BottleRecord* active_bottle_;       /*!< Points into bottles_ */
   bool is_display_default_wine_machine_;
   bool is_wine64_bit_;
   bool is_logging_stderr_;
-  int previous_active_bottle_index_;
-  std::size_t previous_bottles_list_size_;
+  BottleSnapshot bottle_snapshot_;                   /*!< Bottle details of all bottles, persisted between runs */
+  std::vector<string> bottle_dirs_;                  /*!< Bottle directories of the current (or last) load */
+  std::vector<BottleInspection> bottle_inspections_; /*!< Inspected bottles, each entry is only written by one worker thread */
+  Glib::ustring select_bottle_name_;                 /*!< Select the bottle with this name once it is loaded */
+  std::uint64_t bottles_generation_;                 /*!< Incremented on every bottle list (re)load */
+  bool is_background_load_;                          /*!< Load is not requested by the user (errors are only logged) */
+  std::vector<std::size_t> load_bottle_indices_;     /*!< Row indices of the bottles that are inspected by the load thread */
+  std::set<string> pending_update_prefixes_;         /*!< Changed bottles during the load, inspected after the load */
+  BottleWatcher bottle_watcher_;                     /*!< Watches the bottles for changes outside WineGUI */
+  string updating_bottle_prefix_;                    /*!< Bottle that is updated by the update thread, its file changes are ignored */
+  ConsoleBuffer console_buffer_;                     /*!< Last output lines of the running programs & installs */
+  LogCompressor log_compressor_;                     /*!< Rotates the log files & compresses the rotated log files */
+  LogWriter log_writer_;                             /*!< Writes the log files of the bottles (debug logging) */
 
   //// error_message is used by both the GUI thread and NewBottle thread (used a 'temp' location)
   Glib::ustring error_message_;
   Glib::ustring error_message_winetricks_;
-  std::string logging_bottle_prefix_;
-  std::string output_logging_;
+  ProcessSupervisor process_supervisor_; /*!< Runs the programs & installs, destructed first (its callbacks use the members above) */
 
   // Signal handlers
-  virtual void write_log_to_file();
   virtual void on_error_winetricks();
   virtual void cleanup_install_update_winetricks_thread();
+  virtual void on_bottles_loaded();
+  virtual void on_bottle_details_loaded();
+  virtual void on_bottle_list_changed();
+  virtual void update_bottles(const std::set<string>& prefixes);
+  virtual void on_log_decompressed();
 
   void install_or_update_winetricks_thread(bool install);
+  void launch_log_file(const string& log_file_path);
+  JobCommand get_job_command(const std::vector<string>& argv,
+                             bool is_wine_program,
+                             const string& working_directory = "",
+                             const std::vector<std::pair<string, string>>& env_vars = {});
+  void start_job(const string& name, std::vector<JobCommand> commands, std::function<void()> on_finished = nullptr);
+  static JobCommand get_wait_wineserver_command(const string& wine_prefix);
+  void start_install_job(const string& package, const std::vector<std::vector<string>>& commands);
   GeneralConfigData load_and_save_general_config();
   bool is_bottle_not_null();
-  string get_deinstall_mono_command();
-  string get_wine_version();
+  std::vector<string> get_deinstall_mono_command();
   std::vector<string> get_bottle_paths();
-  std::list<BottleItem> create_wine_bottles(const std::vector<string>& bottle_dirs);
+  void load_config_and_bottles(const Glib::ustring& select_bottle_name, bool is_startup, bool is_background);
+  void load_bottles_thread(const std::vector<std::size_t>& indices, bool is_full_load, bool is_background);
+  void cancel_load_bottles_thread();
+  void cleanup_load_bottles_thread();
+  bool apply_bottle_inspection(BottleRecord& bottle, const BottleInspection& inspection);
+  static void inspect_bottle(const string& prefix, BottleInspection& inspection);
+  static BottleSnapshotData read_bottle_summary(const string& prefix, std::vector<string>& errors);
+  static void read_bottle_details(const string& prefix, BottleSnapshotData& details, std::vector<string>& errors);
+  string get_snapshot_file_path();
 };
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    bottle_record.h
+ * \brief   Wine bottle data record (without widgets)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "app_list_struct.h"
+#include "bottle_types.h"
+#include <glibmm/ustring.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \class BottleRecord
+ * \brief Data of a single Wine bottle. Plain (copyable & movable) class, the bottles are stored contiguously by the bottle manager.
+ * The listbox row of a bottle is a separate widget, see BottleItem.
+ */
+class BottleRecord
+{
+public:
+  BottleRecord();
+  BottleRecord(const Glib::ustring& folder_name, const Glib::ustring& wine_location);
+
+  /*
+   *  Getters & setters
+   */
+  /// set bottle name
+  void name(const Glib::ustring& name)
+  {
+    name_ = name;
+  };
+  /// get bottle name
+  const Glib::ustring& name() const
+  {
+    return name_;
+  };
+  /// set folder name
+  void folder_name(const Glib::ustring& folder_name)
+  {
+    folder_name_ = folder_name;
+  };
+  /// get folder name
+  const Glib::ustring& folder_name() const
+  {
+    return folder_name_;
+  };
+  /// set description
+  void description(const Glib::ustring& description)
+  {
+    description_ = description;
+  };
+  /// get description
+  const Glib::ustring& description() const
+  {
+    return description_;
+  };
+  /// set status
+  void status(const bool status)
+  {
+    is_status_ok_ = status;
+  };
+  /// get status
+  bool status() const
+  {
+    return is_status_ok_;
+  };
+  /// set windows
+  void windows(const BottleTypes::Windows win)
+  {
+    win_ = win;
+  };
+  /// get windows
+  BottleTypes::Windows windows() const
+  {
+    return win_;
+  };
+  /// set bit
+  void bit(const BottleTypes::Bit bit)
+  {
+    bit_ = bit;
+  };
+  /// get bit
+  BottleTypes::Bit bit() const
+  {
+    return bit_;
+  };
+  /// set Wine version
+  void wine_version(const Glib::ustring& wine_version)
+  {
+    wine_version_ = wine_version;
+  };
+  /// get Wine version
+  const Glib::ustring& wine_version() const
+  {
+    return wine_version_;
+  };
+  /// set is Wine 64-bit executable
+  void is_wine64_bit(bool is_wine64_bit)
+  {
+    is_wine64_bit_ = is_wine64_bit;
+  };
+  /// get is Wine 64-bit executable
+  bool is_wine64_bit() const
+  {
+    return is_wine64_bit_;
+  };
+  /// set Wine location
+  void wine_location(const Glib::ustring& wine_location)
+  {
+    wine_location_ = wine_location;
+  };
+  /// get Wine location
+  const Glib::ustring& wine_location() const
+  {
+    return wine_location_;
+  };
+  /// set Wine c:\ drive location
+  void wine_c_drive(const Glib::ustring& wine_c_drive)
+  {
+    wine_c_drive_ = wine_c_drive;
+  };
+  /// get Wine c:\ drive location
+  const Glib::ustring& wine_c_drive() const
+  {
+    return wine_c_drive_;
+  };
+  // TODO: Changed to datetime iso Glib::ustring
+  /// set Wine last changed date
+  void wine_last_changed(const Glib::ustring& wine_last_changed)
+  {
+    wine_last_changed_ = wine_last_changed;
+  };
+  /// get Wine last changed date
+  const Glib::ustring& wine_last_changed() const
+  {
+    return wine_last_changed_;
+  };
+  /// set Wine audio driver
+  void audio_driver(const BottleTypes::AudioDriver audio_driver)
+  {
+    audio_driver_ = audio_driver;
+  };
+  /// get Wine audio driver
+  BottleTypes::AudioDriver audio_driver() const
+  {
+    return audio_driver_;
+  };
+  /// set Wine emulate virtual desktop (set to empty string to disable)
+  void virtual_desktop(const Glib::ustring& virtual_desktop)
+  {
+    virtual_desktop_ = virtual_desktop;
+  };
+  /// get Wine emulate virtual desktop (empty string is disabled)
+  const Glib::ustring& virtual_desktop() const
+  {
+    return virtual_desktop_;
+  };
+  /// set enable/disable debug logging to disk
+  void is_debug_logging(bool is_debug_logging)
+  {
+    is_debug_logging_ = is_debug_logging;
+  };
+  /// get enable/disable debug logging to disk
+  bool is_debug_logging() const
+  {
+    return is_debug_logging_;
+  };
+  /// set Wine debug log level
+  void debug_log_level(int debug_log_level)
+  {
+    debug_log_level_ = debug_log_level;
+  };
+  /// get Wine debug log level
+  int debug_log_level() const
+  {
+    return debug_log_level_;
+  };
+  /// set environment variables
+  void env_vars(const std::vector<std::pair<std::string, std::string>>& env_vars)
+  {
+    env_vars_ = env_vars;
+  };
+  /// get environment variables
+  const std::vector<std::pair<std::string, std::string>>& env_vars() const
+  {
+    return env_vars_;
+  };
+  /// set app list
+  void app_list(const std::map<int, ApplicationData>& app_list)
+  {
+    app_list_ = app_list;
+  };
+  /// get app list
+  const std::map<int, ApplicationData>& app_list() const
+  {
+    return app_list_;
+  };
+  /// set is loading (placeholder until the bottle details are read)
+  void is_loading(bool is_loading)
+  {
+    is_loading_ = is_loading;
+  };
+  /// get is loading
+  bool is_loading() const
+  {
+    return is_loading_;
+  };
+  /// set is details loaded (C: drive, last changed, audio driver & virtual desktop)
+  void is_details_loaded(bool is_details_loaded)
+  {
+    is_details_loaded_ = is_details_loaded;
+  };
+  /// get is details loaded
+  bool is_details_loaded() const
+  {
+    return is_details_loaded_;
+  };
+
+private:
+  Glib::ustring name_;
+  Glib::ustring folder_name_;
+  Glib::ustring description_;
+  bool is_status_ok_;
+  BottleTypes::Windows win_;
+  BottleTypes::Bit bit_;
+  Glib::ustring wine_version_;
+  bool is_wine64_bit_;
+  Glib::ustring wine_location_;
+  Glib::ustring wine_c_drive_;
+  Glib::ustring wine_last_changed_;
+  BottleTypes::AudioDriver audio_driver_;
+  Glib::ustring virtual_desktop_;
+  bool is_debug_logging_;
+  int debug_log_level_;
+  std::vector<std::pair<std::string, std::string>> env_vars_;
+  std::map<int, ApplicationData> app_list_;
+  bool is_loading_ = false;
+  bool is_details_loaded_ = true;
+};
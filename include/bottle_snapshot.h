@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    bottle_snapshot.h
+ * \brief   Persistent snapshot of the bottle details (read from the registry and other files)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "bottle_types.h"
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::string;
+
+/**
+ * \brief Bottle details, which are derived from the files inside the bottle prefix
+ */
+struct BottleSnapshotData
+{
+  BottleTypes::Windows windows;
+  BottleTypes::Bit bit;
+  BottleTypes::AudioDriver audio_driver;
+  string virtual_desktop;
+  bool status;
+  string last_time_wine_updated;
+  string c_drive_location;
+};
+
+/**
+ * \class BottleSnapshot
+ * \brief Snapshot of the bottle details of all the bottles, stored in a compact binary file.
+ *
+ * Each entry is keyed by the signature (modification time and size) of the source files in the bottle prefix.
+ * When a source file changes, the entry is no longer valid and the bottle details needs to be read again.
+ */
+class BottleSnapshot
+{
+public:
+  /**
+   * \brief Modification time and size of a single source file (both are -1 if the file doesn't exist)
+   */
+  struct FileStamp
+  {
+    std::int64_t modified_ns;
+    std::int64_t size;
+    bool operator==(const FileStamp&) const = default;
+  };
+  using Signature = std::array<FileStamp, 5>;
+
+  static Signature get_signature(const string& prefix_path);
+
+  bool load(const string& file_path);
+  void save(const string& file_path);
+  const BottleSnapshotData* find(const string& prefix_path, const Signature& signature) const;
+  void insert(const string& prefix_path, const Signature& signature, const BottleSnapshotData& data);
+  void erase(const string& prefix_path);
+  void retain(const std::vector<string>& prefix_paths);
+
+private:
+  /**
+   * \brief Snapshot entry of a single bottle
+   */
+  struct Entry
+  {
+    Signature signature;
+    BottleSnapshotData data;
+  };
+
+  std::map<string, Entry> entries_; /*!< Prefix path -> entry */
+  bool is_changed_ = false;         /*!< Entries are changed since load() */
+};
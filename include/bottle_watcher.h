@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    bottle_watcher.h
+ * \brief   File system watcher of the bottles & Wine desktop files (debounced)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <giomm/file.h>
+#include <giomm/filemonitor.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::string;
+
+/**
+ * \class BottleWatcher
+ * \brief Watches the bottle location, the files of each bottle prefix (registry files & WineGUI config)
+ * and the Wine desktop files (inotify via Gio::FileMonitor).
+ *
+ * Changes are collected and signalled once after a short quiet period, so a burst of file events (eg. Wine writing the registry)
+ * results in a single refresh of only the affected bottles.
+ */
+class BottleWatcher
+{
+public:
+  // Signals
+  sigc::signal<void> bottle_list_changed;                      /*!< A bottle is added or removed from the bottle location */
+  sigc::signal<void, const std::set<string>&> bottles_changed; /*!< Files of one or more bottles are changed (prefix paths) */
+  sigc::signal<void> desktop_files_changed;                    /*!< Wine menu/desktop files are changed */
+
+  BottleWatcher();
+  virtual ~BottleWatcher();
+
+  void watch(const string& bottle_location, const std::vector<string>& prefix_paths);
+  void mute(const string& prefix_path);
+  void unmute(const string& prefix_path);
+
+private:
+  Glib::RefPtr<Gio::FileMonitor> bottle_location_monitor_;                /*!< Monitor of the bottle location directory */
+  string bottle_location_;                                                /*!< Watched bottle location */
+  std::map<string, Glib::RefPtr<Gio::FileMonitor>> prefix_monitors_;      /*!< Prefix path -> monitor of the prefix directory */
+  string desktop_dir_;                                                    /*!< Top directory of the Wine desktop files */
+  std::map<string, Glib::RefPtr<Gio::FileMonitor>> desktop_dir_monitors_; /*!< Directory -> monitor of the Wine desktop directories */
+  sigc::connection debounce_timeout_;                                     /*!< Pending debounce timeout */
+  gint64 first_pending_event_time_;                                       /*!< Time of the first event since the last signal */
+  std::set<string> muted_prefixes_;                                       /*!< File changes of these prefixes are ignored */
+  // Pending changes, signalled once the debounce timeout expires
+  bool is_bottle_list_changed_;
+  std::set<string> changed_prefixes_;
+  bool is_desktop_files_changed_;
+
+  void on_bottle_location_changed(const Glib::RefPtr<Gio::File>& file,
+                                  const Glib::RefPtr<Gio::File>& other_file,
+                                  Gio::FileMonitorEvent event_type);
+  void on_prefix_changed(const Glib::RefPtr<Gio::File>& file,
+                         const Glib::RefPtr<Gio::File>& other_file,
+                         Gio::FileMonitorEvent event_type,
+                         const string& prefix_path);
+  void on_desktop_dir_changed(const Glib::RefPtr<Gio::File>& file,
+                              const Glib::RefPtr<Gio::File>& other_file,
+                              Gio::FileMonitorEvent event_type);
+  bool on_debounce_timeout();
+  void schedule_signal();
+  void watch_desktop_dir(const string& dir_path);
+  static Glib::RefPtr<Gio::FileMonitor> monitor_directory(const string& dir_path);
+};
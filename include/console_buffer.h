@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    console_buffer.h
+ * \brief   Bounded in-memory buffer of the program output lines (shown in the console window)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+/**
+ * \class LineFramer
+ * \brief Splits the output chunks of a single process into lines (chunks are not aligned to lines)
+ */
+class LineFramer
+{
+public:
+  using LineCallback = std::function<void(std::string_view)>; /*!< Receives a line, without the line ending */
+
+  explicit LineFramer(std::size_t max_line_length = 4096);
+
+  void feed(std::string_view chunk, const LineCallback& on_line);
+  void finish(const LineCallback& on_line);
+
+private:
+  std::size_t max_line_length_; /*!< Longer lines are split, so a single line can't use unbounded memory */
+  string partial_line_;         /*!< Start of the line, the remaining part is not yet received */
+
+  void emit_line(std::string_view line, const LineCallback& on_line);
+};
+
+/**
+ * \class ConsoleBuffer
+ * \brief Ring buffer of the last output lines of all the running programs, the oldest lines are dropped.
+ * Lines are appended by the process threads and read by the GUI thread, every line has an increasing sequence number.
+ */
+class ConsoleBuffer
+{
+public:
+  ConsoleBuffer(std::size_t max_lines, std::size_t max_bytes);
+
+  bool append(std::string_view source, std::string_view text);
+  std::uint64_t read(std::uint64_t sequence, vector<string>& lines);
+  void clear();
+  std::size_t max_lines() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::deque<string> lines_;     /*!< Lines in order, prefixed by the source (program) */
+  std::uint64_t first_sequence_; /*!< Sequence number of the first line in lines_ */
+  std::size_t bytes_;            /*!< Total size of the lines */
+  std::size_t max_lines_;
+  std::size_t max_bytes_;
+  bool is_read_pending_; /*!< Lines are appended after the last read, the reader is already notified */
+};
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    console_window.h
+ * \brief   Live output of the running programs and installs
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <gtkmm.h>
+
+// Forward declaration
+class ConsoleBuffer;
+
+/**
+ * \class ConsoleWindow
+ * \brief Console GTK Window class, shows the output lines of the console buffer while the programs are running
+ */
+class ConsoleWindow : public Gtk::Window
+{
+public:
+  ConsoleWindow(Gtk::Window& parent, ConsoleBuffer& console_buffer);
+  virtual ~ConsoleWindow();
+
+  void show();
+  void update();
+
+protected:
+  // Child widgets
+  Gtk::Box vbox;                       /*!< main vertical box */
+  Gtk::Box hbox_buttons;               /*!< box for buttons */
+  Gtk::ScrolledWindow scrolled_window; /*!< scrolled window around the text view */
+  Gtk::TextView text_view;             /*!< output text view */
+  Gtk::Button clear_button;            /*!< clear button */
+  Gtk::Button close_button;            /*!< close button */
+
+private:
+  ConsoleBuffer& console_buffer_;
+  std::uint64_t next_sequence_;          /*!< Sequence number of the next line to read from the console buffer */
+  Glib::RefPtr<Gtk::TextMark> end_mark_; /*!< End of the text, used to follow the output */
+
+  // Signal handlers
+  void on_clear_button_clicked();
+};
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    desktop_entry_index.h
+ * \brief   Index of the Linux desktop files which are created by Wine (menu & desktop shortcuts)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+using std::string;
+
+/**
+ * \class DesktopEntryIndex
+ * \brief Shared index of desktop files (*.desktop), keyed by the file path.
+ *
+ * All the desktop files of a directory are parsed at once, the first time one of its files is looked up.
+ * A directory is indexed again when its modification time changed (desktop files are added, removed or renamed).
+ * Can be used from any thread.
+ */
+class DesktopEntryIndex
+{
+public:
+  /**
+   * \brief Desktop entry, the keys which are used by WineGUI
+   */
+  struct Entry
+  {
+    string icon;    /*!< Icon name (without extension) */
+    string comment; /*!< Comment (localized when available) */
+    string exec;    /*!< Command-line */
+  };
+
+  // Singleton
+  static DesktopEntryIndex& get_instance();
+
+  std::optional<Entry> get_entry(const string& file_path);
+  void clear();
+
+private:
+  /**
+   * \brief Desktop entries of a single directory
+   */
+  struct Directory
+  {
+    std::int64_t modified_ns;        /*!< Modification time of the directory when it was indexed */
+    std::map<string, Entry> entries; /*!< File name -> entry */
+  };
+
+  DesktopEntryIndex();
+  ~DesktopEntryIndex();
+  DesktopEntryIndex(const DesktopEntryIndex&) = delete;
+  DesktopEntryIndex& operator=(const DesktopEntryIndex&) = delete;
+
+  static Directory read_directory(const string& dir_path, std::int64_t modified_ns);
+
+  std::mutex mutex_;
+  std::map<string, Directory> directories_; /*!< Directory path -> indexed desktop entries */
+};
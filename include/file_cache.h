@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    file_cache.h
+ * \brief   Cache of objects loaded from files, validated by the file status
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <utility>
+
+using std::string;
+
+/**
+ * \class FileCache
+ * \brief Shared objects loaded from files (eg. registry hives, shortcuts), keyed by file path.
+ *
+ * An entry is only returned when the device, inode, size and modification time still match the file on disk.
+ * The least recently used entry is dropped once the maximum number of entries is reached. Can be used from any thread.
+ */
+template <typename T> class FileCache
+{
+public:
+  /**
+   * \brief Constructor
+   * \param[in] max_entries Maximum number of entries kept in the cache
+   */
+  explicit FileCache(std::size_t max_entries) : max_entries_(max_entries), clock_(0)
+  {
+  }
+
+  /**
+   * \brief Get the cached object of a file
+   * \param[in] file_path File path
+   * \param[in] file_stat Current file status
+   * \return Shared object or nullptr when the file isn't cached or changed on disk
+   */
+  std::shared_ptr<const T> get(const string& file_path, const struct stat& file_stat)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(file_path);
+    if (it == entries_.end() || !is_same_file(it->second, file_stat))
+      return nullptr;
+    it->second.last_used = ++clock_;
+    return it->second.value;
+  }
+
+  /**
+   * \brief Add (or replace) the object of a file, the least recently used entry is dropped when the cache is full
+   * \param[in] file_path File path
+   * \param[in] file_stat File status at the time the object got loaded
+   * \param[in] value Loaded object
+   */
+  void insert(const string& file_path, const struct stat& file_stat, std::shared_ptr<const T> value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= max_entries_ && !entries_.contains(file_path))
+    {
+      auto oldest = std::min_element(entries_.begin(), entries_.end(),
+                                     [](const auto& a, const auto& b) { return a.second.last_used < b.second.last_used; });
+      entries_.erase(oldest);
+    }
+    entries_[file_path] = {file_stat.st_dev, file_stat.st_ino, file_stat.st_size, file_stat.st_mtim, ++clock_, std::move(value)};
+  }
+
+  /**
+   * \brief Drop a file from the cache
+   * \param[in] file_path File path
+   */
+  void erase(const string& file_path)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(file_path);
+  }
+
+private:
+  /**
+   * \brief Cache entry, the file signature is used to detect changes on disk
+   */
+  struct Entry
+  {
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    struct timespec modified;
+    std::uint64_t last_used;
+    std::shared_ptr<const T> value;
+  };
+
+  /**
+   * \brief Check if the cache entry still matches the file on disk
+   * \param[in] entry Cache entry
+   * \param[in] file_stat Current file status
+   * \return True if the file didn't change since it got loaded
+   */
+  static bool is_same_file(const Entry& entry, const struct stat& file_stat)
+  {
+    return entry.device == file_stat.st_dev && entry.inode == file_stat.st_ino && entry.size == file_stat.st_size &&
+           entry.modified.tv_sec == file_stat.st_mtim.tv_sec && entry.modified.tv_nsec == file_stat.st_mtim.tv_nsec;
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<string, Entry> entries_; /*!< File path -> entry */
+  std::size_t max_entries_;
+  std::uint64_t clock_; /*!< Incremented on every use, the entry with the lowest value is the least recently used */
+};
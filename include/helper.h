@@ -20,13 +20,20 @@
  */
 #pragma once
 
+#include <gdkmm/pixbuf.h>
 #include <glibmm/dispatcher.h>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "bottle_types.h"
 #include "dll_override_types.h"
+#include "process.h"
+
+// Forward declaration
+class RegistryQuery;
+class RegistryWriter;
 
 using std::endl;
 using std::pair;
@@ -49,7 +56,7 @@ public:
   static vector<string> get_bottles_paths(const string& dir_path, bool display_default_wine_machine);
   static string run_program(const string& prefix_path,
                             int debug_log_level,
-                            const string& program,
+                            const vector<string>& argv,
                             const string& working_directory = "",
                             const vector<pair<string, string>>& env_vars = {},
                             bool give_error = true,
@@ -57,16 +64,22 @@ public:
   static string run_program_under_wine(bool wine_64_bit,
                                        const string& prefix_path,
                                        int debug_log_level,
-                                       const string& program,
+                                       const vector<string>& argv,
                                        const string& working_directory = "",
                                        const vector<pair<string, string>>& env_vars = {},
                                        bool give_error = true,
                                        bool stderr_output = true);
-  static void write_to_log_file(const string& logging_bottle_prefix, const string& logging);
+  static ProcessOptions program_options(const string& prefix_path,
+                                        int debug_log_level,
+                                        const string& working_directory,
+                                        const vector<pair<string, string>>& env_vars,
+                                        bool stderr_output);
   static string get_log_file_path(const string& logging_bottle_prefix);
   static void wait_until_wineserver_is_terminated(const string& prefix_path);
   static int determine_wine_executable();
   static string get_wine_executable_location(bool bit64);
+  static string find_wine_executable(bool bit64);
+  static string get_winegui_data_dir();
   static string get_winetricks_location();
   static string get_wine_version(bool wine_64_bit);
   static string open_file_from_uri(const string& uri);
@@ -75,12 +88,19 @@ public:
   static void rename_wine_bottle_folder(const string& current_prefix_path, const string& new_prefix_path);
   static void copy_wine_bottle_folder(const string& source_prefix_path, const string& destination_prefix_path);
   static string get_folder_name(const string& prefix_path);
+  static void add_bottle_summary_query(RegistryQuery& registry, const string& prefix_path);
+  static void add_bottle_details_query(RegistryQuery& registry, const string& prefix_path);
   static BottleTypes::Windows get_windows_version(const string& prefix_path);
+  static BottleTypes::Windows get_windows_version(const RegistryQuery& registry, const string& prefix_path);
   static BottleTypes::Bit get_windows_bitness(const string& prefix_path);
+  static BottleTypes::Bit get_windows_bitness(const RegistryQuery& registry, const string& prefix_path);
   static BottleTypes::AudioDriver get_audio_driver(const string& prefix_path);
+  static BottleTypes::AudioDriver get_audio_driver(const RegistryQuery& registry, const string& prefix_path);
   static string get_virtual_desktop(const string& prefix_path);
+  static string get_virtual_desktop(const RegistryQuery& registry, const string& prefix_path);
   static string get_last_wine_updated(const string& prefix_path);
   static bool get_bottle_status(const string& prefix_path);
+  static bool get_bottle_status(const RegistryQuery& registry, const string& prefix_path);
   static std::tuple<string, string> get_menu_program_icon_path_and_comment(const string& shortcut_path);
   static string get_desktop_program_icon_path(const string& prefix_path, const string& shortcut_path);
   static string get_program_icon_from_shortcut_file(const string& prefix_path, const string& shortcut_path);
@@ -90,18 +110,29 @@ public:
   static bool file_exists(const string& filer_path);
   static void install_or_update_winetricks();
   static void self_update_winetricks();
-  static void set_windows_version(const string& prefix_path, BottleTypes::Windows windows);
-  static void set_virtual_desktop(const string& prefix_path, string resolution);
-  static void disable_virtual_desktop(const string& prefix_path);
-  static void set_audio_driver(const string& prefix_path, BottleTypes::AudioDriver audio_driver);
+  static void set_windows_version(RegistryWriter& registry, const string& prefix_path, BottleTypes::Windows windows);
+  static void set_virtual_desktop(RegistryWriter& registry, const string& prefix_path, string resolution);
+  static void disable_virtual_desktop(RegistryWriter& registry, const string& prefix_path);
+  static void set_audio_driver(RegistryWriter& registry, const string& prefix_path, BottleTypes::AudioDriver audio_driver);
+  static void apply_registry_changes(bool wine_64_bit, const string& prefix_path, const RegistryWriter& registry);
+  static bool is_wineserver_running(const string& prefix_path);
   static vector<string> get_menu_items(const string& prefix_path);
   static vector<pair<string, string>> get_desktop_items(const string& prefix_path);
   static string log_level_to_winedebug_string(int log_level);
   static string get_wine_guid(bool wine_64_bit, const string& prefix_path, const string& application_name);
   static bool get_dll_override(const string& prefix_path, const string& dll_name, DLLOverride::LoadOrder load_order = DLLOverride::LoadOrder::Native);
+  static void add_dll_override_query(RegistryQuery& registry, const string& prefix_path, const string& dll_name);
+  static bool get_dll_override(const RegistryQuery& registry,
+                               const string& prefix_path,
+                               const string& dll_name,
+                               DLLOverride::LoadOrder load_order = DLLOverride::LoadOrder::Native);
   static string get_uninstaller(const string& prefix_path, const string& uninstallerKey);
+  static void add_uninstaller_query(RegistryQuery& registry, const string& prefix_path, const string& uninstallerKey);
+  static string get_uninstaller(const RegistryQuery& registry, const string& prefix_path, const string& uninstallerKey);
   static string get_font_filename(const string& prefix_path, BottleTypes::Bit bit, const string& fontName);
-  static string get_image_location(const string& filename);
+  static void add_font_filename_query(RegistryQuery& registry, const string& prefix_path, BottleTypes::Bit bit, const string& fontName);
+  static string get_font_filename(const RegistryQuery& registry, const string& prefix_path, BottleTypes::Bit bit, const string& fontName);
+  static Glib::RefPtr<Gdk::Pixbuf> get_image(const string& filename);
   static bool is_default_wine_bottle(const string& prefix_path);
   static string encode_text(const string& text);
   static string string_to_icon(const string& filename);
@@ -112,13 +143,11 @@ private:
   Helper(const Helper&) = delete;
   Helper& operator=(const Helper&) = delete;
 
-  static std::pair<int, string> exec(const string& command);
-  static string exec_error_message(const string& command);
-  static int close_exec_stream(std::FILE* file);
+  static std::pair<int, string> exec(const vector<string>& argv, const ProcessOptions& options = {});
+  static string exec_error_message(const vector<string>& argv, const ProcessOptions& options = {});
   static void write_file(const string& filename, const string& contents);
   static string read_file(const string& filename);
   static string get_winetricks_version();
-  static string get_reg_value(const string& filename, const string& key_name, const string& value_name);
   static vector<string> get_reg_keys(const string& file_path, const string& key_name);
   static vector<pair<string, string>> get_reg_keys_name_data_pair(const string& file_path, const string& key_name);
   static vector<pair<string, string>>
@@ -134,10 +163,15 @@ private:
                                                               const string& key_value_filter = "",
                                                               const string& key_name_ignore_filter = "");
   static string get_reg_meta_data(const string& filename, const string& meta_value_name);
+  static string get_uninstaller_reg_key(const string& uninstallerKey);
+  static string get_font_reg_key(BottleTypes::Bit bit);
   static string get_bottle_dir_from_prefix(const string& prefix_path);
   static vector<string> read_file_lines(const string& file_path);
   static vector<string> split(const string& s, const char delimiter);
-  static string unescape_reg_key_data(const string& src);
+  static bool is_reg_value_matching_filter(std::string_view name,
+                                           std::string_view data,
+                                           const string& key_value_filter,
+                                           const string& key_name_ignore_filter);
   static string string2hex(const string& str, bool capital = false);
   static string hex2string(const string& hexstr);
 };
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    lazy_window.h
+ * \brief   Proxy of a secondary window, which is constructed on first use
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "startup_profiler.h"
+#include <functional>
+#include <memory>
+#include <sigc++/sigc++.h>
+
+/**
+ * \class LazyWindow
+ * \brief Owns a secondary window (dialog), the window is only constructed when it's used for the first time.
+ *
+ * Signals of the window are connected in a handler of the created signal, which is emitted once right after the window
+ * is constructed. Signals towards the window can use get_if_created(), a window that doesn't exist yet has no state to update.
+ */
+template <typename T> class LazyWindow
+{
+public:
+  sigc::signal<void, T&> created; /*!< Window is constructed, connect the signals of the window */
+
+  /**
+   * \brief Constructor, the window is NOT constructed yet
+   * \param[in] name Window name (used in the start-up profile)
+   * \param[in] factory Constructs the window
+   */
+  LazyWindow(const char* name, std::function<std::unique_ptr<T>()> factory) : name_(name), factory_(std::move(factory))
+  {
+  }
+
+  /**
+   * \brief Get the window, the window is constructed on first use
+   * \return Window
+   */
+  T& get()
+  {
+    if (!window_)
+    {
+      StartupProfiler::Scope scope("Construct window", name_);
+      window_ = factory_();
+      created.emit(*window_);
+    }
+    return *window_;
+  }
+
+  /**
+   * \brief Get the window only when it's already constructed
+   * \return Window or nullptr
+   */
+  T* get_if_created() const
+  {
+    return window_.get();
+  }
+
+private:
+  const char* name_;
+  std::function<std::unique_ptr<T>()> factory_;
+  std::unique_ptr<T> window_;
+};
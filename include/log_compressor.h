@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    log_compressor.h
+ * \brief   Rotates the log files and compresses the rotated log files in the background (gzip)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+using std::string;
+
+/**
+ * \class LogCompressor
+ * \brief Compresses the rotated log files from a background thread, the rotated log file is split in blocks that are compressed
+ * in parallel (each block becomes a gzip member, concatenated gzip members are a valid gzip file).
+ * The number of compression threads limits the CPU usage, no compression when zero.
+ */
+class LogCompressor
+{
+public:
+  using DecompressCallback = std::function<void(bool)>; /*!< Decompression is finished (in the compressor thread), true on success */
+
+  LogCompressor();
+  virtual ~LogCompressor();
+
+  void set_max_threads(int max_threads);
+  static int get_max_threads(int cpu_share);
+  void rotate(const string& file_path, int generations);
+  void decompress(const string& compressed_path, const string& output_path, DecompressCallback on_finished);
+  static string get_compressed_path(const string& file_path, int generation);
+  static bool compress_file(int input_fd, const string& output_path, int threads, const std::atomic<bool>* is_cancelled = nullptr);
+  static bool decompress_file(const string& compressed_path, const string& output_path);
+
+private:
+  /**
+   * \brief Rotated log file that is not yet compressed
+   */
+  struct CompressTask
+  {
+    string file_path; /*!< Log file path (generation 0) */
+    int generation;   /*!< Current generation of the rotated log file, incremented by every rotation */
+    int generations;  /*!< Number of generations kept, the rotated log file is removed when it's older */
+  };
+
+  /**
+   * \brief Decompress request (opening an older log file)
+   */
+  struct DecompressTask
+  {
+    string compressed_path;
+    string output_path;
+    DecompressCallback on_finished;
+  };
+
+  std::mutex mutex_;                                /*!< Synchronizes access to the tasks & the log files (rotation) */
+  std::condition_variable condition_;               /*!< Wakes up the compressor thread */
+  std::deque<CompressTask> compress_tasks_;         /*!< Rotated log files, compressed in order */
+  std::deque<DecompressTask> decompress_tasks_;     /*!< Decompress requests, handled before the compress tasks */
+  std::optional<CompressTask> running_compression_; /*!< Rotated log file that is being compressed */
+  int max_threads_;
+  bool is_stopping_;
+  std::atomic<bool> is_cancelled_; /*!< Stops the running compression (on shutdown) */
+  std::thread thread_;
+
+  void run();
+  void compress(std::unique_lock<std::mutex>& lock);
+};
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    log_writer.h
+ * \brief   Writes the log lines of the jobs from a single background thread, with size-based log rotation
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "log_compressor.h"
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <thread>
+
+using std::string;
+
+/**
+ * \brief Log stream of a single job, see LogWriter::open_channel()
+ */
+struct LogChannel
+{
+  string file_path; /*!< Log file of the bottle */
+  string source;    /*!< Bottle & job name, written in front of every line */
+};
+
+/**
+ * \class LogWriter
+ * \brief Collects the log lines of all jobs in bounded buffers (one per log file) and writes them in batches from a background thread.
+ * Writing a line never waits on the disk: when the buffers are full the line is dropped (and the number of dropped lines is logged).
+ * A log file is rotated when it exceeds the maximum size: winegui.log becomes winegui.log.1, winegui.log.1 becomes winegui.log.2, etc.
+ * The rotated log files are compressed by the log compressor (winegui.log.1.gz), when enabled.
+ */
+class LogWriter
+{
+public:
+  LogWriter(LogCompressor& log_compressor, std::size_t max_file_size, int generations, std::size_t max_pending_bytes);
+  virtual ~LogWriter();
+
+  static LogChannel open_channel(const string& file_path, std::string_view bottle, std::string_view name);
+  void write(const LogChannel& channel, std::uint64_t job_id, std::string_view line);
+  static string get_generation_path(const string& file_path, int generation);
+  int generations() const;
+
+private:
+  /**
+   * \brief Lines of a log file that are not yet written
+   */
+  struct PendingLines
+  {
+    string data;                   /*!< Formatted lines, each line ends with a new line */
+    std::size_t dropped_lines = 0; /*!< Lines dropped because the buffers were full */
+  };
+
+  /**
+   * \brief Opened log file, only used in the writer thread
+   */
+  struct OpenFile
+  {
+    int fd;
+    off_t size; /*!< Current file size, used for the rotation */
+  };
+
+  LogCompressor& log_compressor_; /*!< Rotates & compresses the log files */
+  std::size_t max_file_size_;
+  int generations_; /*!< Number of rotated log files kept (besides the current log file) */
+  std::size_t max_pending_bytes_;
+  std::mutex mutex_;                       /*!< Synchronizes access to the pending lines & the cached timestamp */
+  std::condition_variable condition_;      /*!< Wakes up the writer thread */
+  std::map<string, PendingLines> pending_; /*!< Pending lines per log file path */
+  std::size_t pending_bytes_;              /*!< Total size of the pending lines */
+  bool is_stopping_;
+  std::time_t timestamp_second_;          /*!< Second of the cached timestamp */
+  string timestamp_;                      /*!< Cached date & time (without milliseconds) */
+  std::map<string, OpenFile> open_files_; /*!< Log files kept open while writing a burst of lines, only used in the writer thread */
+  std::thread thread_;
+
+  void run();
+  void write_batch(std::map<string, PendingLines>& batch);
+  void write_file(const string& file_path, const string& data);
+  bool open_file(const string& file_path, OpenFile& file);
+  void rotate(const string& file_path);
+  void close_files();
+};
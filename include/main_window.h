@@ -27,11 +27,14 @@
 #include "busy_dialog.h"
 #include "general_config_struct.h"
 #include "menu.h"
+#include <atomic>
 #include <gtkmm.h>
 #include <iostream>
-#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 using std::cout;
 using std::endl;
@@ -46,7 +49,8 @@ class MainWindow : public Gtk::Window
 public:
   // Signals
   sigc::signal<void, Glib::ustring&> finished_new_bottle; /*!< Finished signal after the bottle is created, with the new bottle name */
-  sigc::signal<void, BottleItem*> active_bottle;          /*!< Set the active bottle in manager, based on the selected bottle */
+  sigc::signal<void, BottleRecord*> active_bottle;        /*!< Set the active bottle in manager, based on the selected bottle */
+  sigc::signal<void, std::size_t> load_bottle_details;    /*!< Load the details of the selected bottle (row index, not yet loaded) */
   sigc::signal<void> show_edit_window;                    /*!< show Edit window signal */
   sigc::signal<void> show_clone_window;                   /*!< show Clone window signal */
   sigc::signal<void> show_configure_window;               /*!< show Settings window signal */
@@ -66,8 +70,9 @@ public:
   explicit MainWindow(Menu& menu);
   virtual ~MainWindow();
 
-  void set_wine_bottles(std::list<BottleItem>& bottles);
-  void select_row_bottle(BottleItem& bottle);
+  void set_wine_bottles(std::vector<BottleRecord>& bottles);
+  void update_wine_bottle(std::size_t index);
+  void select_row_bottle(std::size_t index);
   void reset_detailed_info();
   void reset_application_list();
   void set_general_config(const GeneralConfigData& config_data);
@@ -104,8 +109,9 @@ protected:
   Gtk::Box vbox;    /*!< The main vertical box */
   Gtk::Paned paned; /*!< The main paned panel (horizontal) */
   // Left widgets
-  Gtk::ScrolledWindow scrolled_window_listbox; /*!< Scrolled Window container, which contains the listbox */
-  Gtk::ListBox listbox;                        /*!< Listbox in the left panel */
+  Gtk::ScrolledWindow scrolled_window_listbox;                    /*!< Scrolled Window container, which contains the listbox */
+  Gtk::ListBox listbox;                                           /*!< Listbox in the left panel */
+  Glib::RefPtr<Gio::ListStore<BottleListItem>> bottle_list_store; /*!< Bottle list model, bound to the listbox */
   // Right widgets
   Gtk::ScrolledWindow detail_grid_scrolled_window_detail; /*!< Scrolled Window container for the detail grid */
   Gtk::ScrolledWindow app_list_scrolled_window;           /*!< Scrolled Window container for app list */
@@ -116,6 +122,7 @@ protected:
   Gtk::Paned container_paned;                             /*!< Main container horizontal paned panel */
   Glib::RefPtr<Gtk::ListStore> app_list_tree_model;       /*!< Application list tree model (using a liststore)  */
   Glib::RefPtr<Gtk::TreeModelFilter> app_list_filter;     /*!< Tree model filter for app list  */
+  Glib::RefPtr<Gtk::TreeModelSort> app_list_sort;         /*!< Sorted app list (on search rank), shown in the app list tree view */
   Gtk::Toolbar toolbar;                                   /*!< Toolbar at top */
   Gtk::Separator separator1;                              /*!< Separator */
   Gtk::Grid detail_grid;                                  /*!< Grid layout container to have multiple rows & columns below the toolbar */
@@ -158,6 +165,20 @@ protected:
   // Busy dialog
   BusyDialog busy_dialog_; /*!< Busy dialog, when the user should wait until install is finished */
 private:
+  /**
+   * \brief Resolved application (incl. the decoded icon), ready to be added to the application list
+   */
+  struct ApplicationRow
+  {
+    Glib::ustring name;
+    Glib::ustring description;
+    string command;
+    Glib::RefPtr<Gdk::Pixbuf> icon;
+    Glib::ustring markup;   /*!< Rendered name + description */
+    string name_key;        /*!< Normalized name for searching */
+    string description_key; /*!< Normalized description for searching */
+  };
+
   mutable std::mutex info_message_mutex_;  /*!< Synchronizes access to info message using mutex */
   mutable std::mutex error_message_mutex_; /*!< Synchronizes access to error message using mutex */
   mutable std::mutex new_version_mutex_;   /*!< Synchronizes access to new version using mutex */
@@ -168,23 +189,44 @@ private:
   string unknown_desktop_item_name_;
   BottleNewAssistant new_bottle_assistant_; /*!< New bottle wizard (behind the "new" toolbar button) */
   GeneralConfigData general_config_data_;
-  std::thread* thread_check_version_; /*!< Thread for checking version */
+  std::vector<BottleRecord>* bottles_;           /*!< Bottle data (owned by the bottle manager), in the same order as the bottle list model */
+  sigc::connection visible_rows_idle_;           /*!< Pending update of the visible bottle rows */
+  std::thread* thread_check_version_;            /*!< Thread for checking version */
+  std::unique_ptr<std::thread> thread_app_list_; /*!< Thread for resolving the application list */
+  std::atomic<bool> app_list_cancelled_;         /*!< Stop resolving the application list (eg. another bottle is selected) */
+  std::mutex app_list_mutex_;                    /*!< Synchronizes access to the resolved application rows */
+  std::vector<ApplicationRow> app_list_rows_;    /*!< Resolved application rows, not yet added to the application list */
+  bool app_list_finished_;                       /*!< The last application rows are resolved */
+  int app_list_next_order_;                      /*!< Insertion order of the next application row */
+  string app_list_query_;                        /*!< Normalized search query of the app list */
+  string app_list_prefix_;                       /*!< Bottle prefix of the shown application list */
+  std::map<int, ApplicationData> app_list_data_; /*!< Custom applications of the shown application list */
+  std::vector<int> app_list_ranks_;              /*!< Search rank per application row (index is the insertion order) */
   // Dispatchers for handling signals from the thread towards a GUI thread
   Glib::Dispatcher error_message_check_version_dispatcher_;
   Glib::Dispatcher info_message_check_version_dispatcher_;
   Glib::Dispatcher new_version_available_dispatcher_;
   Glib::Dispatcher check_version_finished_dispatcher_;
+  Glib::Dispatcher app_list_rows_dispatcher_;
 
   // Signal handlers
   virtual void on_bottle_row_clicked(Gtk::ListBoxRow* row);
   virtual void on_app_list_changed();
   virtual void on_application_row_activated(const Gtk::TreeModel::Path& path, Gtk::TreeViewColumn* /* column */);
   virtual void on_new_bottle_apply();
+  virtual void on_application_rows_resolved();
 
   // Private methods
-  void set_detailed_info(const BottleItem& bottle);
+  void set_detailed_info(const BottleRecord& bottle);
   void set_application_list(const string& prefix_path, const std::map<int, ApplicationData>& app_List);
-  void add_application(const string& name, const string& description, const string& command, const string& icon_name, bool is_icon_full_path = false);
+  void resolve_application_list(const string& prefix_path, const std::map<int, ApplicationData>& app_list);
+  static ApplicationRow
+  create_application_row(const string& name, const string& description, const string& command, const string& icon_name, bool is_icon_full_path);
+  void push_application_rows(std::vector<ApplicationRow>& batch, bool is_finished);
+  void add_application(const ApplicationRow& application);
+  void clear_application_list();
+  void cancel_application_list();
+  void cleanup_app_list_thread();
   void cleanup_check_version_thread();
   void check_version_update(bool show_equal_or_error = false);
   void check_version(bool show_equal_or_error);
@@ -192,7 +234,12 @@ private:
   void create_left_panel();
   void create_right_panel();
   void set_sensitive_toolbar_buttons(bool sensitive);
+  Gtk::Widget* create_bottle_row(const Glib::RefPtr<BottleListItem>& item);
+  void schedule_update_visible_bottle_rows();
+  void update_visible_bottle_rows();
   static void cc_list_box_update_header_func(Gtk::ListBoxRow* list_box_row, Gtk::ListBoxRow* before);
   bool app_list_visible_func(const Gtk::TreeModel::const_iterator& iter);
-  void treeview_set_cell_data_name_desc(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter);
+  int app_list_sort_func(const Gtk::TreeModel::iterator& a, const Gtk::TreeModel::iterator& b);
+  int app_list_rank(const Gtk::TreeModel::Row& row);
+  void create_app_list_sort_model();
 };
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    pixbuf_cache.h
+ * \brief   Process-wide cache of decoded images (LRU, bounded by bytes)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <gdkmm/pixbuf.h>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+using std::string;
+
+/**
+ * \class PixbufCache
+ * \brief Shared cache of decoded images (app icons, Windows logos, etc.), keyed by path and size.
+ *
+ * The least recently used images are evicted once the decoded images exceed the byte limit.
+ * Images from files on disk are validated by their modification time, so an icon that is rewritten (eg. by Wine) is decoded again.
+ * Can be used from any thread.
+ */
+class PixbufCache
+{
+public:
+  /**
+   * \brief Cache counters
+   */
+  struct Statistics
+  {
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t evictions;
+    std::size_t bytes;
+    std::size_t images;
+  };
+
+  // Singleton
+  static PixbufCache& get_instance();
+
+  Glib::RefPtr<Gdk::Pixbuf> get_image(const string& filename, int size = -1);
+  Glib::RefPtr<Gdk::Pixbuf> get_file(const string& file_path, int size = -1);
+  void set_max_bytes(std::size_t max_bytes);
+  Statistics get_statistics() const;
+  void print_statistics() const;
+  void clear();
+
+private:
+  using Key = std::pair<string, int>; /*!< Path (resource or file) and size (-1 is the original size) */
+
+  /**
+   * \brief Decoded image
+   */
+  struct Entry
+  {
+    Key key;
+    Glib::RefPtr<Gdk::Pixbuf> pixbuf;
+    std::int64_t modified_ns; /*!< Modification time of the file, -1 for images compiled into the binary */
+    std::size_t bytes;
+  };
+
+  PixbufCache();
+  ~PixbufCache();
+  PixbufCache(const PixbufCache&) = delete;
+  PixbufCache& operator=(const PixbufCache&) = delete;
+
+  Glib::RefPtr<Gdk::Pixbuf> get(const Key& key, std::int64_t modified_ns, const std::function<Glib::RefPtr<Gdk::Pixbuf>()>& load);
+  void evict();
+
+  mutable std::mutex mutex_;
+  std::list<Entry> entries_;                        /*!< Most recently used image first */
+  std::map<Key, std::list<Entry>::iterator> index_; /*!< Key -> entry */
+  std::size_t max_bytes_;                           /*!< Limit of the decoded images in bytes */
+  std::size_t bytes_;                               /*!< Total bytes of the decoded images */
+  std::uint64_t hits_;
+  std::uint64_t misses_;
+  std::uint64_t evictions_;
+};
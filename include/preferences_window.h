@@ -39,18 +39,22 @@ public:
 
 protected:
   // Child widgets
-  Gtk::Box vbox;           /*!< main vertical box */
-  Gtk::Box hbox_buttons;   /*!< box for buttons */
-  Gtk::Grid settings_grid; /*!< grid layout for settings */
+  Gtk::Box vbox;                 /*!< main vertical box */
+  Gtk::Box hbox_buttons;         /*!< box for buttons */
+  Gtk::Box hbox_log_compression; /*!< box for the log compression CPU share */
+  Gtk::Grid settings_grid;       /*!< grid layout for settings */
 
   Gtk::Label header_preferences_label;                 /*!< header preferences label */
   Gtk::Label default_folder_label;                     /*!< default folder label */
   Gtk::Label display_default_wine_machine_label;       /*!< display default Wine machine label */
   Gtk::Label logging_label_heading;                    /*!< Logging header label */
   Gtk::Label logging_stderr_label;                     /*!< logging stderr label */
+  Gtk::Label log_compression_label;                    /*!< log compression label */
+  Gtk::Label log_compression_unit_label;               /*!< log compression unit label */
   Gtk::Entry default_folder_entry;                     /*!< default folder input field */
   Gtk::CheckButton display_default_wine_machine_check; /*!< display default Wine machine checkbox */
   Gtk::CheckButton enable_logging_stderr_check;        /*!< debug logging checkbox */
+  Gtk::SpinButton log_compression_cpu_share_spin;      /*!< CPU share of the log compression spin button */
   Gtk::Button select_folder_button;                    /*!< select folder button */
   Gtk::Button save_button;                             /*!< save button */
   Gtk::Button cancel_button;                           /*!< cancel button */
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    process.h
+ * \brief   Start programs without a shell (posix_spawn), using an argument vector
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+using std::pair;
+using std::string;
+using std::vector;
+
+/**
+ * \brief Launch options of a process
+ */
+struct ProcessOptions
+{
+  string working_directory;              /*!< Working directory, empty to use the current directory */
+  vector<pair<string, string>> env_vars; /*!< Environment variables, added to (or replacing) the current environment */
+  bool merge_stderr = true;              /*!< Capture stderr together with stdout (like 2>&1), otherwise stderr is inherited */
+};
+
+/**
+ * \brief Exit code & output of a finished process
+ */
+struct ProcessResult
+{
+  int exit_code; /*!< Exit code, 128 + signal number when the process was killed, 127 when the program could not be started */
+  string output; /*!< Captured output */
+};
+
+/**
+ * \class Process
+ * \brief Run a program directly (no /bin/sh in between), so arguments are never interpreted by a shell and don't need quoting.
+ * The program is searched in PATH, when the name contains no slash. Can be used from any thread.
+ */
+class Process
+{
+public:
+  using OutputCallback = std::function<void(std::string_view)>; /*!< Receives the output while the process is running */
+
+  static ProcessResult run(const vector<string>& argv, const ProcessOptions& options = {});
+  static int run(const vector<string>& argv, const ProcessOptions& options, const OutputCallback& on_output);
+  static string to_display_string(const vector<string>& argv, const vector<pair<string, string>>& env_vars = {});
+  static pid_t start(const vector<string>& argv, const ProcessOptions& options, int& output_fd, string& error_message);
+  static int exit_code(int wait_status);
+
+  static const int ExitCodeNotStarted = 127; /*!< Exit code when the program could not be started (same as a shell: command not found) */
+
+private:
+  static int wait(pid_t pid);
+};
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    process_supervisor.h
+ * \brief   Runs the programs & installs of all bottles from a single I/O thread (GLib main loop)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "process.h"
+#include <cstdint>
+#include <functional>
+#include <glib.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+/**
+ * \brief Command of a job, the commands of a job run one after the other
+ */
+struct JobCommand
+{
+  vector<string> argv;    /*!< Program followed by its arguments */
+  ProcessOptions options; /*!< Working directory, environment variables & stderr capturing */
+  bool give_error = true; /*!< A non-zero exit code becomes the exit code of the job */
+};
+
+/**
+ * \brief Running job, see ProcessSupervisor::get_running_jobs()
+ */
+struct JobInfo
+{
+  std::uint64_t id;
+  string name;
+  pid_t pid;           /*!< Process ID of the current command */
+  gint64 start_time;   /*!< Monotonic start time of the job in microseconds */
+  std::size_t command; /*!< Index of the current command */
+};
+
+/**
+ * \class ProcessSupervisor
+ * \brief Starts the jobs and watches them from one I/O thread, regardless of the number of running programs.
+ * The child processes are reaped via a child watch source and the output pipes are read (non-blocking) via fd sources.
+ * The callbacks are called in the I/O thread, so they should not block (use a dispatcher to reach the GUI thread).
+ */
+class ProcessSupervisor
+{
+public:
+  using OutputCallback = std::function<void(std::uint64_t, std::string_view)>; /*!< Job ID & output chunk, chunks are not aligned to lines */
+  using ExitCallback = std::function<void(std::uint64_t, int)>;                /*!< Job is finished, with the job ID & exit code of the job */
+
+  ProcessSupervisor();
+  virtual ~ProcessSupervisor();
+
+  std::uint64_t start(const string& name, vector<JobCommand> commands, OutputCallback on_output, ExitCallback on_exit);
+  vector<JobInfo> get_running_jobs() const;
+
+private:
+  /**
+   * \brief Job state, only used in the I/O thread (except the fields copied to running_jobs_)
+   */
+  struct Job
+  {
+    ProcessSupervisor* supervisor;
+    std::uint64_t id;
+    string name;
+    vector<JobCommand> commands;
+    OutputCallback on_output;
+    ExitCallback on_exit;
+    std::size_t command = 0; /*!< Index of the current command */
+    pid_t pid = -1;          /*!< Process ID of the current command */
+    int output_fd = -1;      /*!< Read end of the output pipe (non-blocking) */
+    GSource* output_source = nullptr;
+    GSource* child_source = nullptr;
+    bool is_exited = false;    /*!< Current command is exited (and reaped) */
+    int command_exit_code = 0; /*!< Exit code of the current command */
+    int exit_code = 0;         /*!< Exit code of the job */
+    gint64 start_time = 0;
+  };
+
+  /**
+   * \brief Job that is passed to the I/O thread
+   */
+  struct StartRequest
+  {
+    ProcessSupervisor* supervisor;
+    std::unique_ptr<Job> job;
+  };
+
+  GMainContext* context_;                              /*!< Main context of the I/O thread */
+  GMainLoop* loop_;                                    /*!< Main loop of the I/O thread */
+  std::thread thread_;                                 /*!< I/O thread */
+  std::map<std::uint64_t, std::unique_ptr<Job>> jobs_; /*!< Jobs, only used in the I/O thread */
+  mutable std::mutex running_jobs_mutex_;              /*!< Synchronizes access to running_jobs_ & next_job_id_ */
+  std::map<std::uint64_t, JobInfo> running_jobs_;      /*!< Copy of the job info, for other threads */
+  std::uint64_t next_job_id_;
+  vector<char> read_buffer_; /*!< Output read buffer, only used in the I/O thread */
+
+  void start_command(Job& job);
+  void finish_command(Job& job);
+  void close_output(Job& job);
+  void update_running_job(const Job& job);
+
+  static gboolean on_output_ready(gint fd, GIOCondition condition, gpointer user_data);
+  static void on_child_exited(GPid pid, gint wait_status, gpointer user_data);
+};
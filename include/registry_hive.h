@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_hive.h
+ * \brief   Memory-mapped and indexed Wine registry file (read-only)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using std::string;
+
+/**
+ * \class RegistryHive
+ * \brief Read-only view of a Wine registry file (eg. user.reg or system.reg).
+ *
+ * The file is memory-mapped and indexed once (key name -> section), after that every lookup is done in-memory.
+ * The index is a flat hash table, which is a lot cheaper to build than a node based map with thousands of keys.
+ * Hives are shared via a process-wide cache, which is invalidated when the file on disk changes (device, inode,
+ * size or modification time). Wine saves the registry by renaming a temporary file over the old one,
+ * so an existing mapping stays valid while Wine is writing a new version.
+ */
+class RegistryHive
+{
+public:
+  static std::shared_ptr<const RegistryHive> open(const string& file_path);
+  static void invalidate(const string& file_path);
+
+  ~RegistryHive();
+  RegistryHive(const RegistryHive&) = delete;
+  RegistryHive& operator=(const RegistryHive&) = delete;
+
+  const string& get_file_path() const;
+  bool has_key(std::string_view key_name) const;
+  string get_value(std::string_view key_name, std::string_view value_name) const;
+  std::vector<string> get_values(std::string_view key_name, const std::vector<std::string_view>& value_names) const;
+  std::string_view get_key_body(std::string_view key_name) const;
+  string get_meta_data(std::string_view meta_value_name) const;
+
+private:
+  /**
+   * \brief Registry key section, views are pointing into the mapped file
+   */
+  struct Section
+  {
+    std::string_view name; /*!< Key name including brackets, eg. [Software\\\\Wine] */
+    std::string_view body; /*!< All lines below the key name until the next empty line */
+  };
+
+  string file_path_;
+  const char* data_;
+  std::size_t size_;
+  std::vector<std::string_view> meta_lines_; /*!< Lines before the first key, eg. #arch=win64 */
+  std::vector<Section> sections_;            /*!< Sections in file order */
+  std::vector<std::uint32_t> index_;         /*!< Open addressing hash table: key name -> index into sections_ + 1 (0 = empty) */
+  mutable std::once_flag sorted_index_once_;
+  mutable std::vector<std::size_t> sorted_index_; /*!< Section indices sorted on key name, used for prefix lookups */
+
+  RegistryHive(const string& file_path, const char* data, std::size_t size);
+  void build_index();
+  std::size_t find_slot(std::string_view key_name) const;
+  const Section* find_section(std::string_view key_name) const;
+};
@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_query.h
+ * \brief   Batched look-up of multiple Wine registry values
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include <tuple>
+
+using std::string;
+
+/**
+ * \class RegistryQuery
+ * \brief Query plan of registry values, first add all the requests then execute() them at once.
+ *
+ * Each registry file is opened only once per execute(), and all requested values of the same key
+ * are read during a single scan of that key.
+ */
+class RegistryQuery
+{
+public:
+  void add_value(const string& file_path, const string& key_name, const string& value_name);
+  void add_meta_data(const string& file_path, const string& meta_value_name);
+  void execute();
+  const string& get_value(const string& file_path, const string& key_name, const string& value_name) const;
+  const string& get_meta_data(const string& file_path, const string& meta_value_name) const;
+
+private:
+  /**
+   * \brief Result of a single request
+   */
+  struct Result
+  {
+    string data;         /*!< Value data (without quotes), empty when not found */
+    bool loaded = false; /*!< Registry file could be opened */
+  };
+
+  //// Requests sorted on (file path, key name, value name), meta data requests use an empty key name
+  std::map<std::tuple<string, string, string>, Result> requests_;
+
+  const string& get_result(const string& file_path, const string& key_name, const string& value_name) const;
+};
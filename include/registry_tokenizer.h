@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_tokenizer.h
+ * \brief   Zero-allocation tokenizer for Wine registry files
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+
+using std::string;
+
+/**
+ * \brief Registry value of a key, the views are pointing into the tokenized buffer
+ */
+struct RegistryValue
+{
+  std::string_view name; /*!< Value name without quotes (empty for the default '@' value), still escaped */
+  std::string_view data; /*!< Value data, quotes are removed for string values, still escaped */
+  bool is_string;        /*!< Data is a quoted string (REG_SZ), otherwise eg. dword:00000001 or hex:.. */
+  bool is_escaped;       /*!< Name or data contains backslash escapes, see RegistryTokenizer::unescape() */
+};
+
+/**
+ * \class RegistryTokenizer
+ * \brief Tokenizes the lines of a Wine registry file (or a part of it) without allocating memory.
+ *
+ * Line and key searches are done with memchr()/memmem(), which are vectorized by the C library.
+ * All returned views are pointing into the buffer given to the constructor.
+ */
+class RegistryTokenizer
+{
+public:
+  explicit RegistryTokenizer(std::string_view buffer);
+
+  bool next_line(std::string_view& line);
+  bool next_key(std::string_view& key_name, std::string_view& key_body);
+  bool next_value(RegistryValue& value);
+  std::string_view remaining() const;
+
+  static bool parse_value(std::string_view line, RegistryValue& value);
+  static string unescape(std::string_view src);
+  static void unescape(std::string_view src, string& dest);
+
+private:
+  std::string_view remaining_; /*!< Part of the buffer that is not tokenized yet */
+};
@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_writer.h
+ * \brief   Offline Wine registry writer (batched changes, atomically written)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+using std::string;
+
+/**
+ * \class RegistryWriter
+ * \brief Batch of registry changes, first add all the changes then commit() them at once.
+ *
+ * commit() edits the registry files directly, each file is written only once (to a temporary file which is renamed
+ * over the original). Only use commit() when the wineserver of the prefix is NOT running, since the wineserver
+ * keeps the registry in memory and overwrites the files when it shuts down. Otherwise import to_regedit() using regedit.
+ */
+class RegistryWriter
+{
+public:
+  void set_value(const string& file_path, const string& key_name, const string& value_name, const string& data);
+  void delete_value(const string& file_path, const string& key_name, const string& value_name);
+  bool empty() const;
+  void clear();
+  void commit() const;
+  string to_regedit(const string& file_path, const string& root_key) const;
+
+private:
+  using ChangeMap = std::map<std::tuple<string, string, string>, std::optional<string>>;
+
+  //// Changes sorted on (file path, key name, value name), no data means the value gets deleted
+  ChangeMap changes_;
+
+  static void commit_file(const string& file_path, ChangeMap::const_iterator begin, ChangeMap::const_iterator end);
+  static void write_file_atomic(const string& file_path, const string& contents);
+  static string escape(std::string_view src);
+};
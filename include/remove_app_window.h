@@ -23,7 +23,7 @@
 #include <gtkmm.h>
 
 // Forward declaration
-class BottleItem;
+class BottleRecord;
 
 /**
  * \class RemoveAppWindow
@@ -39,7 +39,7 @@ public:
   virtual ~RemoveAppWindow();
 
   void show();
-  void set_active_bottle(BottleItem* bottle);
+  void set_active_bottle(BottleRecord* bottle);
   void reset_active_bottle();
 
 protected:
@@ -56,7 +56,7 @@ protected:
   Gtk::Button cancel_button;          /*!< cancel button */
 
 private:
-  BottleItem* active_bottle_; /*!< Current active bottle */
+  BottleRecord* active_bottle_; /*!< Current active bottle */
 
   // Signal handlers
   void on_cancel_button_clicked();
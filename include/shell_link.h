@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    shell_link.h
+ * \brief   Reader of Windows shortcut files (*.lnk, MS-SHLLINK binary format)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+using std::string;
+
+/**
+ * \brief Fields of a Windows shortcut, strings are UTF-8 (empty when not present in the shortcut)
+ */
+struct ShellLink
+{
+  string target_path;   /*!< Windows path of the target, eg. C:\\Program Files\\Game\\game.exe */
+  string arguments;     /*!< Command-line arguments */
+  string working_dir;   /*!< Working directory */
+  string icon_location; /*!< Icon file (eg. an .exe, .dll or .ico file) */
+  int icon_index;       /*!< Icon index in the icon file */
+  string description;   /*!< Description (the shortcut comment) */
+  string relative_path; /*!< Target path relative to the shortcut file */
+};
+
+/**
+ * \class ShellLinkReader
+ * \brief Parses the shortcut header and the LinkTargetIDList, LinkInfo, StringData & ExtraData sections.
+ *
+ * The target path is taken from the LinkInfo section, when missing from the environment variable data block
+ * or the shell items of the LinkTargetIDList. Parsed shortcuts are shared via a process-wide cache,
+ * which is invalidated when the file on disk changes (device, inode, size or modification time).
+ */
+class ShellLinkReader
+{
+public:
+  static std::shared_ptr<const ShellLink> open(const string& file_path);
+  static void invalidate(const string& file_path);
+  static bool parse(std::string_view data, ShellLink& link);
+};
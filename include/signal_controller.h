@@ -21,6 +21,7 @@
 #pragma once
 
 #include "bottle_types.h"
+#include "lazy_window.h"
 #include <gtkmm.h>
 #include <thread>
 
@@ -34,8 +35,10 @@ class BottleEditWindow;
 class BottleCloneWindow;
 class BottleConfigureEnvVarWindow;
 class BottleConfigureWindow;
+class ConsoleWindow;
 class AddAppWindow;
 class RemoveAppWindow;
+class BottleRecord;
 struct UpdateBottleStruct;
 struct CloneBottleStruct;
 
@@ -48,16 +51,7 @@ class SignalController : public Gtk::Window
   friend class MainWindow;
 
 public:
-  SignalController(BottleManager& manager,
-                   Menu& menu,
-                   PreferencesWindow& preferences_window,
-                   AboutDialog& about_dialog,
-                   BottleEditWindow& edit_window,
-                   BottleCloneWindow& clone_window,
-                   BottleConfigureEnvVarWindow& configure_env_var_window,
-                   BottleConfigureWindow& configure_window,
-                   AddAppWindow& add_app_window,
-                   RemoveAppWindow& remove_app_window);
+  SignalController(BottleManager& manager, Menu& menu);
   virtual ~SignalController();
   void set_main_window(MainWindow* main_window);
   void dispatch_signals();
@@ -76,6 +70,7 @@ public:
 protected:
 private:
   void cleanup_bottle_manager_thread();
+  void dispatch_window_signals();
 
   // slots
   virtual bool on_mouse_button_pressed(GdkEventButton* event);
@@ -93,18 +88,24 @@ private:
   virtual void on_error_message_created();
   virtual void on_error_message_updated();
   virtual void on_error_message_cloned();
+  virtual void on_active_bottle(BottleRecord* bottle);
+  virtual void on_reset_active_bottle();
 
   MainWindow* main_window_;
   BottleManager& manager_;
   Menu& menu_;
-  PreferencesWindow& preferences_window_;
-  AboutDialog& about_dialog_;
-  BottleEditWindow& edit_window_;
-  BottleCloneWindow& clone_window_;
-  BottleConfigureEnvVarWindow& configure_env_var_window_;
-  BottleConfigureWindow& configure_window_;
-  AddAppWindow& add_app_window_;
-  RemoveAppWindow& remove_app_window_;
+  BottleRecord* active_bottle_; /*!< Current active bottle, passed to a window when it's constructed */
+
+  // Secondary windows, constructed on first use (the edit window is the parent of the environment variables window)
+  LazyWindow<PreferencesWindow> preferences_window_;
+  LazyWindow<AboutDialog> about_dialog_;
+  LazyWindow<BottleEditWindow> edit_window_;
+  LazyWindow<BottleCloneWindow> clone_window_;
+  LazyWindow<BottleConfigureEnvVarWindow> configure_env_var_window_;
+  LazyWindow<BottleConfigureWindow> configure_window_;
+  LazyWindow<AddAppWindow> add_app_window_;
+  LazyWindow<RemoveAppWindow> remove_app_window_;
+  LazyWindow<ConsoleWindow> console_window_;
 
   // Dispatchers for handling signals from the thread towards a GUI thread
   Glib::Dispatcher bottle_created_dispatcher_;
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    startup_profiler.h
+ * \brief   Lightweight tracing of the start-up phases (--profile-startup)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glib.h>
+#include <set>
+#include <string>
+
+using std::string;
+
+/**
+ * \class StartupProfiler
+ * \brief Records the duration of the start-up phases (scoped timers), only when enabled via the command-line.
+ *
+ * Once all the milestones are reached (eg. the first frame is drawn and the bottles are loaded), a breakdown per phase
+ * is printed and optionally a Chrome trace file (JSON) is written. Afterwards the profiler is disabled again.
+ * Timers can be used from any thread, a disabled timer only checks a flag.
+ */
+class StartupProfiler
+{
+public:
+  /**
+   * \brief Scoped timer, records a phase from construction until destruction
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(const char* name, const string& detail = "");
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const char* name_;
+    string detail_;
+    gint64 start_time_; /*!< Start time in µs (monotonic), 0 when the profiler is disabled */
+  };
+
+  // Milestones of the start-up
+  static constexpr const char* FirstFrame = "First frame";       /*!< The main window is drawn for the first time */
+  static constexpr const char* BottlesLoaded = "Bottles loaded"; /*!< All bottles are inspected (or there are no bottles) */
+
+  static void enable(const string& trace_file_path, const std::set<string>& milestones);
+  static bool is_enabled();
+  static void record(const char* name, const string& detail, gint64 start_time, gint64 end_time);
+  static void milestone(const string& name);
+  static void report();
+};
@@ -1,4 +1,4 @@
 #!/usr/bin/env bash
 sudo apt update
 sudo apt upgrade
-sudo apt install build-essential cmake ninja-build g++ libgtkmm-3.0-dev pkg-config doxygen graphviz rpm
+sudo apt install build-essential cmake ninja-build g++ libgtkmm-3.0-dev zlib1g-dev pkg-config doxygen graphviz rpm
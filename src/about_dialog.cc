@@ -30,7 +30,7 @@ AboutDialog::AboutDialog(Gtk::Window& parent)
       visit_github_project_link_button("https://github.com/winegui/WineGUI", "Visit the mirror GitHub Project")
 {
   // Set logo
-  logo.set(Helper::get_image_location("logo.png"));
+  logo.set(Helper::get_image("logo.png"));
   // Set version
   std::vector<Glib::ustring> devs;
   devs.emplace_back("Melroy van den Berg <melroy@melroy.org>");
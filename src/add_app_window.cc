@@ -20,7 +20,7 @@
  */
 #include "add_app_window.h"
 #include "bottle_config_file.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
 #include <iostream>
 
 /**
@@ -105,7 +105,7 @@ AddAppWindow::~AddAppWindow()
  * \brief Signal handler when a new bottle is set in the main window
  * \param[in] bottle Current active bottle
  */
-void AddAppWindow::set_active_bottle(BottleItem* bottle)
+void AddAppWindow::set_active_bottle(BottleRecord* bottle)
 {
   active_bottle_ = bottle;
 }
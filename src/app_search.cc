@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    app_search.cc
+ * \brief   Normalized search keys & ranking of the application list search
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "app_search.h"
+#include <algorithm>
+#include <cctype>
+
+//// Ranks of the match types, a higher rank is shown first
+static const int RankExactName = 1000;
+static const int RankNamePrefix = 900;
+static const int RankWordPrefix = 800;
+static const int RankNameSubstring = 700;
+static const int RankDescriptionSubstring = 400;
+static const int RankFuzzyMax = 299;
+//// Rank penalty per character of the match position, limited so the match type always wins
+static const int MaxPositionPenalty = 99;
+
+/**
+ * \brief Normalize a text for searching (compatibility composed & case folded), eg. "Ｆｉｌｅ" matches "file"
+ * \param[in] text Text (name, description or search query)
+ * \return Search key
+ */
+string AppSearch::normalize(const Glib::ustring& text)
+{
+  if (!text.validate())
+  {
+    // Not UTF-8 (eg. a shortcut name in a legacy encoding), only lower the ASCII characters
+    string key = text.raw();
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    return key;
+  }
+  return text.normalize(Glib::NORMALIZE_ALL_COMPOSE).casefold().raw();
+}
+
+/**
+ * \brief Rank an application for the search query, based on the normalized keys (see normalize()).
+ * Exact and prefix matches of the name are ranked highest, followed by word prefixes, name substrings,
+ * description substrings and lastly fuzzy matches (all the query characters appear in order in the name).
+ * \param[in] name_key Normalized name of the application
+ * \param[in] description_key Normalized description of the application
+ * \param[in] query Normalized search query
+ * \return Rank (higher is better) or NoMatch
+ */
+int AppSearch::rank(const string& name_key, const string& description_key, const string& query)
+{
+  if (query.empty())
+    return 0;
+  if (name_key == query)
+    return RankExactName;
+
+  std::size_t first_position = name_key.find(query);
+  if (first_position == 0)
+    return RankNamePrefix;
+  if (first_position != string::npos)
+  {
+    // Start of another word in the name (eg. "explorer" in "Internet Explorer")
+    for (std::size_t position = first_position; position != string::npos; position = name_key.find(query, position + 1))
+    {
+      if (!std::isalnum(static_cast<unsigned char>(name_key[position - 1])))
+        return RankWordPrefix;
+    }
+    return RankNameSubstring - static_cast<int>(std::min<std::size_t>(first_position, MaxPositionPenalty));
+  }
+
+  std::size_t description_position = description_key.find(query);
+  if (description_position != string::npos)
+    return RankDescriptionSubstring - static_cast<int>(std::min<std::size_t>(description_position, MaxPositionPenalty));
+
+  return fuzzy_rank(name_key, query);
+}
+
+/**
+ * \brief Fuzzy rank, all the characters of the query should appear in the same order in the name (eg. "wcfg" in "wine config").
+ * Gaps between the matching characters decrease the rank.
+ * \param[in] name_key Normalized name of the application
+ * \param[in] query Normalized search query
+ * \return Rank (between 1 and RankFuzzyMax) or NoMatch
+ */
+int AppSearch::fuzzy_rank(const string& name_key, const string& query)
+{
+  int score = RankFuzzyMax;
+  std::size_t position = 0;
+  std::size_t previous = string::npos;
+  for (char c : query)
+  {
+    position = name_key.find(c, position);
+    if (position == string::npos)
+      return NoMatch;
+    if (previous != string::npos && position != previous + 1)
+      score -= static_cast<int>(std::min<std::size_t>(position - previous - 1, 10)) + 5;
+    previous = position++;
+  }
+  return std::max(score, 1);
+}
@@ -19,7 +19,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "bottle_clone_window.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
 
 /**
  * \brief Constructor
@@ -137,7 +137,7 @@ void BottleCloneWindow::show()
  * \brief Signal handler when a new bottle is set in the main window
  * \param[in] bottle - New bottle
  */
-void BottleCloneWindow::set_active_bottle(BottleItem* bottle)
+void BottleCloneWindow::set_active_bottle(BottleRecord* bottle)
 {
   active_bottle_ = bottle;
 }
@@ -20,7 +20,7 @@
  */
 #include "bottle_configure_env_var_window.h"
 #include "bottle_config_file.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
 #include <iostream>
 
 /**
@@ -112,7 +112,7 @@ BottleConfigureEnvVarWindow::~BottleConfigureEnvVarWindow()
  * \brief Signal handler when a new bottle is set in the main window
  * \param[in] bottle Current active bottle
  */
-void BottleConfigureEnvVarWindow::set_active_bottle(BottleItem* bottle)
+void BottleConfigureEnvVarWindow::set_active_bottle(BottleRecord* bottle)
 {
   active_bottle_ = bottle;
 }
@@ -19,10 +19,36 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "bottle_configure_window.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
 #include "helper.h"
+#include "registry_query.h"
 #include <iostream>
 
+// Registry values used to check which packages are installed
+static const string DllD3dx9 = "*d3dx9_43";
+static const string DllDxgi = "*dxgi";
+static const string DllD3d12 = "*d3d12";
+static const string DllMsvcp120 = "*msvcp120";
+static const string DllMsvcp140 = "*msvcp140";
+static const string DllMscoree = "*mscoree";
+static const string FontLiberationMono = "Liberation Mono (TrueType)";
+static const string FontComicSans = "Comic Sans MS (TrueType)";
+static const string UninstallerVisualCpp2013 = "{61087a79-ac85-455c-934d-1fa22cc64f36}";
+static const string UninstallerVisualCpp2013x64 = "{ef6b00ec-13e1-4c25-9064-b2f383cb8412}";
+static const string UninstallerVisualCpp2015 = "{462f63a8-6347-4894-a1b3-dbfe3a4c981d}";
+static const string UninstallerVisualCpp2015x64 = "{F20396E5-D84E-3505-A7A8-7358F0155F6C}";
+static const string UninstallerVisualCpp2017 = "{624ba875-fdfc-4efa-9c66-b170dfebc3ec}";
+static const string UninstallerVisualCpp2017x64 = "{65835E57-3712-4382-990A-8D39008A8E0B}";
+static const string UninstallerVisualCpp2019 = "{e3aefa8b-a2ea-42b8-a384-95f2ff6df681}";
+static const string UninstallerVisualCpp2019x64 = "{0F03096E-F81F-48D0-AEE0-9F8513CD883F}";
+static const string UninstallerVisualCpp2022 = "{2cfeba4a-21f8-4ea7-9927-c5a5c6f13cc9}";
+static const string UninstallerVisualCpp2022x64 = "{1CA7421F-A225-4A9C-B320-A36981A2B789}";
+static const string UninstallerDotNet4 = "Microsoft .NET Framework 4 Extended";
+static const string UninstallerDotNet45 = "{92FB6C44-E685-45AD-9B20-CADF4CABA132}";
+static const string UninstallerDotNet47 = "{92FB6C44-E685-45AD-9B20-CADF4CABA132} - 1033";
+static const string UninstallerDotNet6 = "{5DEFBDBE-FF1A-4EB2-8DFB-17A26A7E6442}";
+static const string UninstallerDotNet6x64 = "{3CC763AD-93B3-41EF-ABF8-CFE63A1DC3A6}";
+
 /**
  * \brief Constructor
  * \param parent Reference to parent GTK Window
@@ -181,7 +207,7 @@ void BottleConfigureWindow::show()
  * \brief Signal handler when a new bottle is set in the main window
  * \param[in] bottle Current active bottle
  */
-void BottleConfigureWindow::set_active_bottle(BottleItem* bottle)
+void BottleConfigureWindow::set_active_bottle(BottleRecord* bottle)
 {
   active_bottle_ = bottle;
 }
@@ -199,7 +225,30 @@ void BottleConfigureWindow::reset_active_bottle()
  */
 void BottleConfigureWindow::update_installed()
 {
-  if (is_d3dx9_installed())
+  // Read all the registry values that are needed below at once
+  RegistryQuery registry;
+  if (active_bottle_ != nullptr)
+  {
+    string wine_prefix = active_bottle_->wine_location();
+    for (const string& dll_name : {DllD3dx9, DllDxgi, DllD3d12, DllMsvcp120, DllMsvcp140, DllMscoree})
+    {
+      Helper::add_dll_override_query(registry, wine_prefix, dll_name);
+    }
+    for (const string& font_name : {FontLiberationMono, FontComicSans})
+    {
+      Helper::add_font_filename_query(registry, wine_prefix, active_bottle_->bit(), font_name);
+    }
+    for (const string& uninstaller_key :
+         {UninstallerVisualCpp2013, UninstallerVisualCpp2013x64, UninstallerVisualCpp2015, UninstallerVisualCpp2015x64, UninstallerVisualCpp2017,
+          UninstallerVisualCpp2017x64, UninstallerVisualCpp2019, UninstallerVisualCpp2019x64, UninstallerVisualCpp2022, UninstallerVisualCpp2022x64,
+          UninstallerDotNet4, UninstallerDotNet45, UninstallerDotNet47, UninstallerDotNet6, UninstallerDotNet6x64})
+    {
+      Helper::add_uninstaller_query(registry, wine_prefix, uninstaller_key);
+    }
+    registry.execute();
+  }
+
+  if (is_d3dx9_installed(registry))
   {
     Gtk::Image* reinstall_d3dx9_image = Gtk::manage(new Gtk::Image());
     reinstall_d3dx9_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -214,7 +263,7 @@ void BottleConfigureWindow::update_installed()
     install_d3dx9_button.set_icon_widget(*install_d3dx9_image);
   }
 
-  if (is_dxvk_installed())
+  if (is_dxvk_installed(registry))
   {
     Gtk::Image* reinstall_dxvk_image = Gtk::manage(new Gtk::Image());
     reinstall_dxvk_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -229,7 +278,7 @@ void BottleConfigureWindow::update_installed()
     install_dxvk_button.set_icon_widget(*install_dxvk_image);
   }
 
-  if (is_vkd3d_installed())
+  if (is_vkd3d_installed(registry))
   {
     Gtk::Image* reinstall_vkd3d_image = Gtk::manage(new Gtk::Image());
     reinstall_vkd3d_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -244,7 +293,7 @@ void BottleConfigureWindow::update_installed()
     install_vkd3d_button.set_icon_widget(*install_vkd3d_image);
   }
 
-  if (is_liberation_installed())
+  if (is_liberation_installed(registry))
   {
     Gtk::Image* reinstall_liberation_image = Gtk::manage(new Gtk::Image());
     reinstall_liberation_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -259,7 +308,7 @@ void BottleConfigureWindow::update_installed()
     install_liberation_fonts_button.set_icon_widget(*install_liberation_image);
   }
 
-  if (is_core_fonts_installed())
+  if (is_core_fonts_installed(registry))
   {
     Gtk::Image* reinstall_core_fonts_image = Gtk::manage(new Gtk::Image());
     reinstall_core_fonts_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -275,7 +324,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for Visual C++ 2013
-  if (is_visual_cpp_2013_installed())
+  if (is_visual_cpp_2013_installed(registry))
   {
     Gtk::Image* reinstall_visual_cpp_2013_image = Gtk::manage(new Gtk::Image());
     reinstall_visual_cpp_2013_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -291,7 +340,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for Visual C++ 2015
-  if (is_visual_cpp_2015_installed())
+  if (is_visual_cpp_2015_installed(registry))
   {
     Gtk::Image* reinstall_visual_cpp_2015_image = Gtk::manage(new Gtk::Image());
     reinstall_visual_cpp_2015_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -307,7 +356,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for Visual C++ 2017
-  if (is_visual_cpp_2017_installed())
+  if (is_visual_cpp_2017_installed(registry))
   {
     Gtk::Image* reinstall_visual_cpp_2017_image = Gtk::manage(new Gtk::Image());
     reinstall_visual_cpp_2017_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -323,7 +372,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for Visual C++ 2019
-  if (is_visual_cpp_2019_installed())
+  if (is_visual_cpp_2019_installed(registry))
   {
     Gtk::Image* reinstall_visual_cpp_2019_image = Gtk::manage(new Gtk::Image());
     reinstall_visual_cpp_2019_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -339,7 +388,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for Visual C++ 2022
-  if (is_visual_cpp_2022_installed())
+  if (is_visual_cpp_2022_installed(registry))
   {
     Gtk::Image* reinstall_visual_cpp_2022_image = Gtk::manage(new Gtk::Image());
     reinstall_visual_cpp_2022_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -355,7 +404,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for .NET 4.0
-  if (is_dotnet_installed("Microsoft .NET Framework 4 Extended", "Microsoft .NET Framework 4 Extended"))
+  if (is_dotnet_installed(registry, UninstallerDotNet4, "Microsoft .NET Framework 4 Extended"))
   {
     Gtk::Image* reinstall_dotnet4_image = Gtk::manage(new Gtk::Image());
     reinstall_dotnet4_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -371,7 +420,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for .NET 4.5.2
-  if (is_dotnet_installed("{92FB6C44-E685-45AD-9B20-CADF4CABA132}", "Microsoft .NET Framework 4.5.2"))
+  if (is_dotnet_installed(registry, UninstallerDotNet45, "Microsoft .NET Framework 4.5.2"))
   {
     Gtk::Image* reinstall_dotnet4_5_2_image = Gtk::manage(new Gtk::Image());
     reinstall_dotnet4_5_2_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -387,7 +436,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for .NET 4.7.2
-  if (is_dotnet_installed("{92FB6C44-E685-45AD-9B20-CADF4CABA132} - 1033", "Microsoft .NET Framework 4.7.2"))
+  if (is_dotnet_installed(registry, UninstallerDotNet47, "Microsoft .NET Framework 4.7.2"))
   {
     Gtk::Image* reinstall_dotnet4_7_2_image = Gtk::manage(new Gtk::Image());
     reinstall_dotnet4_7_2_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -403,7 +452,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for .NET 4.8
-  if (is_dotnet_installed("{92FB6C44-E685-45AD-9B20-CADF4CABA132} - 1033", "Microsoft .NET Framework 4.8"))
+  if (is_dotnet_installed(registry, UninstallerDotNet47, "Microsoft .NET Framework 4.8"))
   {
     Gtk::Image* reinstall_dotnet4_8_image = Gtk::manage(new Gtk::Image());
     reinstall_dotnet4_8_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -419,7 +468,7 @@ void BottleConfigureWindow::update_installed()
   }
 
   // Check for .NET 6.0 LTS
-  if (is_dotnet_6_installed())
+  if (is_dotnet_6_installed(registry))
   {
     Gtk::Image* reinstall_dotnet6_image = Gtk::manage(new Gtk::Image());
     reinstall_dotnet6_image->set_from_icon_name("view-refresh", Gtk::IconSize(Gtk::ICON_SIZE_LARGE_TOOLBAR));
@@ -439,9 +488,10 @@ void BottleConfigureWindow::update_installed()
 
 /**
  * \brief Check is D3DX9 (DirectX 9 OpenGL) is installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_d3dx9_installed()
+bool BottleConfigureWindow::is_d3dx9_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -450,7 +500,7 @@ bool BottleConfigureWindow::is_d3dx9_installed()
     try
     {
       // Check if DLL is set to 'native' load order
-      is_installed = Helper::get_dll_override(wine_prefix, "*d3dx9_43");
+      is_installed = Helper::get_dll_override(registry, wine_prefix, DllD3dx9);
     }
     catch (const std::runtime_error& error)
     {
@@ -462,9 +512,10 @@ bool BottleConfigureWindow::is_d3dx9_installed()
 
 /**
  * \brief Check is DXVK (Vulkan based DirectX 9/10/11) is installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_dxvk_installed()
+bool BottleConfigureWindow::is_dxvk_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -473,7 +524,7 @@ bool BottleConfigureWindow::is_dxvk_installed()
     try
     {
       // Check if DLL is set to 'native' load order
-      is_installed = Helper::get_dll_override(wine_prefix, "*dxgi");
+      is_installed = Helper::get_dll_override(registry, wine_prefix, DllDxgi);
     }
     catch (const std::runtime_error& error)
     {
@@ -485,9 +536,10 @@ bool BottleConfigureWindow::is_dxvk_installed()
 
 /**
  * \brief Check is VKD3D (Vulkan based DirectX 12) is installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_vkd3d_installed()
+bool BottleConfigureWindow::is_vkd3d_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -496,7 +548,7 @@ bool BottleConfigureWindow::is_vkd3d_installed()
     try
     {
       // Check if DLL is set to 'native' load order
-      is_installed = Helper::get_dll_override(wine_prefix, "*d3d12");
+      is_installed = Helper::get_dll_override(registry, wine_prefix, DllD3d12);
     }
     catch (const std::runtime_error& error)
     {
@@ -509,9 +561,10 @@ bool BottleConfigureWindow::is_vkd3d_installed()
 /**
  * \brief Check if Liberation fonts are installed
  * As fallback: Wine is looking for the liberation font on the local unix system (in the /usr/share/fonts/.. directory)
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_liberation_installed()
+bool BottleConfigureWindow::is_liberation_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -520,7 +573,7 @@ bool BottleConfigureWindow::is_liberation_installed()
     BottleTypes::Bit bit = active_bottle_->bit();
     try
     {
-      string fontFilename = Helper::get_font_filename(wine_prefix, bit, "Liberation Mono (TrueType)");
+      string fontFilename = Helper::get_font_filename(registry, wine_prefix, bit, FontLiberationMono);
       is_installed = (fontFilename == "liberationmono-regular.ttf");
     }
     catch (const std::runtime_error& error)
@@ -533,9 +586,10 @@ bool BottleConfigureWindow::is_liberation_installed()
 
 /**
  * \brief Check if MS Core fonts are installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_core_fonts_installed()
+bool BottleConfigureWindow::is_core_fonts_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -544,7 +598,7 @@ bool BottleConfigureWindow::is_core_fonts_installed()
     BottleTypes::Bit bit = active_bottle_->bit();
     try
     {
-      string fontFilename = Helper::get_font_filename(wine_prefix, bit, "Comic Sans MS (TrueType)");
+      string fontFilename = Helper::get_font_filename(registry, wine_prefix, bit, FontComicSans);
       is_installed = (fontFilename == "comic.ttf");
     }
     catch (const std::runtime_error& error)
@@ -557,9 +611,10 @@ bool BottleConfigureWindow::is_core_fonts_installed()
 
 /**
  * \brief Check if MS Visual C++ 2013 installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_visual_cpp_2013_installed()
+bool BottleConfigureWindow::is_visual_cpp_2013_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -568,18 +623,18 @@ bool BottleConfigureWindow::is_visual_cpp_2013_installed()
     try
     {
       // Check if DLL is set to 'native, builtin' load order
-      bool is_dll_override = Helper::get_dll_override(wine_prefix, "*msvcp120", DLLOverride::LoadOrder::NativeBuiltin);
+      bool is_dll_override = Helper::get_dll_override(registry, wine_prefix, DllMsvcp120, DLLOverride::LoadOrder::NativeBuiltin);
       if (is_dll_override)
       {
         // Next, check if package can be found to be uninstalled
-        string name = Helper::get_uninstaller(wine_prefix, "{61087a79-ac85-455c-934d-1fa22cc64f36}");
+        string name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2013);
         // Strings has last occurrence
         is_installed = (name.rfind("Microsoft Visual C++ 2013 Redistributable") == 0);
 
         // Try the 64-bit package (fallback)
         if (!is_installed)
         {
-          name = Helper::get_uninstaller(wine_prefix, "{ef6b00ec-13e1-4c25-9064-b2f383cb8412}");
+          name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2013x64);
           is_installed = (name.rfind("Microsoft Visual C++ 2013 Redistributable") == 0);
         }
       }
@@ -598,9 +653,10 @@ bool BottleConfigureWindow::is_visual_cpp_2013_installed()
 
 /**
  * \brief Check if MS Visual C++ 2015 installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_visual_cpp_2015_installed()
+bool BottleConfigureWindow::is_visual_cpp_2015_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -609,18 +665,18 @@ bool BottleConfigureWindow::is_visual_cpp_2015_installed()
     try
     {
       // Check if DLL is set to 'native, builtin' load order
-      bool is_dll_override = Helper::get_dll_override(wine_prefix, "*msvcp140", DLLOverride::LoadOrder::NativeBuiltin);
+      bool is_dll_override = Helper::get_dll_override(registry, wine_prefix, DllMsvcp140, DLLOverride::LoadOrder::NativeBuiltin);
       if (is_dll_override)
       {
         // Next, check if package can be found to be uninstalled
-        string name = Helper::get_uninstaller(wine_prefix, "{462f63a8-6347-4894-a1b3-dbfe3a4c981d}");
+        string name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2015);
         // Strings has last occurrence
         is_installed = (name.rfind("Microsoft Visual C++ 2015 Redistributable") == 0);
 
         // Try the 64-bit package (fallback)
         if (!is_installed)
         {
-          name = Helper::get_uninstaller(wine_prefix, "{F20396E5-D84E-3505-A7A8-7358F0155F6C}");
+          name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2015x64);
           is_installed = (name.rfind("Microsoft Visual C++ 2015 Redistributable") == 0);
         }
       }
@@ -639,9 +695,10 @@ bool BottleConfigureWindow::is_visual_cpp_2015_installed()
 
 /**
  * \brief Check if MS Visual C++ 2017 installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_visual_cpp_2017_installed()
+bool BottleConfigureWindow::is_visual_cpp_2017_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -650,18 +707,18 @@ bool BottleConfigureWindow::is_visual_cpp_2017_installed()
     try
     {
       // Check if DLL is set to 'native, builtin' load order
-      bool is_dll_override = Helper::get_dll_override(wine_prefix, "*msvcp140", DLLOverride::LoadOrder::NativeBuiltin);
+      bool is_dll_override = Helper::get_dll_override(registry, wine_prefix, DllMsvcp140, DLLOverride::LoadOrder::NativeBuiltin);
       if (is_dll_override)
       {
         // Next, check if package can be found to be uninstalled
-        string name = Helper::get_uninstaller(wine_prefix, "{624ba875-fdfc-4efa-9c66-b170dfebc3ec}");
+        string name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2017);
         // Strings has last occurrence
         is_installed = (name.rfind("Microsoft Visual C++ 2017 Redistributable") == 0);
 
         // Try the 64-bit package (fallback)
         if (!is_installed)
         {
-          name = Helper::get_uninstaller(wine_prefix, "{65835E57-3712-4382-990A-8D39008A8E0B}");
+          name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2017x64);
           is_installed = (name.rfind("Microsoft Visual C++ 2017") == 0);
         }
       }
@@ -680,9 +737,10 @@ bool BottleConfigureWindow::is_visual_cpp_2017_installed()
 
 /**
  * \brief Check if MS Visual C++ 2019 installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_visual_cpp_2019_installed()
+bool BottleConfigureWindow::is_visual_cpp_2019_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -691,18 +749,18 @@ bool BottleConfigureWindow::is_visual_cpp_2019_installed()
     try
     {
       // Check if DLL is set to 'native, builtin' load order
-      bool is_dll_override = Helper::get_dll_override(wine_prefix, "*msvcp140", DLLOverride::LoadOrder::NativeBuiltin);
+      bool is_dll_override = Helper::get_dll_override(registry, wine_prefix, DllMsvcp140, DLLOverride::LoadOrder::NativeBuiltin);
       if (is_dll_override)
       {
         // Next, check if package can be found to be uninstalled
-        string name = Helper::get_uninstaller(wine_prefix, "{e3aefa8b-a2ea-42b8-a384-95f2ff6df681}");
+        string name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2019);
         // Strings has last occurrence
         is_installed = (name.rfind("Microsoft Visual C++ 2015-2019 Redistributable") == 0);
 
         // Try the 64-bit package (fallback)
         if (!is_installed)
         {
-          name = Helper::get_uninstaller(wine_prefix, "{0F03096E-F81F-48D0-AEE0-9F8513CD883F}");
+          name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2019x64);
           is_installed = (name.rfind("Microsoft Visual C++ 2019") == 0);
         }
       }
@@ -721,9 +779,10 @@ bool BottleConfigureWindow::is_visual_cpp_2019_installed()
 
 /**
  * \brief Check if MS Visual C++ 2022 installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_visual_cpp_2022_installed()
+bool BottleConfigureWindow::is_visual_cpp_2022_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -732,18 +791,18 @@ bool BottleConfigureWindow::is_visual_cpp_2022_installed()
     try
     {
       // Check if DLL is set to 'native, builtin' load order
-      bool is_dll_override = Helper::get_dll_override(wine_prefix, "*msvcp140", DLLOverride::LoadOrder::NativeBuiltin);
+      bool is_dll_override = Helper::get_dll_override(registry, wine_prefix, DllMsvcp140, DLLOverride::LoadOrder::NativeBuiltin);
       if (is_dll_override)
       {
         // Next, check if package can be found to be uninstalled
-        string name = Helper::get_uninstaller(wine_prefix, "{2cfeba4a-21f8-4ea7-9927-c5a5c6f13cc9}");
+        string name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2022);
         // Strings has last occurrence
         is_installed = (name.rfind("Microsoft Visual C++ 2015-2022 Redistributable") == 0);
 
         // Try the 64-bit package (fallback)
         if (!is_installed)
         {
-          name = Helper::get_uninstaller(wine_prefix, "{1CA7421F-A225-4A9C-B320-A36981A2B789}");
+          name = Helper::get_uninstaller(registry, wine_prefix, UninstallerVisualCpp2022x64);
           is_installed = (name.rfind("Microsoft Visual C++ 2022") == 0);
         }
       }
@@ -763,11 +822,12 @@ bool BottleConfigureWindow::is_visual_cpp_2022_installed()
 /**
  * \brief Check if MS .NET is installed using the uninstaller key & display name.
  * Note: Can not be used to check for .NET 6
+ * \param[in] registry Executed registry query
  * \param[in] uninstaller_key The uninstaller register key
  * \param[in] uninstaller_name The uninstaller display name
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_dotnet_installed(const string& uninstaller_key, const string& uninstaller_name)
+bool BottleConfigureWindow::is_dotnet_installed(const RegistryQuery& registry, const string& uninstaller_key, const string& uninstaller_name)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -776,11 +836,11 @@ bool BottleConfigureWindow::is_dotnet_installed(const string& uninstaller_key, c
     try
     {
       // Check if DLL is set to 'native' load order
-      bool is_dll_override = Helper::get_dll_override(wine_prefix, "*mscoree");
+      bool is_dll_override = Helper::get_dll_override(registry, wine_prefix, DllMscoree);
       if (is_dll_override)
       {
         // Next, check if package can be found to be uninstalled
-        string name = Helper::get_uninstaller(wine_prefix, uninstaller_key);
+        string name = Helper::get_uninstaller(registry, wine_prefix, uninstaller_key);
         // Check the display name
         is_installed = (name == uninstaller_name);
       }
@@ -799,9 +859,10 @@ bool BottleConfigureWindow::is_dotnet_installed(const string& uninstaller_key, c
 
 /**
  * \brief Check if MS .NET v6 is installed
+ * \param[in] registry Executed registry query
  * \return True if installed otherwise False
  */
-bool BottleConfigureWindow::is_dotnet_6_installed()
+bool BottleConfigureWindow::is_dotnet_6_installed(const RegistryQuery& registry)
 {
   bool is_installed = false;
   if (active_bottle_ != nullptr)
@@ -810,13 +871,13 @@ bool BottleConfigureWindow::is_dotnet_6_installed()
     try
     {
       // Check if package can be found to be uninstalled
-      string name = Helper::get_uninstaller(wine_prefix, "{5DEFBDBE-FF1A-4EB2-8DFB-17A26A7E6442}");
+      string name = Helper::get_uninstaller(registry, wine_prefix, UninstallerDotNet6);
       // Strings has first occurrence of display name
       is_installed = (name.find("Microsoft .NET Runtime - 6") == 0);
       // Try the 64-bit package (fallback)
       if (!is_installed)
       {
-        name = Helper::get_uninstaller(wine_prefix, "{3CC763AD-93B3-41EF-ABF8-CFE63A1DC3A6}");
+        name = Helper::get_uninstaller(registry, wine_prefix, UninstallerDotNet6x64);
         // Strings has first occurrence of display name
         is_installed = (name.find("Microsoft .NET Runtime - 6") == 0);
       }
@@ -19,7 +19,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "bottle_edit_window.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
 #include "wine_defaults.h"
 
 /**
@@ -234,7 +234,7 @@ void BottleEditWindow::show()
  * \brief Signal handler when a new bottle is set in the main window
  * \param[in] bottle - New bottle
  */
-void BottleEditWindow::set_active_bottle(BottleItem* bottle)
+void BottleEditWindow::set_active_bottle(BottleRecord* bottle)
 {
   active_bottle_ = bottle;
 }
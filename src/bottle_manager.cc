@@ -20,17 +20,40 @@
  */
 #include "bottle_manager.h"
 #include "bottle_config_file.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
+#include "bottle_snapshot.h"
 #include "dll_override_types.h"
 #include "general_config_file.h"
 #include "helper.h"
+#include "startup_profiler.h"
 #include "main_window.h"
+#include "registry_query.h"
+#include "registry_writer.h"
 #include "signal_controller.h"
 #include "wine_defaults.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
 
+//// Maximum number of threads used to inspect the bottles, more threads don't help since the storage is the bottleneck
+static const std::size_t MaxInspectionThreads = 8;
+//// Number of rows above and below the selected bottle, of which the details are prefetched
+static const std::size_t PrefetchDetailsRows = 2;
+//// Output lines of the running programs kept in memory (for the console window), the oldest lines are dropped
+static const std::size_t ConsoleMaxLines = 10000;
+//// Total size of the output lines kept in memory
+static const std::size_t ConsoleMaxBytes = 4 * 1024 * 1024;
+//// Maximum size of the log file of a bottle, the log file is rotated when it's exceeded
+static const std::size_t LogMaxFileSize = 10 * 1024 * 1024;
+//// Number of rotated log files kept per bottle
+static const int LogGenerations = 3;
+//// Maximum size of the log lines that are not yet written (of all bottles), further lines are dropped
+static const std::size_t LogMaxPendingBytes = 1024 * 1024;
+
 /*************************************************************
  * Public member functions                                   *
  *************************************************************/
@@ -41,20 +64,32 @@
  */
 BottleManager::BottleManager(MainWindow& main_window)
     : error_message_mutex_(),
-      output_loging_mutex_(),
       error_message_winetricks_mutex_(),
+      is_load_bottles_cancelled_(false),
+      is_all_bottles_loaded_(false),
+      is_load_details_running_(false),
       main_window_(main_window),
       active_bottle_(nullptr),
       is_wine64_bit_(false),
       is_logging_stderr_(true),
+      bottles_generation_(0),
+      is_background_load_(false),
+      console_buffer_(ConsoleMaxLines, ConsoleMaxBytes),
+      log_writer_(log_compressor_, LogMaxFileSize, LogGenerations, LogMaxPendingBytes),
       error_message_(),
       error_message_winetricks_()
 {
   // Connect internal dispatcher(s)
   update_bottles_dispatcher_.connect(sigc::bind(sigc::mem_fun(this, &BottleManager::update_config_and_bottles), "", false));
-  write_log_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::write_log_to_file));
   error_message_winetricks_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_error_winetricks));
   winetricks_finished_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::cleanup_install_update_winetricks_thread));
+  bottles_loaded_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_bottles_loaded));
+  details_loaded_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_bottle_details_loaded));
+  log_decompressed_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_log_decompressed));
+  // Changes outside WineGUI (debounced)
+  bottle_watcher_.bottle_list_changed.connect(sigc::mem_fun(this, &BottleManager::on_bottle_list_changed));
+  bottle_watcher_.bottles_changed.connect(sigc::mem_fun(this, &BottleManager::update_bottles));
+  bottle_watcher_.desktop_files_changed.connect(sigc::mem_fun(main_window_, &MainWindow::on_refresh_app_list_button_clicked));
 }
 
 /**
@@ -62,8 +97,15 @@ BottleManager::BottleManager(MainWindow& main_window)
  */
 BottleManager::~BottleManager()
 {
-  // Avoid zombie thread
+  // Avoid zombie threads
   this->cleanup_install_update_winetricks_thread();
+  this->cancel_load_bottles_thread();
+  {
+    std::lock_guard<std::mutex> lock(load_details_mutex_);
+    details_requests_.clear();
+  }
+  if (thread_load_details_ && thread_load_details_->joinable())
+    thread_load_details_->join();
 }
 
 /**
@@ -82,28 +124,18 @@ void BottleManager::prepare()
     install_or_update_winetricks_thread(false);
   }
 
-  // Start the initial read from disk to fetch the bottles & update GUI
+  // Bottle details of the previous run, only changed bottles are read again
+  {
+    StartupProfiler::Scope scope("Load bottle snapshot");
+    bottle_snapshot_.load(get_snapshot_file_path());
+  }
+
+  // Start the initial read from disk to fetch the bottles & update GUI (the bottles are inspected in a thread)
   // "" - during startup (no bottle name to select)
   // true - during startup
-  // TODO: Run in thread, not blocking the main thread
   update_config_and_bottles("", true);
 }
 
-/**
- * \brief Write debugging logging to file handler
- */
-void BottleManager::write_log_to_file()
-{
-  std::lock_guard<std::mutex> lock(error_message_mutex_);
-  char last_char = output_logging_.back();
-  // Needs new line at end of string?
-  if (last_char != '\n')
-  {
-    output_logging_ += '\n';
-  }
-  Helper::write_to_log_file(logging_bottle_prefix_, output_logging_);
-}
-
 /**
  * \brief Helper method for cleaning the winetricks thread.
  */
@@ -141,6 +173,7 @@ void BottleManager::install_or_update_winetricks_thread(bool install)
     thread_install_update_winetricks_ = std::make_unique<std::thread>(
         [this, install]
         {
+          StartupProfiler::Scope scope("Install/update Winetricks");
           try
           {
             if (install)
@@ -171,28 +204,47 @@ void BottleManager::install_or_update_winetricks_thread(bool install)
 }
 
 /**
- * \brief Update WineGUI Config and update bottles by reading the Wine Bottles from disk and update GUI
+ * \brief Update WineGUI Config and update bottles by reading the Wine Bottles from disk and update GUI.
+ * The bottle list is reconciled on prefix path: only new bottles are added (as placeholder), removed bottles are removed and
+ * the existing bottles (incl. their widgets) are kept. All bottles are inspected in a thread and only the changed rows are
+ * updated (see on_bottles_loaded()).
  * \param select_bottle_name If set, try to find the bottle with this name and set it as active bottle (used for newly created bottles)
  * \param is_startup Set to true if this function is called during start-up, otherwise false
  */
 void BottleManager::update_config_and_bottles(const Glib::ustring& select_bottle_name, bool is_startup)
 {
-  // Read general & save config in bottle manager
-  GeneralConfigData config_data = load_and_save_general_config();
-  // Set/update main window about the latest general config data
-  main_window_.set_general_config(config_data);
+  load_config_and_bottles(select_bottle_name, is_startup, false);
+}
+
+/**
+ * \brief Signal handler when a bottle is added or removed outside WineGUI (or during a bottle creation)
+ */
+void BottleManager::on_bottle_list_changed()
+{
+  load_config_and_bottles("", false, true);
+}
 
-  bool try_to_restore = (active_bottle_ != nullptr);
-  if (try_to_restore)
+/**
+ * \brief Update WineGUI Config and reconcile the bottle list, see update_config_and_bottles()
+ * \param select_bottle_name If set, select this bottle once loaded
+ * \param is_startup Set to true if this function is called during start-up, otherwise false
+ * \param is_background Set to true for a refresh that is not requested by the user, errors are logged instead of shown
+ */
+void BottleManager::load_config_and_bottles(const Glib::ustring& select_bottle_name, bool is_startup, bool is_background)
+{
+  // Stop the previous load (if still running), those results are outdated
+  cancel_load_bottles_thread();
   {
-    previous_active_bottle_index_ = active_bottle_->get_index();
-    // Save the current bottle list size
-    previous_bottles_list_size_ = bottles_.size();
+    std::lock_guard<std::mutex> lock(load_details_mutex_);
+    details_requests_.clear();
   }
+  bottles_generation_++;
+  pending_update_prefixes_.clear();
 
-  // Clear bottles
-  if (!bottles_.empty())
-    bottles_.clear();
+  // Read general & save config in bottle manager
+  GeneralConfigData config_data = load_and_save_general_config();
+  // Set/update main window about the latest general config data
+  main_window_.set_general_config(config_data);
 
   // Get the bottle directories
   std::vector<string> bottle_dirs;
@@ -202,81 +254,105 @@ void BottleManager::update_config_and_bottles(const Glib::ustring& select_bottle
   }
   catch (const std::runtime_error& error)
   {
+    StartupProfiler::milestone(StartupProfiler::BottlesLoaded);
     main_window_.show_error_message(error.what());
     return; // stop
   }
 
-  if (bottle_dirs.size() > 0)
+  // Row position of the active bottle, used when the active bottle is removed (eg. renamed)
+  std::size_t previous_active_bottle_index = std::string::npos;
+  string active_prefix;
+  if (active_bottle_ != nullptr)
   {
-    try
+    previous_active_bottle_index = static_cast<std::size_t>(active_bottle_ - bottles_.data());
+    active_prefix = active_bottle_->wine_location().raw();
+  }
+  active_bottle_ = nullptr;
+
+  // Reconcile the bottle list on prefix path, in the same (sorted) order as the bottle directories
+  std::map<string, std::size_t> current_bottles;
+  for (std::size_t index = 0; index < bottles_.size(); index++)
+    current_bottles.emplace(bottles_[index].wine_location().raw(), index);
+  std::vector<BottleRecord> bottles;
+  bottles.reserve(bottle_dirs.size());
+  for (const string& prefix : bottle_dirs)
+  {
+    auto current = current_bottles.find(prefix);
+    if (current != current_bottles.end())
     {
-      // Create wine bottles from bottle directories and wine version
-      bottles_ = create_wine_bottles(bottle_dirs);
+      // Existing bottle, keep the data (it's updated once it is inspected again)
+      bottles.push_back(std::move(bottles_[current->second]));
     }
-    catch (const std::runtime_error& error)
+    else
     {
-      main_window_.show_error_message(error.what());
-      return; // stop
+      // New bottle, placeholder row
+      bottles.emplace_back(Glib::path_get_basename(prefix), prefix);
     }
+  }
+  // Remaining bottles are removed
+  bottles_.swap(bottles);
+  bottles.clear();
+  auto active = std::find_if(bottles_.begin(), bottles_.end(), [&active_prefix](const BottleRecord& bottle)
+                             { return !active_prefix.empty() && bottle.wine_location().raw() == active_prefix; });
+  if (active != bottles_.end())
+    active_bottle_ = &(*active);
+  // Only new bottles get a file monitor, monitors of removed bottles are removed
+  bottle_watcher_.watch(bottle_location_, bottle_dirs);
+
+  // Update main Window (also when there are no bottles, to remove the rows)
+  main_window_.set_wine_bottles(bottles_);
+
+  if (bottles_.empty())
+  {
+    // Send reset signal to reset the active bottle to NULL
+    reset_active_bottle.emit();
+    // Reset locally
+    active_bottle_ = nullptr;
+    StartupProfiler::milestone(StartupProfiler::BottlesLoaded);
+    return;
+  }
 
-    if (!bottles_.empty())
+  // Is select_bottle_name set? The name is only known after the bottle is loaded
+  select_bottle_name_ = select_bottle_name;
+  if (select_bottle_name_.empty())
+  {
+    // The active bottle still exists? Then the row is still selected.
+    if (active_bottle_ == nullptr && previous_active_bottle_index != std::string::npos)
     {
-      // Update main Window
-      main_window_.set_wine_bottles(bottles_);
-
-      // Is select_bottle_name set?
-      if (!select_bottle_name.empty())
-      {
-        // Check if there is a bottle with the same name and select as active bottle
-        auto it = std::find_if(bottles_.begin(), bottles_.end(),
-                               [&select_bottle_name](const BottleItem& bottle) { return bottle.name() == select_bottle_name; });
-        if (it != bottles_.end())
-        {
-          main_window_.select_row_bottle(*it);
-          active_bottle_ = &(*it);
-        }
-      }
-      // Is try_to_restore boolean true?
-      // And: Is the bottle list size the same?
-      // And: Is the previous index not bigger than the list size?
-      else if (try_to_restore && (bottles_.size() == previous_bottles_list_size_) && ((size_t)previous_active_bottle_index_ < bottles_.size()))
-      {
-        // Let's reset the previous state!
-        auto front = bottles_.begin();
-        std::advance(front, previous_active_bottle_index_);
-        main_window_.select_row_bottle(*front);
-        // Set active bottle at the previous index
-        active_bottle_ = &(*front);
-      }
-      else
-      {
-        // Default behaviour: Bottle list is changed, let's set the first bottle in the detailed info panel.
-        // begin() gives us an iterator with the first element
-        auto first = bottles_.begin();
-        // Trigger select row, except during start-up (show_all will auto-select the first listbox item in GTK)
-        if (!is_startup)
-          main_window_.select_row_bottle(*first);
-        // Set active bottle at the first
-        active_bottle_ = &(*first);
-      }
+      // Active bottle is removed (or renamed), select the bottle at the same position
+      std::size_t index = std::min(previous_active_bottle_index, bottles_.size() - 1);
+      main_window_.select_row_bottle(index);
+      active_bottle_ = &bottles_[index];
     }
-    else
+    else if (active_bottle_ == nullptr)
     {
-      main_window_.show_error_message("Could not create an overview of Windows Machines. Empty list.");
-
-      // Send reset signal to reset the active bottle to NULL
-      reset_active_bottle.emit();
-      // Reset locally
-      active_bottle_ = nullptr;
+      // Default behaviour: No bottle was selected, let's set the first bottle in the detailed info panel.
+      // Trigger select row, except during start-up (show_all will auto-select the first listbox item in GTK)
+      if (!is_startup)
+        main_window_.select_row_bottle(0);
+      // Set active bottle at the first
+      active_bottle_ = &bottles_.front();
     }
   }
   else
   {
-    // Send reset signal to reset the active bottle to NULL
-    reset_active_bottle.emit();
-    // Reset locally
-    active_bottle_ = nullptr;
+    // Is there an existing bottle with the same name?
+    auto it = std::find_if(bottles_.begin(), bottles_.end(),
+                           [&select_bottle_name](const BottleRecord& bottle) { return !bottle.is_loading() && bottle.name() == select_bottle_name; });
+    if (it != bottles_.end())
+    {
+      main_window_.select_row_bottle(static_cast<std::size_t>(it - bottles_.begin()));
+      active_bottle_ = &(*it);
+      select_bottle_name_.clear();
+    }
   }
+
+  bottle_dirs_ = bottle_dirs;
+  bottle_inspections_.clear();
+  bottle_inspections_.resize(bottle_dirs.size());
+  std::vector<std::size_t> indices(bottle_dirs.size());
+  std::iota(indices.begin(), indices.end(), 0);
+  load_bottles_thread(indices, true, is_background);
 }
 
 /**
@@ -360,11 +436,12 @@ void BottleManager::new_bottle(SignalController* caller,
   // Continue with additional settings
   if (bottle_created)
   {
+    // All settings are written at once, afterwards
+    RegistryWriter registry;
     // Always set the Windows Version (we do not know which Wine version the user is using)
-    // Only change Windows OS when NOT default
     try
     {
-      Helper::set_windows_version(prefix_path, windows_version);
+      Helper::set_windows_version(registry, prefix_path, windows_version);
     }
     catch (const std::runtime_error& error)
     {
@@ -381,7 +458,7 @@ void BottleManager::new_bottle(SignalController* caller,
     {
       try
       {
-        Helper::set_virtual_desktop(prefix_path, virtual_desktop_resolution);
+        Helper::set_virtual_desktop(registry, prefix_path, virtual_desktop_resolution);
       }
       catch (const std::runtime_error& error)
       {
@@ -397,19 +474,23 @@ void BottleManager::new_bottle(SignalController* caller,
     // Only if Audio driver is not default, change it
     if (audio != WineDefaults::AudioDriver)
     {
-      try
-      {
-        Helper::set_audio_driver(prefix_path, audio);
-      }
-      catch (const std::runtime_error& error)
+      Helper::set_audio_driver(registry, prefix_path, audio);
+    }
+
+    // Wineboot keeps the wineserver running for a moment, after that the registry files can be changed directly
+    Helper::wait_until_wineserver_is_terminated(prefix_path);
+    try
+    {
+      Helper::apply_registry_changes(is_wine64_bit_, prefix_path, registry);
+    }
+    catch (const std::runtime_error& error)
+    {
       {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during setting another audio driver.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_create();
-        return; // Stop thread prematurely
+        std::lock_guard<std::mutex> lock(error_message_mutex_);
+        error_message_ = ("Something went wrong during changing the Windows machine settings.\n" + Glib::ustring(error.what()));
       }
+      caller->signal_error_message_during_create();
+      return; // Stop thread prematurely
     }
   }
 
@@ -423,6 +504,7 @@ void BottleManager::new_bottle(SignalController* caller,
 /**
  * \brief Update existing Wine bottle (runs in thread)
  * \param[in] caller                      Signal Dispatcher pointer, in order to signal back events
+ * \param[in] bottle                      Copy of the active bottle, see begin_update_bottle()
  * \param[in] name                        Bottle Name
  * \param[in] folder_name                 Bottle Folder Name
  * \param[in] description                 Description text
@@ -433,6 +515,7 @@ void BottleManager::new_bottle(SignalController* caller,
  * \param[in] debug_log_level             Bottle Debug Log Level
  */
 void BottleManager::update_bottle(SignalController* caller,
+                                  const std::optional<BottleRecord>& bottle,
                                   const Glib::ustring& name,
                                   const Glib::ustring& folder_name,
                                   const Glib::ustring& description,
@@ -442,30 +525,30 @@ void BottleManager::update_bottle(SignalController* caller,
                                   bool is_debug_logging,
                                   int debug_log_level)
 {
-  if (active_bottle_ != nullptr)
+  if (bottle)
   {
-    string prefix_path = active_bottle_->wine_location();
+    string prefix_path = bottle->wine_location();
 
     bool need_update_bottle_config_file = false;
     BottleConfigData bottle_config;
     std::map<int, ApplicationData> app_list; // App list is never dirty, so no need to check
     std::tie(bottle_config, app_list) = BottleConfigFile::read_config_file(prefix_path);
-    if (active_bottle_->name() != name)
+    if (bottle->name() != name)
     {
       bottle_config.name = name;
       need_update_bottle_config_file = true;
     }
-    if (active_bottle_->description() != description)
+    if (bottle->description() != description)
     {
       bottle_config.description = description;
       need_update_bottle_config_file = true;
     }
-    if (active_bottle_->is_debug_logging() != is_debug_logging)
+    if (bottle->is_debug_logging() != is_debug_logging)
     {
       bottle_config.logging_enabled = is_debug_logging;
       need_update_bottle_config_file = true;
     }
-    if (active_bottle_->debug_log_level() != debug_log_level)
+    if (bottle->debug_log_level() != debug_log_level)
     {
       bottle_config.debug_log_level = debug_log_level;
       need_update_bottle_config_file = true;
@@ -480,11 +563,13 @@ void BottleManager::update_bottle(SignalController* caller,
       }
     }
 
-    if (active_bottle_->windows() != windows_version)
+    // All changed settings are written at once
+    RegistryWriter registry;
+    if (bottle->windows() != windows_version)
     {
       try
       {
-        Helper::set_windows_version(prefix_path, windows_version);
+        Helper::set_windows_version(registry, prefix_path, windows_version);
       }
       catch (const std::runtime_error& error)
       {
@@ -497,13 +582,13 @@ void BottleManager::update_bottle(SignalController* caller,
       }
     }
 
-    if (active_bottle_->virtual_desktop() != virtual_desktop_resolution)
+    if (bottle->virtual_desktop() != virtual_desktop_resolution)
     {
       if (!virtual_desktop_resolution.empty())
       {
         try
         {
-          Helper::set_virtual_desktop(prefix_path, virtual_desktop_resolution);
+          Helper::set_virtual_desktop(registry, prefix_path, virtual_desktop_resolution);
         }
         catch (const std::runtime_error& error)
         {
@@ -517,36 +602,26 @@ void BottleManager::update_bottle(SignalController* caller,
       }
       else
       {
-        try
-        {
-          Helper::disable_virtual_desktop(prefix_path);
-        }
-        catch (const std::runtime_error& error)
-        {
-          {
-            std::lock_guard<std::mutex> lock(error_message_mutex_);
-            error_message_ = ("Something went wrong during disabling virtual desktop mode.\n" + Glib::ustring(error.what()));
-          }
-          caller->signal_error_message_during_update();
-          return; // Stop thread prematurely
-        }
+        Helper::disable_virtual_desktop(registry, prefix_path);
       }
     }
-    if (active_bottle_->audio_driver() != audio)
+    if (bottle->audio_driver() != audio)
+    {
+      Helper::set_audio_driver(registry, prefix_path, audio);
+    }
+
+    try
+    {
+      Helper::apply_registry_changes(is_wine64_bit_, prefix_path, registry);
+    }
+    catch (const std::runtime_error& error)
     {
-      try
-      {
-        Helper::set_audio_driver(prefix_path, audio);
-      }
-      catch (const std::runtime_error& error)
       {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during setting another audio driver.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_update();
-        return; // Stop thread prematurely
+        std::lock_guard<std::mutex> lock(error_message_mutex_);
+        error_message_ = ("Something went wrong during changing the Windows machine settings.\n" + Glib::ustring(error.what()));
       }
+      caller->signal_error_message_during_update();
+      return; // Stop thread prematurely
     }
 
     // Wait until wineserver terminates
@@ -554,7 +629,7 @@ void BottleManager::update_bottle(SignalController* caller,
 
     // LAST but not least, rename Wine bottle folder
     // Do this after the wait on wineserver, since otherwise renaming may break the Wine installation during update
-    if (active_bottle_->folder_name() != folder_name)
+    if (bottle->folder_name() != folder_name)
     {
       // Build new prefix
       std::vector<string> dirs{bottle_location_, folder_name};
@@ -588,6 +663,32 @@ void BottleManager::update_bottle(SignalController* caller,
   caller->signal_bottle_updated();
 }
 
+/**
+ * \brief Prepare the update of the active bottle (runs in GUI thread, before the update thread is started).
+ * The bottle is copied, since the bottle list can change during the update (eg. the bottle watcher inspects the bottles again).
+ * File changes of the bottle are ignored until end_update_bottle(), the update itself writes those files.
+ * \return Copy of the active bottle, empty when there is no active bottle
+ */
+std::optional<BottleRecord> BottleManager::begin_update_bottle()
+{
+  if (active_bottle_ == nullptr)
+    return std::nullopt;
+  updating_bottle_prefix_ = active_bottle_->wine_location();
+  bottle_watcher_.mute(updating_bottle_prefix_);
+  return *active_bottle_;
+}
+
+/**
+ * \brief The update thread is finished (runs in GUI thread), file changes of the bottle are no longer ignored
+ */
+void BottleManager::end_update_bottle()
+{
+  if (updating_bottle_prefix_.empty())
+    return;
+  bottle_watcher_.unmute(updating_bottle_prefix_);
+  updating_bottle_prefix_.clear();
+}
+
 /**
  * \brief Clone an existing Wine bottle (runs in thread)
  * \param[in] caller                      Signal Dispatcher pointer, in order to signal back events
@@ -696,7 +797,7 @@ void BottleManager::delete_bottle()
  * \brief Signal handler when the active bottle changes, update active bottle
  * \param[in] bottle - New bottle
  */
-void BottleManager::set_active_bottle(BottleItem* bottle)
+void BottleManager::set_active_bottle(BottleRecord* bottle)
 {
   if (bottle != nullptr)
   {
@@ -704,6 +805,89 @@ void BottleManager::set_active_bottle(BottleItem* bottle)
   }
 }
 
+/**
+ * \brief Signal handler to load the details of the selected bottle (in a thread).
+ * The details of the neighbouring bottles are prefetched as well, the selected bottle goes first.
+ * \param[in] selected_index - Row index of the selected bottle
+ */
+void BottleManager::load_bottle_details(std::size_t selected_index)
+{
+  if (selected_index >= bottles_.size())
+    return; // Not a row of the current bottle list
+
+  bool is_start_thread;
+  {
+    std::lock_guard<std::mutex> lock(load_details_mutex_);
+    // Rows after the selected row are the most likely next selection (eg. arrow down)
+    std::size_t first = selected_index - std::min(selected_index, PrefetchDetailsRows);
+    std::size_t last = std::min(selected_index + PrefetchDetailsRows, bottles_.size() - 1);
+    for (std::size_t index = last + 1; index-- > first;)
+    {
+      BottleInspection& inspection = bottle_inspections_[index];
+      if (!inspection.is_applied || inspection.is_details_loaded || inspection.is_details_requested)
+        continue;
+      inspection.is_details_requested = true;
+      BottleDetailsRequest request{bottles_generation_, index, bottle_dirs_[index], inspection.details};
+      if (index == selected_index)
+        details_requests_.push_front(std::move(request));
+      else
+        details_requests_.push_back(std::move(request));
+    }
+    // The selected bottle was prefetched before, but it is still pending: move it to the front
+    if (bottle_inspections_[selected_index].is_details_requested && !details_requests_.empty() &&
+        details_requests_.front().index != selected_index)
+    {
+      auto it = std::find_if(details_requests_.begin(), details_requests_.end(),
+                             [selected_index](const BottleDetailsRequest& request) { return request.index == selected_index; });
+      if (it != details_requests_.end())
+      {
+        BottleDetailsRequest request = std::move(*it);
+        details_requests_.erase(it);
+        details_requests_.push_front(std::move(request));
+      }
+    }
+    is_start_thread = !is_load_details_running_ && !details_requests_.empty();
+    if (is_start_thread)
+      is_load_details_running_ = true;
+  }
+  if (!is_start_thread)
+    return;
+
+  // The previous thread is finished (or just returning)
+  if (thread_load_details_ && thread_load_details_->joinable())
+    thread_load_details_->join();
+  thread_load_details_ = std::make_unique<std::thread>(
+      [this]
+      {
+        while (true)
+        {
+          BottleDetailsRequest request;
+          {
+            std::lock_guard<std::mutex> lock(load_details_mutex_);
+            if (details_requests_.empty())
+            {
+              is_load_details_running_ = false;
+              return;
+            }
+            request = std::move(details_requests_.front());
+            details_requests_.pop_front();
+          }
+          BottleDetailsResult result{request.generation, request.index, std::move(request.details), {}};
+          read_bottle_details(request.prefix, result.details, result.errors);
+
+          bool is_first_pending;
+          {
+            std::lock_guard<std::mutex> lock(load_details_mutex_);
+            is_first_pending = details_results_.empty();
+            details_results_.push_back(std::move(result));
+          }
+          // Only wake-up the GUI thread once for all the results that are pending
+          if (is_first_pending)
+            details_loaded_dispatcher_.emit();
+        }
+      });
+}
+
 /**
  * \brief Get error message (stored from manager thread)
  * \return Return the error message
@@ -714,6 +898,24 @@ const Glib::ustring& BottleManager::get_error_message() const
   return error_message_;
 }
 
+/**
+ * \brief Get the output lines of the running programs & installs (shown in the console window)
+ * \return Console buffer, lines are added by the program threads
+ */
+ConsoleBuffer& BottleManager::get_console_buffer()
+{
+  return console_buffer_;
+}
+
+/**
+ * \brief Get the programs & installs that are still running (of all bottles)
+ * \return Running jobs
+ */
+std::vector<JobInfo> BottleManager::get_running_jobs() const
+{
+  return process_supervisor_.get_running_jobs();
+}
+
 /**
  * \brief Run an executable (exe) or MSI file in Wine (using the current active bottle)
  * \param[in] program Path of the program (selected by the user)
@@ -723,34 +925,10 @@ void BottleManager::run_executable(string program, bool is_msi_file = false)
 {
   if (is_bottle_not_null())
   {
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program_prefix = is_msi_file ? "msiexec /i" : "start /unix";
     string working_directory = Glib::path_get_dirname(program);
-    // Be-sure to execute the program between quotes (due to spaces)
-    program = program_prefix + " \"" + program + "\"";
-    auto& env_vars = active_bottle_->env_vars();
-
-    std::thread t(
-        [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, program, working_directory, env_vars,
-         logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_]
-        {
-          string output =
-              Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, program, working_directory, env_vars, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-        });
-    t.detach();
+    // The path is passed as a single argument, no quoting needed (no shell)
+    vector<string> argv = is_msi_file ? vector<string>{"msiexec", "/i", program} : vector<string>{"start", "/unix", program};
+    start_job(Glib::path_get_basename(program), {get_job_command(argv, true, working_directory, active_bottle_->env_vars())});
   }
 }
 
@@ -762,70 +940,32 @@ void BottleManager::run_program(string program)
 {
   if (is_bottle_not_null())
   {
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
     // For all programs (except winetricks)
     if (!program.ends_with("winetricks --gui -q"))
     {
       string working_directory = "";
-      // Be-sure to execute the program between quotes (due to spaces).
+      // The program is passed as a single argument, no quoting needed (no shell)
+      vector<string> argv;
       if (program.starts_with("/"))
       {
         // TODO: Provide the user the option whether or not the working directory need to be set.
         // If true, we can use: working_directory = Glib::path_get_dirname(program);
-        // And pass it alone with run_program_under_wine() below.
+        // And pass it alone with get_job_command() below.
 
         // Add 'start /unix' for Unit style command, like application shortcuts
-        program = "start /unix \"" + program + "\"";
+        argv = {"start", "/unix", program};
       }
       else
       {
         // Add 'start' for Windows style commands, like 'notepad'
-        program = "start \"" + program + "\"";
+        argv = {"start", program};
       }
-      auto& env_vars = active_bottle_->env_vars();
-
-      std::thread t(
-          [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, program, working_directory, env_vars,
-           logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-           output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-           output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_]
-          {
-            string output =
-                Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, program, working_directory, env_vars, true, logging_stderr);
-            if (debug_logging && !output.empty())
-            {
-              {
-                std::lock_guard<std::mutex> lock(output_logging_mutex);
-                logging_bottle_prefix.get() = wine_prefix;
-                output_logging.get() = output;
-              }
-              write_log_dispatcher->emit();
-            }
-          });
-      t.detach();
+      start_job(Glib::path_get_basename(program), {get_job_command(argv, true, working_directory, active_bottle_->env_vars())});
     }
     else
     {
       // We have an exception for winetricks, since that doesn't need the wine command
-      std::thread t(
-          [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-           output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-           output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_]
-          {
-            string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-            if (debug_logging && !output.empty())
-            {
-              {
-                std::lock_guard<std::mutex> lock(output_logging_mutex);
-                logging_bottle_prefix.get() = wine_prefix;
-                output_logging.get() = output;
-              }
-              write_log_dispatcher->emit();
-            }
-          });
-      t.detach();
+      start_job("winetricks", {get_job_command({Helper::get_winetricks_location(), "--gui", "-q"}, false)});
     }
   }
 }
@@ -851,27 +991,7 @@ void BottleManager::reboot()
 {
   if (is_bottle_not_null())
   {
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    std::thread t(
-        [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, logging_stderr = std::move(is_logging_stderr_),
-         debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-         logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-         write_log_dispatcher = &write_log_dispatcher_]
-        {
-          string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -r", "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-        });
-    t.detach();
+    start_job("wineboot", {get_job_command({"wineboot", "-r"}, true)});
     main_window_.show_info_message("Machine emulate reboot requested.");
   }
 }
@@ -883,30 +1003,9 @@ void BottleManager::update()
 {
   if (is_bottle_not_null())
   {
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    std::thread t(
-        [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, update_bottles_dispatcher = &update_bottles_dispatcher_,
-         logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_]
-        {
-          string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -u", "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          // Emit update bottles (via dispatcher, so the GUI update can take place in the GUI thread)
-          update_bottles_dispatcher->emit();
-        });
-    t.detach();
+    start_job("wineboot", {get_job_command({"wineboot", "-u"}, true), get_wait_wineserver_command(active_bottle_->wine_location())},
+              // Emit update bottles (via dispatcher, so the GUI update can take place in the GUI thread)
+              [update_bottles_dispatcher = &update_bottles_dispatcher_] { update_bottles_dispatcher->emit(); });
   }
 }
 
@@ -920,10 +1019,7 @@ void BottleManager::open_log_file()
     string log_file_path = Helper::get_log_file_path(active_bottle_->wine_location());
     if (Helper::file_exists(log_file_path))
     {
-      if (!Gio::AppInfo::launch_default_for_uri(Glib::filename_to_uri(log_file_path)))
-      {
-        main_window_.show_error_message("Could not open log file.");
-      }
+      launch_log_file(log_file_path);
     }
     else
     {
@@ -934,6 +1030,48 @@ void BottleManager::open_log_file()
   }
 }
 
+/**
+ * \brief Open the previous (rotated) debug log of current bottle, a compressed log file is decompressed in the background first
+ */
+void BottleManager::open_previous_log_file()
+{
+  if (is_bottle_not_null())
+  {
+    string log_file_path = Helper::get_log_file_path(active_bottle_->wine_location());
+    string previous_log_file_path = LogWriter::get_generation_path(log_file_path, 1);
+    string compressed_log_file_path = LogCompressor::get_compressed_path(log_file_path, 1);
+    if (Helper::file_exists(previous_log_file_path))
+    {
+      // Not compressed (yet)
+      launch_log_file(previous_log_file_path);
+    }
+    else if (Helper::file_exists(compressed_log_file_path))
+    {
+      string output_dir = Glib::build_filename(Glib::get_user_cache_dir(), "winegui", "logs");
+      if (!Helper::dir_exists(output_dir) && !Helper::create_dir(output_dir))
+      {
+        main_window_.show_error_message("Could not create the log folder: " + output_dir);
+        return;
+      }
+      string output_path = Glib::build_filename(output_dir, active_bottle_->folder_name().raw() + "-winegui.log.1");
+      log_compressor_.decompress(compressed_log_file_path, output_path,
+                                 [this, output_path](bool is_decompressed)
+                                 {
+                                   {
+                                     std::lock_guard<std::mutex> lock(decompressed_log_mutex_);
+                                     decompressed_log_path_ = is_decompressed ? output_path : "";
+                                   }
+                                   log_decompressed_dispatcher_.emit();
+                                 });
+    }
+    else
+    {
+      main_window_.show_warning_message("There is no previous log file present (yet).\n\nThe log file is rotated when it exceeds " +
+                                        std::to_string(LogMaxFileSize / (1024 * 1024)) + " MB.");
+    }
+  }
+}
+
 /**
  * \brief Kill running processes in bottle
  */
@@ -941,27 +1079,7 @@ void BottleManager::kill_processes()
 {
   if (is_bottle_not_null())
   {
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    std::thread t(
-        [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, logging_stderr = std::move(is_logging_stderr_),
-         debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-         logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-         write_log_dispatcher = &write_log_dispatcher_]
-        {
-          string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -k", "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-        });
-    t.detach();
+    start_job("wineboot", {get_job_command({"wineboot", "-k"}, true)});
     main_window_.show_info_message("Kill processes requested.");
   }
 }
@@ -983,31 +1101,7 @@ void BottleManager::install_d3dx9(Gtk::Window& parent, const string& version)
     {
       package += "_" + version;
     }
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program = Helper::get_winetricks_location() + " -q " + package;
-    // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t(
-        [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-         finish_dispatcher = &finished_package_install_dispatcher]
-        {
-          string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          finish_dispatcher->emit();
-        });
-    t.detach();
+    start_install_job(package, {{Helper::get_winetricks_location(), "-q", package}});
   }
 }
 
@@ -1029,31 +1123,7 @@ void BottleManager::install_dxvk(Gtk::Window& parent, const string& version)
     {
       package += version;
     }
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program = Helper::get_winetricks_location() + " -q " + package;
-    // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t(
-        [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-         finish_dispatcher = &finished_package_install_dispatcher]
-        {
-          string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          finish_dispatcher->emit();
-        });
-    t.detach();
+    start_install_job(package, {{Helper::get_winetricks_location(), "-q", package}});
   }
 }
 
@@ -1069,31 +1139,7 @@ void BottleManager::install_vkd3d(Gtk::Window& parent)
     main_window_.show_busy_install_dialog(parent, "Installing VKD3D (Vulkan-based implementation of DirectX 12).\n");
 
     string package = "vkd3d";
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program = Helper::get_winetricks_location() + " -q " + package;
-    // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t(
-        [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-         finish_dispatcher = &finished_package_install_dispatcher]
-        {
-          string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          finish_dispatcher->emit();
-        });
-    t.detach();
+    start_install_job(package, {{Helper::get_winetricks_location(), "-q", package}});
   }
 }
 
@@ -1110,31 +1156,7 @@ void BottleManager::install_visual_cpp_package(Gtk::Window& parent, const string
     main_window_.show_busy_install_dialog(parent, "Installing Visual C++ package (" + version + ").");
 
     string package = "vcrun" + version;
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program = Helper::get_winetricks_location() + " -q " + package;
-    // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t(
-        [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-         finish_dispatcher = &finished_package_install_dispatcher]
-        {
-          string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          finish_dispatcher->emit();
-        });
-    t.detach();
+    start_install_job(package, {{Helper::get_winetricks_location(), "-q", package}});
   }
 }
 
@@ -1155,45 +1177,15 @@ void BottleManager::install_dot_net(Gtk::Window& parent, const string& version)
       // Before we execute the install, show busy dialog
       main_window_.show_busy_install_dialog(parent, "Installing Native .NET package (v" + version + ").\nThis may take quite some time!\n");
 
-      string deinstall_command = this->get_deinstall_mono_command();
+      vector<string> deinstall_argv = this->get_deinstall_mono_command();
 
       string package = "dotnet" + version;
-      string wine_prefix = active_bottle_->wine_location();
-      bool is_debug_logging = active_bottle_->is_debug_logging();
-      int debug_log_level = active_bottle_->debug_log_level();
-      // I can't use -q with .NET installs
-      string install_command = Helper::get_winetricks_location() + " " + package;
-      string program = "";
-      if (!deinstall_command.empty())
-      {
-        // First deinstall Mono then install native .NET
-        program = deinstall_command + "; " + install_command;
-      }
-      else
-      {
-        program = install_command;
-      }
-      // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-      std::thread t(
-          [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-           output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-           output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-           finish_dispatcher = &finished_package_install_dispatcher]
-          {
-            string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-            if (debug_logging && !output.empty())
-            {
-              {
-                std::lock_guard<std::mutex> lock(output_logging_mutex);
-                logging_bottle_prefix.get() = wine_prefix;
-                output_logging.get() = output;
-              }
-              write_log_dispatcher->emit();
-            }
-            Helper::wait_until_wineserver_is_terminated(wine_prefix);
-            finish_dispatcher->emit();
-          });
-      t.detach();
+      // First deinstall Mono then install native .NET (I can't use -q with .NET installs)
+      vector<vector<string>> commands;
+      if (!deinstall_argv.empty())
+        commands.push_back(deinstall_argv);
+      commands.push_back({Helper::get_winetricks_location(), package});
+      start_install_job(package, commands);
     }
     else
     {
@@ -1213,31 +1205,7 @@ void BottleManager::install_core_fonts(Gtk::Window& parent)
     // Before we execute the install, show busy dialog
     main_window_.show_busy_install_dialog(parent, "Installing MS Core fonts.");
 
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program = Helper::get_winetricks_location() + " -q corefonts";
-    // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t(
-        [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-         finish_dispatcher = &finished_package_install_dispatcher]
-        {
-          string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          finish_dispatcher->emit();
-        });
-    t.detach();
+    start_install_job("corefonts", {{Helper::get_winetricks_location(), "-q", "corefonts"}});
   }
 }
 
@@ -1252,31 +1220,7 @@ void BottleManager::install_liberation(Gtk::Window& parent)
     // Before we execute the install, show busy dialog
     main_window_.show_busy_install_dialog(parent, "Installing Liberation open-source fonts.");
 
-    string wine_prefix = active_bottle_->wine_location();
-    bool is_debug_logging = active_bottle_->is_debug_logging();
-    int debug_log_level = active_bottle_->debug_log_level();
-    string program = Helper::get_winetricks_location() + " -q liberation";
-    // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t(
-        [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-         output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-         output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-         finish_dispatcher = &finished_package_install_dispatcher]
-        {
-          string output = Helper::run_program(wine_prefix, debug_log_level, program, "", {}, true, logging_stderr);
-          if (debug_logging && !output.empty())
-          {
-            {
-              std::lock_guard<std::mutex> lock(output_logging_mutex);
-              logging_bottle_prefix.get() = wine_prefix;
-              output_logging.get() = output;
-            }
-            write_log_dispatcher->emit();
-          }
-          Helper::wait_until_wineserver_is_terminated(wine_prefix);
-          finish_dispatcher->emit();
-        });
-    t.detach();
+    start_install_job("liberation", {{Helper::get_winetricks_location(), "-q", "liberation"}});
   }
 }
 
@@ -1290,11 +1234,13 @@ void BottleManager::install_liberation(Gtk::Window& parent)
  */
 GeneralConfigData BottleManager::load_and_save_general_config()
 {
+  StartupProfiler::Scope scope("Load general config");
   GeneralConfigData general_config = GeneralConfigFile::read_config_file();
   bottle_location_ = general_config.default_folder;
   is_display_default_wine_machine_ = general_config.display_default_wine_machine;
   is_wine64_bit_ = Helper::determine_wine_executable() == 1;
   is_logging_stderr_ = general_config.enable_logging_stderr;
+  log_compressor_.set_max_threads(LogCompressor::get_max_threads(general_config.log_compression_cpu_share));
   return general_config;
 }
 
@@ -1305,17 +1251,22 @@ bool BottleManager::is_bottle_not_null()
   {
     main_window_.show_error_message("No Windows Machine selected/empty. First create a new machine!\n\nAborted.");
   }
+  else if (active_bottle_->is_loading() || !active_bottle_->is_details_loaded())
+  {
+    main_window_.show_info_message("The Windows Machine is still loading, try again in a moment.");
+    return false;
+  }
   return !is_null;
 }
 
 /**
  * \brief Wine Mono deinstall command, run before installing native .NET
- * \return uninstall Mono command
- * Note: When nothing todo, the command will be an empty string.
+ * \return uninstall Mono command (program & arguments)
+ * Note: When nothing todo, the command will be empty.
  */
-string BottleManager::get_deinstall_mono_command()
+vector<string> BottleManager::get_deinstall_mono_command()
 {
-  string command = "";
+  vector<string> command;
   if (active_bottle_ != nullptr)
   {
     string wine_prefix = active_bottle_->wine_location();
@@ -1323,39 +1274,145 @@ string BottleManager::get_deinstall_mono_command()
 
     if (!guid.empty())
     {
-      string uninstaller = "";
+      string wine = "";
       switch (active_bottle_->bit())
       {
       case BottleTypes::Bit::win32:
-        uninstaller = "wine uninstaller --remove";
+        wine = "wine";
         break;
       case BottleTypes::Bit::win64:
-        uninstaller = "wine64 uninstaller --remove";
+        wine = "wine64";
         break;
       }
-      command = uninstaller + " '{" + guid + "}'";
+      command = {wine, "uninstaller", "--remove", "{" + guid + "}"};
     }
   }
   return command;
 }
 
 /**
- * \brief Get Wine version
- * \return Wine version
+ * \brief Command of a job, run in the active bottle
+ * \param[in] argv Program followed by its arguments
+ * \param[in] is_wine_program Run the program under Wine (the Wine executable is added in front)
+ * \param[in] working_directory Working directory of where the program will be executed
+ * \param[in] env_vars Array of environment variables to set
+ * \return Job command
  */
-string BottleManager::get_wine_version()
+JobCommand BottleManager::get_job_command(const vector<string>& argv,
+                                          bool is_wine_program,
+                                          const string& working_directory,
+                                          const vector<std::pair<string, string>>& env_vars)
 {
-  // Read wine version (is always the same for all bottles atm)
-  string wine_version = "";
-  try
+  JobCommand command;
+  if (is_wine_program)
+    command.argv.push_back(Helper::get_wine_executable_location(is_wine64_bit_));
+  command.argv.insert(command.argv.end(), argv.begin(), argv.end());
+  command.options =
+      Helper::program_options(active_bottle_->wine_location(), active_bottle_->debug_log_level(), working_directory, env_vars, is_logging_stderr_);
+  return command;
+}
+
+/**
+ * \brief Wait until the wineserver of the bottle is terminated (time-out of 60 seconds), a time-out is not an error
+ * \param[in] wine_prefix Bottle prefix
+ * \return Job command
+ */
+JobCommand BottleManager::get_wait_wineserver_command(const string& wine_prefix)
+{
+  return JobCommand{{"timeout", "60", "wineserver", "-w"}, {.env_vars = {{"WINEPREFIX", wine_prefix}}}, false};
+}
+
+/**
+ * \brief Start a job (program or install) in the active bottle, the output is shown in the console window while the job is running.
+ * With debug logging enabled, the output lines are also written to the log file of the bottle (via the log writer).
+ * \param[in] name Job name, shown in front of the output lines
+ * \param[in] commands Commands, run one after the other
+ * \param[in] on_finished Called after the job is finished (in the supervisor I/O thread, shouldn't block, optional)
+ */
+void BottleManager::start_job(const string& name, vector<JobCommand> commands, std::function<void()> on_finished)
+{
+  // Output state of the job, only used in the I/O thread
+  struct JobOutput
+  {
+    LineFramer framer;
+    bool is_logging;
+    LogChannel log_channel;
+  };
+  auto output = std::make_shared<JobOutput>();
+  output->is_logging = active_bottle_->is_debug_logging();
+  if (output->is_logging)
+    output->log_channel = LogWriter::open_channel(Helper::get_log_file_path(active_bottle_->wine_location()), active_bottle_->name().raw(), name);
+
+  // The reader is only notified once until it reads the lines (a dispatcher emit is a pipe write)
+  auto on_line = [output, name, console_buffer = &console_buffer_, console_output_dispatcher = &console_output_dispatcher,
+                  log_writer = &log_writer_](std::uint64_t job_id, std::string_view line)
+  {
+    if (console_buffer->append(name, line))
+      console_output_dispatcher->emit();
+    if (output->is_logging)
+      log_writer->write(output->log_channel, job_id, line);
+  };
+
+  process_supervisor_.start(
+      name, std::move(commands),
+      [output, on_line](std::uint64_t job_id, std::string_view chunk)
+      { output->framer.feed(chunk, [&on_line, job_id](std::string_view line) { on_line(job_id, line); }); },
+      [output, on_line, on_finished = std::move(on_finished)](std::uint64_t job_id, int exit_code)
+      {
+        output->framer.finish([&on_line, job_id](std::string_view line) { on_line(job_id, line); });
+        on_line(job_id, "Finished (exit code: " + std::to_string(exit_code) + ")");
+        if (exit_code != 0)
+        {
+          // Signal error message to the user (in the main loop)
+          Helper::get_instance().failure_on_exec.emit();
+        }
+        if (on_finished)
+          on_finished();
+      });
+}
+
+/**
+ * \brief Run the package install command(s) in order as a single job, using the active bottle.
+ * The finished_package_install_dispatcher is emitted when the wineserver is terminated, in order to close the busy dialog again.
+ * \param[in] package Package name, eg. vcrun2019
+ * \param[in] commands Commands (program & arguments) to run
+ */
+void BottleManager::start_install_job(const string& package, const vector<vector<string>>& commands)
+{
+  vector<JobCommand> job_commands;
+  for (const vector<string>& argv : commands)
+    job_commands.push_back(get_job_command(argv, false));
+  job_commands.push_back(get_wait_wineserver_command(active_bottle_->wine_location()));
+  start_job("winetricks " + package, std::move(job_commands),
+            [finish_dispatcher = &finished_package_install_dispatcher] { finish_dispatcher->emit(); });
+}
+
+/**
+ * \brief Open the log file in the default application
+ * \param[in] log_file_path Log file path
+ */
+void BottleManager::launch_log_file(const string& log_file_path)
+{
+  if (!Gio::AppInfo::launch_default_for_uri(Glib::filename_to_uri(log_file_path)))
   {
-    wine_version = Helper::get_wine_version(is_wine64_bit_);
+    main_window_.show_error_message("Could not open log file.");
   }
-  catch (const std::runtime_error& error)
+}
+
+/**
+ * \brief Signal handler when the previous log file is decompressed (in the GUI thread)
+ */
+void BottleManager::on_log_decompressed()
+{
+  string log_file_path;
   {
-    main_window_.show_error_message(error.what());
+    std::lock_guard<std::mutex> lock(decompressed_log_mutex_);
+    log_file_path = decompressed_log_path_;
   }
-  return wine_version;
+  if (log_file_path.empty())
+    main_window_.show_error_message("Could not decompress the previous log file.");
+  else
+    launch_log_file(log_file_path);
 }
 
 /**
@@ -1365,6 +1422,7 @@ string BottleManager::get_wine_version()
  */
 std::vector<string> BottleManager::get_bottle_paths()
 {
+  StartupProfiler::Scope scope("Scan bottle paths");
   if (!Helper::dir_exists(bottle_location_))
   {
     // Create bottle prefix directory if not exist yet
@@ -1387,100 +1445,474 @@ std::vector<string> BottleManager::get_bottle_paths()
 }
 
 /**
- * \brief Create wine BottleItem objects and add them to a list.
+ * \brief Start the thread that inspects all the bottles. The bottles are inspected in parallel (blocking file I/O)
+ * and each inspected bottle is reported to the GUI thread via the bottles loaded dispatcher.
  * \param[in] bottle_dirs  The list of bottle directories
- * \returns Array of Bottle Items
  */
-std::list<BottleItem> BottleManager::create_wine_bottles(const std::vector<string>& bottle_dirs)
+void BottleManager::load_bottles_thread(const std::vector<std::size_t>& indices, bool is_full_load, bool is_background)
 {
-  std::list<BottleItem> bottles;
-  Glib::ustring wine_version = get_wine_version();
+  load_bottle_indices_ = indices;
+  is_background_load_ = is_background;
+  for (std::size_t index : indices)
+  {
+    bottle_inspections_[index] = BottleInspection();
+    // Bottles of which the details are already loaded (eg. the selected bottle) keep showing their details
+    bottle_inspections_[index].is_details_wanted = index < bottles_.size() && bottles_[index].is_details_loaded();
+  }
+  loaded_bottles_.clear();
+  load_bottles_errors_.clear();
+  is_all_bottles_loaded_ = false;
+  is_load_bottles_cancelled_ = false;
+
+  // The snapshot is only changed by the GUI thread after the inspection is finished (see on_bottles_loaded())
+  thread_load_bottles_ = std::make_unique<std::thread>(
+      [this, is_full_load]
+      {
+        gint64 load_start_time = g_get_monotonic_time();
+        // The Wine version is only read again during a full load
+        if (is_full_load)
+        {
+          StartupProfiler::Scope wine_version_scope("Wine version");
+          try
+          {
+            loaded_wine_version_ = Helper::get_wine_version(is_wine64_bit_);
+          }
+          catch (const std::runtime_error& error)
+          {
+            std::lock_guard<std::mutex> lock(loaded_bottles_mutex_);
+            load_bottles_errors_ = error.what();
+          }
+        }
 
-  // Retrieve detailed info for each wine bottle prefix
-  for (const string& prefix : bottle_dirs)
+        // Each worker takes the next bottle until all bottles are done, the current thread is one of the workers.
+        std::atomic<std::size_t> next_index = 0;
+        auto worker = [this, &next_index]()
+        {
+          for (std::size_t n = next_index++; n < load_bottle_indices_.size() && !is_load_bottles_cancelled_; n = next_index++)
+          {
+            std::size_t i = load_bottle_indices_[n];
+            BottleInspection& inspection = bottle_inspections_[i];
+            inspection.signature = BottleSnapshot::get_signature(bottle_dirs_[i]);
+            if (const BottleSnapshotData* snapshot = bottle_snapshot_.find(bottle_dirs_[i], inspection.signature))
+            {
+              inspection.details = *snapshot;
+              inspection.is_snapshot = true;
+            }
+            inspect_bottle(bottle_dirs_[i], inspection);
+
+            bool is_first_pending;
+            {
+              std::lock_guard<std::mutex> lock(loaded_bottles_mutex_);
+              is_first_pending = loaded_bottles_.empty();
+              loaded_bottles_.push_back(i);
+            }
+            // Only wake-up the GUI thread once for all the bottles that are pending
+            if (is_first_pending)
+              bottles_loaded_dispatcher_.emit();
+          }
+        };
+        std::size_t thread_count =
+            std::min({static_cast<std::size_t>(std::max(1U, std::thread::hardware_concurrency())), MaxInspectionThreads,
+                      load_bottle_indices_.size()});
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1);
+        for (std::size_t i = 1; i < thread_count; i++)
+          threads.emplace_back(worker);
+        worker();
+        for (std::thread& thread : threads)
+          thread.join();
+        StartupProfiler::record("Load bottles", "", load_start_time, g_get_monotonic_time());
+
+        {
+          std::lock_guard<std::mutex> lock(loaded_bottles_mutex_);
+          is_all_bottles_loaded_ = true;
+        }
+        bottles_loaded_dispatcher_.emit();
+      });
+}
+
+/**
+ * \brief Stop the bottles load thread (if running), bottles that are not yet inspected are skipped.
+ * Pending results of the stopped thread are dropped.
+ */
+void BottleManager::cancel_load_bottles_thread()
+{
+  if (thread_load_bottles_ && thread_load_bottles_->joinable())
   {
-    // Reset variables
-    Glib::ustring folder_name = "";
-    Glib::ustring virtual_desktop = "";
-    BottleTypes::Bit bit = BottleTypes::Bit::win32;
-    Glib::ustring c_drive_location = "- Unknown -";
-    Glib::ustring last_time_wine_updated = "- Unknown -";
-    BottleTypes::AudioDriver audio_driver = BottleTypes::AudioDriver::pulseaudio;
-    BottleTypes::Windows windows = WineDefaults::WindowsOs;
-    bool status = false;
-
-    // Retrieve bottle config data & custom app list
-    BottleConfigData bottle_config;
-    std::map<int, ApplicationData> bottle_app_list;
-    std::tie(bottle_config, bottle_app_list) = BottleConfigFile::read_config_file(prefix);
+    is_load_bottles_cancelled_ = true;
+    thread_load_bottles_->join();
+    thread_load_bottles_.reset();
+  }
+  {
+    std::lock_guard<std::mutex> lock(loaded_bottles_mutex_);
+    loaded_bottles_.clear();
+    is_all_bottles_loaded_ = false;
+  }
+}
 
-    try
-    {
-      folder_name = Helper::get_folder_name(prefix);
-    }
-    catch (const std::runtime_error& error)
-    {
-      main_window_.show_error_message(error.what());
-    }
+/**
+ * \brief Signal handler when one or more bottles are inspected by the load thread (runs on the GUI thread).
+ * Fill-in the placeholder rows, when all bottles are loaded update the snapshot and show the errors (if any).
+ */
+void BottleManager::on_bottles_loaded()
+{
+  std::vector<std::size_t> loaded_bottles;
+  bool is_all_loaded;
+  {
+    std::lock_guard<std::mutex> lock(loaded_bottles_mutex_);
+    loaded_bottles.swap(loaded_bottles_);
+    is_all_loaded = is_all_bottles_loaded_;
+    // Report the completion only once
+    is_all_bottles_loaded_ = false;
+  }
+  // Outdated signal, from a cancelled load
+  if (!thread_load_bottles_)
+    return;
 
-    try
-    {
-      bit = Helper::get_windows_bitness(prefix);
-    }
-    catch (const std::runtime_error& error)
-    {
-      main_window_.show_error_message(error.what());
-    }
-    try
-    {
-      c_drive_location = Helper::get_c_letter_drive(prefix);
-    }
-    catch (const std::runtime_error& error)
-    {
-      main_window_.show_error_message(error.what());
-    }
-    try
-    {
-      last_time_wine_updated = Helper::get_last_wine_updated(prefix);
-    }
-    catch (const std::runtime_error& error)
-    {
-      main_window_.show_error_message(error.what());
-    }
-    try
-    {
-      audio_driver = Helper::get_audio_driver(prefix);
-    }
-    catch (const std::runtime_error& error)
+  for (std::size_t index : loaded_bottles)
+  {
+    BottleInspection& inspection = bottle_inspections_[index];
+    BottleRecord& bottle = bottles_[index];
+    inspection.is_applied = true;
+    // Only update the rows that are changed (existing bottles are inspected again)
+    if (apply_bottle_inspection(bottle, inspection))
+      main_window_.update_wine_bottle(index);
+
+    // Select the bottle with the requested name (eg. newly created bottle), once it is loaded
+    if (!select_bottle_name_.empty() && bottle.name() == select_bottle_name_)
     {
-      main_window_.show_error_message(error.what());
+      main_window_.select_row_bottle(index);
+      active_bottle_ = &bottle;
+      select_bottle_name_.clear();
     }
-    try
+  }
+
+  if (is_all_loaded)
+  {
+    cleanup_load_bottles_thread();
+  }
+}
+
+/**
+ * \brief Update the bottle item with the inspected bottle data
+ * \param[in,out] bottle Bottle item
+ * \param[in] inspection Inspected bottle
+ * \return True when the bottle item is changed
+ */
+bool BottleManager::apply_bottle_inspection(BottleRecord& bottle, const BottleInspection& inspection)
+{
+  const BottleSnapshotData& details = inspection.details;
+  Glib::ustring folder_name = (!inspection.folder_name.empty()) ? Glib::ustring(inspection.folder_name) : bottle.folder_name();
+  bool is_changed = bottle.is_loading() || bottle.is_details_loaded() != inspection.is_details_loaded || bottle.name() != inspection.config.name ||
+                    bottle.folder_name() != folder_name || bottle.description() != inspection.config.description ||
+                    bottle.status() != details.status || bottle.windows() != details.windows || bottle.bit() != details.bit ||
+                    bottle.wine_version() != loaded_wine_version_ || bottle.is_wine64_bit() != is_wine64_bit_ ||
+                    bottle.wine_c_drive() != details.c_drive_location || bottle.wine_last_changed() != details.last_time_wine_updated ||
+                    bottle.audio_driver() != details.audio_driver || bottle.virtual_desktop() != details.virtual_desktop ||
+                    bottle.is_debug_logging() != inspection.config.logging_enabled ||
+                    bottle.debug_log_level() != inspection.config.debug_log_level || bottle.env_vars() != inspection.config.env_vars ||
+                    bottle.app_list() != inspection.app_list;
+  if (!is_changed)
+    return false;
+
+  bottle.name(inspection.config.name);
+  bottle.folder_name(folder_name);
+  bottle.description(inspection.config.description);
+  bottle.status(details.status);
+  bottle.windows(details.windows);
+  bottle.bit(details.bit);
+  bottle.wine_version(loaded_wine_version_);
+  bottle.is_wine64_bit(is_wine64_bit_);
+  bottle.wine_c_drive(details.c_drive_location);
+  bottle.wine_last_changed(details.last_time_wine_updated);
+  bottle.audio_driver(details.audio_driver);
+  bottle.virtual_desktop(details.virtual_desktop);
+  bottle.is_debug_logging(inspection.config.logging_enabled);
+  bottle.debug_log_level(inspection.config.debug_log_level);
+  bottle.env_vars(inspection.config.env_vars);
+  bottle.app_list(inspection.app_list);
+  bottle.is_loading(false);
+  bottle.is_details_loaded(inspection.is_details_loaded);
+  return true;
+}
+
+/**
+ * \brief All bottles are inspected, join the load thread and update the snapshot (runs on the GUI thread).
+ */
+void BottleManager::cleanup_load_bottles_thread()
+{
+  thread_load_bottles_->join();
+  thread_load_bottles_.reset();
+
+  // Merge the results in the same (sorted) order as the bottle directories
+  Glib::ustring error_messages = load_bottles_errors_;
+  for (std::size_t i : load_bottle_indices_)
+  {
+    const BottleInspection& inspection = bottle_inspections_[i];
+    if (!inspection.is_snapshot)
     {
-      windows = Helper::get_windows_version(prefix);
-      status = Helper::get_bottle_status(prefix);
+      // Keep showing errors, by not storing incomplete bottle details.
+      // Bottles without details (not yet selected) are stored once the details are loaded.
+      if (!inspection.errors.empty())
+        bottle_snapshot_.erase(bottle_dirs_[i]);
+      else if (inspection.is_details_valid)
+        bottle_snapshot_.insert(bottle_dirs_[i], inspection.signature, inspection.details);
     }
-    catch (const std::runtime_error& error)
+    for (const string& error : inspection.errors)
     {
-      main_window_.show_error_message(error.what());
+      if (!error_messages.empty())
+        error_messages += "\n\n";
+      error_messages += error;
     }
-    try
+  }
+  // Removed bottles are dropped from the snapshot
+  bottle_snapshot_.retain(bottle_dirs_);
+  bottle_snapshot_.save(get_snapshot_file_path());
+  StartupProfiler::milestone(StartupProfiler::BottlesLoaded);
+
+  // Requested bottle name is not found, fallback to the first bottle
+  if (!select_bottle_name_.empty() && !bottles_.empty())
+  {
+    main_window_.select_row_bottle(0);
+    active_bottle_ = &bottles_.front();
+    select_bottle_name_.clear();
+  }
+
+  // Show all the errors at once, instead of a dialog per error.
+  // Background refreshes don't interrupt the user (eg. a bottle that is still being created by Wine).
+  if (!error_messages.empty() && is_background_load_)
+    std::cerr << "Error: Could not load all the bottles: " << error_messages << std::endl;
+  else if (!error_messages.empty())
+    main_window_.show_error_message(error_messages);
+
+  // Bottles that are changed during the load
+  if (!pending_update_prefixes_.empty())
+  {
+    std::set<string> prefixes;
+    prefixes.swap(pending_update_prefixes_);
+    update_bottles(prefixes);
+  }
+}
+
+/**
+ * \brief Signal handler when the files of one or more bottles are changed (eg. outside WineGUI), only those bottles are inspected again.
+ * \param[in] prefixes Prefix paths of the changed bottles
+ */
+void BottleManager::update_bottles(const std::set<string>& prefixes)
+{
+  // Wait for the current load, afterwards the changed bottles are inspected (see cleanup_load_bottles_thread())
+  if (thread_load_bottles_)
+  {
+    pending_update_prefixes_.insert(prefixes.begin(), prefixes.end());
+    return;
+  }
+  std::vector<std::size_t> indices;
+  for (std::size_t index = 0; index < bottle_dirs_.size(); index++)
+  {
+    if (prefixes.contains(bottle_dirs_[index]))
+      indices.push_back(index);
+  }
+  if (!indices.empty())
+    load_bottles_thread(indices, false, true);
+}
+
+/**
+ * \brief Signal handler when the details of one or more bottles are loaded (runs on the GUI thread).
+ */
+void BottleManager::on_bottle_details_loaded()
+{
+  std::vector<BottleDetailsResult> results;
+  {
+    std::lock_guard<std::mutex> lock(load_details_mutex_);
+    results.swap(details_results_);
+  }
+
+  Glib::ustring error_messages;
+  bool is_snapshot_changed = false;
+  for (BottleDetailsResult& result : results)
+  {
+    // Outdated result, the bottle list is reloaded (or the bottle is inspected again) in the meantime
+    if (result.generation != bottles_generation_ || !bottle_inspections_[result.index].is_applied)
+      continue;
+    BottleInspection& inspection = bottle_inspections_[result.index];
+    BottleRecord& bottle = bottles_[result.index];
+    inspection.is_details_requested = false;
+    // Errors are only shown for the selected bottle, prefetched bottles are loaded again once selected
+    if (!result.errors.empty() && &bottle != active_bottle_)
+      continue;
+
+    inspection.details = std::move(result.details);
+    inspection.is_details_loaded = true;
+    inspection.is_details_valid = result.errors.empty() && inspection.errors.empty();
+    const BottleSnapshotData& details = inspection.details;
+    bottle.wine_c_drive(details.c_drive_location);
+    bottle.wine_last_changed(details.last_time_wine_updated);
+    bottle.audio_driver(details.audio_driver);
+    bottle.virtual_desktop(details.virtual_desktop);
+    bottle.is_details_loaded(true);
+    main_window_.update_wine_bottle(result.index);
+
+    for (const string& error : result.errors)
     {
-      virtual_desktop = Helper::get_virtual_desktop(prefix);
+      if (!error_messages.empty())
+        error_messages += "\n\n";
+      error_messages += error;
     }
-    catch (const std::runtime_error& error)
+    // During the bottles load, the snapshot is updated once all bottles are loaded (see cleanup_load_bottles_thread())
+    if (!thread_load_bottles_ && !inspection.is_snapshot)
     {
-      main_window_.show_error_message(error.what());
+      if (inspection.is_details_valid)
+        bottle_snapshot_.insert(bottle_dirs_[result.index], inspection.signature, inspection.details);
+      else
+        bottle_snapshot_.erase(bottle_dirs_[result.index]);
+      is_snapshot_changed = true;
     }
+  }
+
+  if (is_snapshot_changed)
+    bottle_snapshot_.save(get_snapshot_file_path());
+  if (!error_messages.empty())
+    main_window_.show_error_message(error_messages);
+}
+
+/**
+ * \brief Inspect a single bottle, reads the bottle config and (when not in the snapshot) the bottle summary.
+ * The details are only read when they are wanted (the details of the bottle were loaded before).
+ * Runs in a worker thread (see load_bottles_thread()), so errors are collected in the inspection instead of showing them.
+ * \param[in] prefix Bottle prefix
+ * \param[in,out] inspection Inspection of the bottle
+ */
+void BottleManager::inspect_bottle(const string& prefix, BottleInspection& inspection)
+{
+  StartupProfiler::Scope scope("Inspect bottle", prefix);
+  // Retrieve bottle config data & custom app list
+  std::tie(inspection.config, inspection.app_list) = BottleConfigFile::read_config_file(prefix);
+  try
+  {
+    inspection.folder_name = Helper::get_folder_name(prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    inspection.errors.emplace_back(error.what());
+  }
+  if (inspection.is_snapshot)
+  {
+    inspection.is_details_loaded = true;
+    inspection.is_details_valid = true;
+  }
+  else if (inspection.is_details_wanted)
+  {
+    inspection.details = read_bottle_summary(prefix, inspection.errors);
+    read_bottle_details(prefix, inspection.details, inspection.errors);
+    inspection.is_details_loaded = true;
+    inspection.is_details_valid = inspection.errors.empty();
+  }
+  else
+  {
+    // Only the summary, the details are loaded on demand (see load_bottle_details())
+    inspection.details = read_bottle_summary(prefix, inspection.errors);
+  }
+}
+
+/**
+ * \brief Read the bottle summary (shown in the bottle list) from the registry of the bottle prefix
+ * \param[in] prefix Bottle prefix
+ * \param[in,out] errors Error messages of the bottle summary that could not be read
+ * \return Bottle data with the summary (Windows version, bitness and status), the details are not yet loaded
+ */
+BottleSnapshotData BottleManager::read_bottle_summary(const string& prefix, std::vector<string>& errors)
+{
+  BottleSnapshotData details;
+  details.windows = WineDefaults::WindowsOs;
+  details.bit = BottleTypes::Bit::win32;
+  details.audio_driver = BottleTypes::AudioDriver::pulseaudio;
+  details.virtual_desktop = "";
+  details.status = false;
+  details.last_time_wine_updated = "- Loading -";
+  details.c_drive_location = "- Loading -";
+
+  // Read all the registry values of the summary at once
+  RegistryQuery registry;
+  Helper::add_bottle_summary_query(registry, prefix);
+  registry.execute();
+
+  try
+  {
+    details.bit = Helper::get_windows_bitness(registry, prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    errors.emplace_back(error.what());
+  }
+  try
+  {
+    details.windows = Helper::get_windows_version(registry, prefix);
+    details.status = Helper::get_bottle_status(registry, prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    errors.emplace_back(error.what());
+  }
+  return details;
+}
+
+/**
+ * \brief Read the bottle details (only shown in the detailed info panel) from the registry and other files of the bottle prefix
+ * \param[in] prefix Bottle prefix
+ * \param[in,out] details Bottle data, the detail fields are updated (defaults are used for the details that could not be read)
+ * \param[in,out] errors Error messages of the bottle details that could not be read
+ */
+void BottleManager::read_bottle_details(const string& prefix, BottleSnapshotData& details, std::vector<string>& errors)
+{
+  details.audio_driver = BottleTypes::AudioDriver::pulseaudio;
+  details.virtual_desktop = "";
+  details.last_time_wine_updated = "- Unknown -";
+  details.c_drive_location = "- Unknown -";
 
-    // Convert to Glib ustrings
-    Glib::ustring name(bottle_config.name);
-    Glib::ustring description(bottle_config.description);
-    Glib::ustring prefix_path(prefix);
-    BottleItem* bottle = new BottleItem(name, folder_name, description, status, windows, bit, wine_version, is_wine64_bit_, prefix_path,
-                                        c_drive_location, last_time_wine_updated, audio_driver, virtual_desktop, bottle_config.logging_enabled,
-                                        bottle_config.debug_log_level, bottle_config.env_vars, bottle_app_list);
-    bottles.emplace_back(*bottle);
+  // Read all the registry values of this bottle at once (the registry files are cached after reading the summary)
+  RegistryQuery registry;
+  Helper::add_bottle_details_query(registry, prefix);
+  registry.execute();
+
+  try
+  {
+    details.c_drive_location = Helper::get_c_letter_drive(prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    errors.emplace_back(error.what());
   }
-  return bottles;
+  try
+  {
+    details.last_time_wine_updated = Helper::get_last_wine_updated(prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    errors.emplace_back(error.what());
+  }
+  try
+  {
+    details.audio_driver = Helper::get_audio_driver(registry, prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    errors.emplace_back(error.what());
+  }
+  try
+  {
+    details.virtual_desktop = Helper::get_virtual_desktop(registry, prefix);
+  }
+  catch (const std::runtime_error& error)
+  {
+    errors.emplace_back(error.what());
+  }
+}
+
+/**
+ * \brief Get the file path of the bottle details snapshot
+ * \return Snapshot file path (in the WineGUI data directory)
+ */
+string BottleManager::get_snapshot_file_path()
+{
+  return Glib::build_filename(Helper::get_winegui_data_dir(), "bottles.snapshot");
 }
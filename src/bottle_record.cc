@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    bottle_record.cc
+ * \brief   Wine bottle data record (without widgets)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bottle_record.h"
+#include "wine_defaults.h"
+
+/**
+ * \brief Default Constructor
+ */
+BottleRecord::BottleRecord()
+    : name_(""),
+      folder_name_(""),
+      description_(""),
+      is_status_ok_(true),
+      win_(WineDefaults::WindowsOs),
+      bit_(BottleTypes::Bit::win32),
+      wine_version_(""),
+      is_wine64_bit_(false),
+      wine_location_(""),
+      wine_c_drive_(""),
+      wine_last_changed_(""),
+      audio_driver_(WineDefaults::AudioDriver),
+      virtual_desktop_(""),
+      is_debug_logging_(false),
+      debug_log_level_(1)
+{
+}
+
+/**
+ * \brief Construct a placeholder Wine bottle, shown while the bottle details are still being read
+ */
+BottleRecord::BottleRecord(const Glib::ustring& folder_name, const Glib::ustring& wine_location)
+    : name_(""),
+      folder_name_(folder_name),
+      description_(""),
+      is_status_ok_(false),
+      win_(WineDefaults::WindowsOs),
+      bit_(BottleTypes::Bit::win32),
+      wine_version_(""),
+      is_wine64_bit_(false),
+      wine_location_(wine_location),
+      wine_c_drive_("- Loading -"),
+      wine_last_changed_("- Loading -"),
+      audio_driver_(WineDefaults::AudioDriver),
+      virtual_desktop_(""),
+      is_debug_logging_(false),
+      debug_log_level_(1),
+      is_loading_(true),
+      is_details_loaded_(false)
+{
+}
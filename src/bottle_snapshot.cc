@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    bottle_snapshot.cc
+ * \brief   Persistent snapshot of the bottle details (read from the registry and other files)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bottle_snapshot.h"
+#include <cstring>
+#include <glib/gstdio.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <iostream>
+#include <set>
+#include <sys/stat.h>
+
+//// File format identifier, followed by the format version
+static const char SnapshotMagic[4] = {'W', 'G', 'S', 'N'};
+//// Increase the version when the file format or the meaning of the cached data changes
+static const std::uint32_t SnapshotVersion = 1;
+
+//// Source files of the bottle details, relative to the bottle prefix
+static const std::array<string, std::tuple_size<BottleSnapshot::Signature>::value> SourceFiles = {
+    "user.reg", "system.reg", "winegui.ini", ".update-timestamp", "dosdevices/c:"};
+
+/**
+ * \brief Append an integer to the buffer (little-endian)
+ */
+template <typename T> static void write_integer(string& buffer, T value)
+{
+  for (std::size_t i = 0; i < sizeof(T); i++)
+    buffer += static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff);
+}
+
+/**
+ * \brief Append a length prefixed string to the buffer
+ */
+static void write_string(string& buffer, const string& value)
+{
+  write_integer<std::uint32_t>(buffer, static_cast<std::uint32_t>(value.size()));
+  buffer += value;
+}
+
+/**
+ * \brief Sequential reader of the snapshot buffer, every read is bounds checked
+ */
+class SnapshotReader
+{
+public:
+  explicit SnapshotReader(const string& buffer) : buffer_(buffer), offset_(0)
+  {
+  }
+
+  template <typename T> bool read_integer(T& value)
+  {
+    if (buffer_.size() - offset_ < sizeof(T))
+      return false;
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++)
+      result |= static_cast<std::uint64_t>(static_cast<unsigned char>(buffer_[offset_ + i])) << (8 * i);
+    offset_ += sizeof(T);
+    value = static_cast<T>(result);
+    return true;
+  }
+
+  bool read_string(string& value)
+  {
+    std::uint32_t length;
+    if (!read_integer(length) || buffer_.size() - offset_ < length)
+      return false;
+    value.assign(buffer_, offset_, length);
+    offset_ += length;
+    return true;
+  }
+
+  bool read_bytes(char* data, std::size_t length)
+  {
+    if (buffer_.size() - offset_ < length)
+      return false;
+    std::memcpy(data, buffer_.data() + offset_, length);
+    offset_ += length;
+    return true;
+  }
+
+private:
+  const string& buffer_;
+  std::size_t offset_;
+};
+
+/**
+ * \brief Get the current signature of the source files of a bottle (only file status calls, no file reads)
+ * \param[in] prefix_path Bottle prefix
+ * \return Signature
+ */
+BottleSnapshot::Signature BottleSnapshot::get_signature(const string& prefix_path)
+{
+  Signature signature;
+  for (std::size_t i = 0; i < SourceFiles.size(); i++)
+  {
+    struct stat file_stat;
+    string file_path = Glib::build_filename(prefix_path, SourceFiles[i]);
+    // lstat(), the C: drive is a symlink
+    if (lstat(file_path.c_str(), &file_stat) == 0)
+    {
+      signature[i].modified_ns = static_cast<std::int64_t>(file_stat.st_mtim.tv_sec) * 1000000000LL + file_stat.st_mtim.tv_nsec;
+      signature[i].size = static_cast<std::int64_t>(file_stat.st_size);
+    }
+    else
+    {
+      signature[i] = {-1, -1};
+    }
+  }
+  return signature;
+}
+
+/**
+ * \brief Load the snapshot from disk, an invalid or outdated snapshot file is ignored
+ * \param[in] file_path Snapshot file path
+ * \return True when the snapshot is loaded
+ */
+bool BottleSnapshot::load(const string& file_path)
+{
+  entries_.clear();
+  is_changed_ = false;
+  string buffer;
+  try
+  {
+    buffer = Glib::file_get_contents(file_path);
+  }
+  catch (const Glib::FileError&)
+  {
+    return false; // No snapshot yet
+  }
+
+  SnapshotReader reader(buffer);
+  char magic[sizeof(SnapshotMagic)];
+  std::uint32_t version = 0, count = 0;
+  if (!reader.read_bytes(magic, sizeof(magic)) || std::memcmp(magic, SnapshotMagic, sizeof(magic)) != 0 || !reader.read_integer(version) ||
+      version != SnapshotVersion || !reader.read_integer(count))
+  {
+    std::cout << "INFO: Ignoring outdated or invalid bottle snapshot file: " << file_path << std::endl;
+    return false;
+  }
+
+  for (std::uint32_t i = 0; i < count; i++)
+  {
+    string prefix_path;
+    Entry entry;
+    std::uint8_t windows, bit, audio_driver, status;
+    bool is_valid = reader.read_string(prefix_path);
+    for (FileStamp& stamp : entry.signature)
+      is_valid = is_valid && reader.read_integer(stamp.modified_ns) && reader.read_integer(stamp.size);
+    is_valid = is_valid && reader.read_integer(windows) && reader.read_integer(bit) && reader.read_integer(audio_driver) &&
+               reader.read_integer(status) && reader.read_string(entry.data.virtual_desktop) &&
+               reader.read_string(entry.data.last_time_wine_updated) && reader.read_string(entry.data.c_drive_location);
+    if (!is_valid)
+    {
+      std::cerr << "Error: Bottle snapshot file is truncated, ignoring the snapshot: " << file_path << std::endl;
+      entries_.clear();
+      return false;
+    }
+    entry.data.windows = static_cast<BottleTypes::Windows>(windows);
+    entry.data.bit = static_cast<BottleTypes::Bit>(bit);
+    entry.data.audio_driver = static_cast<BottleTypes::AudioDriver>(audio_driver);
+    entry.data.status = (status != 0);
+    entries_.insert_or_assign(std::move(prefix_path), std::move(entry));
+  }
+  return true;
+}
+
+/**
+ * \brief Write the snapshot to disk (atomically), only when there are changes since load()
+ * \param[in] file_path Snapshot file path
+ */
+void BottleSnapshot::save(const string& file_path)
+{
+  if (!is_changed_)
+    return;
+
+  string buffer(SnapshotMagic, sizeof(SnapshotMagic));
+  write_integer<std::uint32_t>(buffer, SnapshotVersion);
+  write_integer<std::uint32_t>(buffer, static_cast<std::uint32_t>(entries_.size()));
+  for (const auto& [prefix_path, entry] : entries_)
+  {
+    write_string(buffer, prefix_path);
+    for (const FileStamp& stamp : entry.signature)
+    {
+      write_integer<std::int64_t>(buffer, stamp.modified_ns);
+      write_integer<std::int64_t>(buffer, stamp.size);
+    }
+    write_integer<std::uint8_t>(buffer, static_cast<std::uint8_t>(entry.data.windows));
+    write_integer<std::uint8_t>(buffer, static_cast<std::uint8_t>(entry.data.bit));
+    write_integer<std::uint8_t>(buffer, static_cast<std::uint8_t>(entry.data.audio_driver));
+    write_integer<std::uint8_t>(buffer, entry.data.status ? 1 : 0);
+    write_string(buffer, entry.data.virtual_desktop);
+    write_string(buffer, entry.data.last_time_wine_updated);
+    write_string(buffer, entry.data.c_drive_location);
+  }
+
+  try
+  {
+    g_mkdir_with_parents(Glib::path_get_dirname(file_path).c_str(), 0755);
+    // Writes to a temporary file first, which is renamed afterwards
+    Glib::file_set_contents(file_path, buffer);
+    is_changed_ = false;
+  }
+  catch (const Glib::FileError& error)
+  {
+    std::cerr << "Error: Couldn't write bottle snapshot file: " << file_path << ", error: " << error.what() << std::endl;
+  }
+}
+
+/**
+ * \brief Find the snapshot data of a bottle
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] signature Current signature of the source files, see get_signature()
+ * \return Snapshot data or nullptr when not found or outdated
+ */
+const BottleSnapshotData* BottleSnapshot::find(const string& prefix_path, const Signature& signature) const
+{
+  auto it = entries_.find(prefix_path);
+  if (it == entries_.end() || it->second.signature != signature)
+    return nullptr;
+  return &it->second.data;
+}
+
+/**
+ * \brief Add or replace the snapshot data of a bottle
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] signature Signature of the source files, retrieved BEFORE the bottle details were read
+ * \param[in] data Bottle details
+ */
+void BottleSnapshot::insert(const string& prefix_path, const Signature& signature, const BottleSnapshotData& data)
+{
+  entries_.insert_or_assign(prefix_path, Entry{signature, data});
+  is_changed_ = true;
+}
+
+/**
+ * \brief Remove the snapshot data of a bottle (eg. the bottle details could not be read)
+ * \param[in] prefix_path Bottle prefix
+ */
+void BottleSnapshot::erase(const string& prefix_path)
+{
+  if (entries_.erase(prefix_path) > 0)
+    is_changed_ = true;
+}
+
+/**
+ * \brief Only keep the snapshot data of the given bottles, removed bottles are dropped
+ * \param[in] prefix_paths Prefixes of all the current bottles
+ */
+void BottleSnapshot::retain(const std::vector<string>& prefix_paths)
+{
+  std::set<string> current(prefix_paths.begin(), prefix_paths.end());
+  std::size_t removed = std::erase_if(entries_, [&current](const auto& entry) { return !current.contains(entry.first); });
+  if (removed > 0)
+    is_changed_ = true;
+}
@@ -0,0 +1,262 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    bottle_watcher.cc
+ * \brief   File system watcher of the bottles & Wine desktop files (debounced)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bottle_watcher.h"
+#include <algorithm>
+#include <glibmm/fileutils.h>
+#include <glibmm/main.h>
+#include <glibmm/miscutils.h>
+#include <iostream>
+
+//// Quiet period after the last file event, before the changes are signalled (in ms)
+static const unsigned int DebounceTimeout = 500;
+//// Maximum delay of a signal when file events keep coming (in µs)
+static const gint64 MaxDebounceDelay = 2000000;
+//// Maximum sub-directory depth of the Wine desktop directories that is watched
+static const int MaxDesktopDirDepth = 8;
+
+//// Files in the bottle prefix that are shown in WineGUI (registry, WineGUI config & Wine update timestamp)
+static const std::set<string> WatchedPrefixFiles = {"user.reg", "system.reg", "winegui.ini", ".update-timestamp"};
+
+/**
+ * \brief Constructor
+ */
+BottleWatcher::BottleWatcher()
+    : desktop_dir_(Glib::build_filename(Glib::get_home_dir(), ".local", "share", "applications", "wine")),
+      first_pending_event_time_(0),
+      is_bottle_list_changed_(false),
+      is_desktop_files_changed_(false)
+{
+  // Wine menu items & desktop files, used in the application list
+  watch_desktop_dir(desktop_dir_);
+}
+
+/**
+ * \brief Destructor
+ */
+BottleWatcher::~BottleWatcher()
+{
+  debounce_timeout_.disconnect();
+}
+
+/**
+ * \brief Watch the bottle location & the bottle prefixes. Only the monitors of new prefixes are created,
+ * the monitors of removed prefixes are removed.
+ * \param[in] bottle_location Bottle location directory
+ * \param[in] prefix_paths All bottle prefixes
+ */
+void BottleWatcher::watch(const string& bottle_location, const std::vector<string>& prefix_paths)
+{
+  if (bottle_location != bottle_location_ || !bottle_location_monitor_)
+  {
+    bottle_location_ = bottle_location;
+    bottle_location_monitor_ = monitor_directory(bottle_location);
+    if (bottle_location_monitor_)
+      bottle_location_monitor_->signal_changed().connect(sigc::mem_fun(*this, &BottleWatcher::on_bottle_location_changed));
+  }
+
+  std::set<string> current(prefix_paths.begin(), prefix_paths.end());
+  std::erase_if(prefix_monitors_, [&current](const auto& monitor) { return !current.contains(monitor.first); });
+  for (const string& prefix_path : prefix_paths)
+  {
+    if (prefix_monitors_.contains(prefix_path))
+      continue;
+    Glib::RefPtr<Gio::FileMonitor> monitor = monitor_directory(prefix_path);
+    if (monitor)
+    {
+      monitor->signal_changed().connect(sigc::bind(sigc::mem_fun(*this, &BottleWatcher::on_prefix_changed), prefix_path));
+      prefix_monitors_.emplace(prefix_path, monitor);
+    }
+  }
+}
+
+/**
+ * \brief Ignore the file changes of a bottle prefix, eg. while WineGUI itself changes the bottle
+ * \param[in] prefix_path Bottle prefix
+ */
+void BottleWatcher::mute(const string& prefix_path)
+{
+  muted_prefixes_.insert(prefix_path);
+}
+
+/**
+ * \brief Signal the file changes of a bottle prefix again, see mute()
+ * \param[in] prefix_path Bottle prefix
+ */
+void BottleWatcher::unmute(const string& prefix_path)
+{
+  muted_prefixes_.erase(prefix_path);
+}
+
+/**
+ * \brief Signal handler when the bottle location directory changed, only added/removed (or renamed) bottles are relevant.
+ */
+void BottleWatcher::on_bottle_location_changed(const Glib::RefPtr<Gio::File>& /* file */,
+                                               const Glib::RefPtr<Gio::File>& /* other_file */,
+                                               Gio::FileMonitorEvent event_type)
+{
+  if (event_type == Gio::FILE_MONITOR_EVENT_CREATED || event_type == Gio::FILE_MONITOR_EVENT_DELETED ||
+      event_type == Gio::FILE_MONITOR_EVENT_MOVED || event_type == Gio::FILE_MONITOR_EVENT_MOVED_IN ||
+      event_type == Gio::FILE_MONITOR_EVENT_MOVED_OUT || event_type == Gio::FILE_MONITOR_EVENT_RENAMED)
+  {
+    is_bottle_list_changed_ = true;
+    schedule_signal();
+  }
+}
+
+/**
+ * \brief Signal handler when a file in the bottle prefix directory changed
+ * \param[in] prefix_path Bottle prefix of the monitor
+ */
+void BottleWatcher::on_prefix_changed(const Glib::RefPtr<Gio::File>& file,
+                                      const Glib::RefPtr<Gio::File>& /* other_file */,
+                                      Gio::FileMonitorEvent event_type,
+                                      const string& prefix_path)
+{
+  if (event_type == Gio::FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED || event_type == Gio::FILE_MONITOR_EVENT_PRE_UNMOUNT ||
+      event_type == Gio::FILE_MONITOR_EVENT_UNMOUNTED)
+    return;
+  // Wine writes the registry files to a temporary file first, which is moved to eg. user.reg (reported as created)
+  if (file && !muted_prefixes_.contains(prefix_path) && WatchedPrefixFiles.contains(file->get_basename()))
+  {
+    changed_prefixes_.insert(prefix_path);
+    schedule_signal();
+  }
+}
+
+/**
+ * \brief Signal handler when a file in one of the Wine desktop directories changed
+ */
+void BottleWatcher::on_desktop_dir_changed(const Glib::RefPtr<Gio::File>& file,
+                                           const Glib::RefPtr<Gio::File>& /* other_file */,
+                                           Gio::FileMonitorEvent event_type)
+{
+  if (event_type == Gio::FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED || event_type == Gio::FILE_MONITOR_EVENT_CHANGED)
+    return; // Wait for the changes done hint
+  if (file)
+  {
+    string path = file->get_path();
+    if (event_type == Gio::FILE_MONITOR_EVENT_CREATED && Glib::file_test(path, Glib::FILE_TEST_IS_DIR))
+    {
+      watch_desktop_dir(path);
+    }
+    else if (event_type == Gio::FILE_MONITOR_EVENT_DELETED && path != desktop_dir_)
+    {
+      // Remove the monitors of the removed directory (and its sub-directories)
+      std::erase_if(desktop_dir_monitors_, [&path](const auto& monitor)
+                    { return monitor.first == path || monitor.first.starts_with(path + G_DIR_SEPARATOR_S); });
+    }
+  }
+  is_desktop_files_changed_ = true;
+  schedule_signal();
+}
+
+/**
+ * \brief (Re)start the debounce timeout, the changes are signalled once there are no new file events during the timeout.
+ * When file events keep coming, the changes are signalled anyway after the max debounce delay.
+ */
+void BottleWatcher::schedule_signal()
+{
+  gint64 now = g_get_monotonic_time();
+  if (!debounce_timeout_.connected())
+    first_pending_event_time_ = now;
+  else if (now - first_pending_event_time_ >= MaxDebounceDelay)
+    return; // Let the pending timeout expire
+  debounce_timeout_.disconnect();
+  debounce_timeout_ = Glib::signal_timeout().connect(sigc::mem_fun(*this, &BottleWatcher::on_debounce_timeout), DebounceTimeout);
+}
+
+/**
+ * \brief Debounce timeout expired, signal all the pending changes at once
+ * \return False, to stop the timeout
+ */
+bool BottleWatcher::on_debounce_timeout()
+{
+  bool is_bottle_list_changed = is_bottle_list_changed_;
+  bool is_desktop_files_changed = is_desktop_files_changed_;
+  std::set<string> changed_prefixes;
+  changed_prefixes.swap(changed_prefixes_);
+  is_bottle_list_changed_ = false;
+  is_desktop_files_changed_ = false;
+
+  // A bottle list update inspects all the bottles again
+  if (is_bottle_list_changed)
+    bottle_list_changed.emit();
+  else if (!changed_prefixes.empty())
+    bottles_changed.emit(changed_prefixes);
+  if (is_desktop_files_changed)
+    desktop_files_changed.emit();
+  return false;
+}
+
+/**
+ * \brief Watch a Wine desktop directory and its sub-directories
+ * \param[in] dir_path Directory (the top directory or one of its sub-directories)
+ */
+void BottleWatcher::watch_desktop_dir(const string& dir_path)
+{
+  if (desktop_dir_monitors_.contains(dir_path) ||
+      std::count(dir_path.begin() + std::min(desktop_dir_.size(), dir_path.size()), dir_path.end(), G_DIR_SEPARATOR) > MaxDesktopDirDepth)
+    return;
+  // The top directory is watched even when it doesn't exist yet (eg. no program is installed yet)
+  bool is_dir = Glib::file_test(dir_path, Glib::FILE_TEST_IS_DIR);
+  if (dir_path != desktop_dir_ && !is_dir)
+    return;
+  Glib::RefPtr<Gio::FileMonitor> monitor = monitor_directory(dir_path);
+  if (!monitor)
+    return;
+  monitor->signal_changed().connect(sigc::mem_fun(*this, &BottleWatcher::on_desktop_dir_changed));
+  desktop_dir_monitors_.emplace(dir_path, monitor);
+  if (!is_dir)
+    return;
+
+  try
+  {
+    Glib::Dir dir(dir_path);
+    for (const string& name : dir)
+    {
+      string path = Glib::build_filename(dir_path, name);
+      if (Glib::file_test(path, Glib::FILE_TEST_IS_DIR) && !Glib::file_test(path, Glib::FILE_TEST_IS_SYMLINK))
+        watch_desktop_dir(path);
+    }
+  }
+  catch (const Glib::FileError& error)
+  {
+    std::cerr << "Error: Could not read directory: " << dir_path << ", error: " << error.what() << std::endl;
+  }
+}
+
+/**
+ * \brief Create a directory monitor
+ * \param[in] dir_path Directory
+ * \return Monitor or empty pointer when the directory can't be monitored
+ */
+Glib::RefPtr<Gio::FileMonitor> BottleWatcher::monitor_directory(const string& dir_path)
+{
+  try
+  {
+    return Gio::File::create_for_path(dir_path)->monitor_directory();
+  }
+  catch (const Glib::Error& error)
+  {
+    std::cerr << "Error: Could not watch directory: " << dir_path << ", error: " << error.what() << std::endl;
+  }
+  return Glib::RefPtr<Gio::FileMonitor>();
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    console_buffer.cc
+ * \brief   Bounded in-memory buffer of the program output lines (shown in the console window)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "console_buffer.h"
+#include <algorithm>
+
+/**
+ * \brief Constructor
+ * \param[in] max_line_length Maximum line length in bytes, longer lines are split
+ */
+LineFramer::LineFramer(std::size_t max_line_length) : max_line_length_(max_line_length)
+{
+}
+
+/**
+ * \brief Add output of the process, the callback is called for every completed line
+ * \param[in] chunk Output chunk
+ * \param[in] on_line Called for every line (the line is only valid during the call)
+ */
+void LineFramer::feed(std::string_view chunk, const LineCallback& on_line)
+{
+  while (!chunk.empty())
+  {
+    std::size_t end = chunk.find('\n');
+    if (end == std::string_view::npos)
+    {
+      // Incomplete line, wait for the remaining part
+      partial_line_.append(chunk);
+      while (partial_line_.size() > max_line_length_)
+      {
+        on_line(std::string_view(partial_line_).substr(0, max_line_length_));
+        partial_line_.erase(0, max_line_length_);
+      }
+      return;
+    }
+    if (partial_line_.empty())
+    {
+      // Complete line within the chunk, no copy needed
+      emit_line(chunk.substr(0, end), on_line);
+    }
+    else
+    {
+      partial_line_.append(chunk.substr(0, end));
+      emit_line(partial_line_, on_line);
+      partial_line_.clear();
+    }
+    chunk.remove_prefix(end + 1);
+  }
+}
+
+/**
+ * \brief Process is finished, emit the last line (if it doesn't end with a new line)
+ * \param[in] on_line Line callback
+ */
+void LineFramer::finish(const LineCallback& on_line)
+{
+  if (!partial_line_.empty())
+  {
+    emit_line(partial_line_, on_line);
+    partial_line_.clear();
+  }
+}
+
+/**
+ * \brief Emit the line without carriage return, split in parts when the line is too long
+ */
+void LineFramer::emit_line(std::string_view line, const LineCallback& on_line)
+{
+  if (!line.empty() && line.back() == '\r')
+    line.remove_suffix(1);
+  do
+  {
+    on_line(line.substr(0, max_line_length_));
+    line.remove_prefix(std::min(line.size(), max_line_length_));
+  } while (!line.empty());
+}
+
+/**
+ * \brief Constructor
+ * \param[in] max_lines Maximum number of lines kept in memory
+ * \param[in] max_bytes Maximum total size of the lines kept in memory
+ */
+ConsoleBuffer::ConsoleBuffer(std::size_t max_lines, std::size_t max_bytes)
+    : first_sequence_(0), bytes_(0), max_lines_(max_lines), max_bytes_(max_bytes), is_read_pending_(false)
+{
+}
+
+/**
+ * \brief Append a line (thread-safe), the oldest lines are dropped when the buffer is full
+ * \param[in] source Name of the program, shown in front of the line
+ * \param[in] text Line
+ * \return True when the reader needs to be notified (first line since the last read)
+ */
+bool ConsoleBuffer::append(std::string_view source, std::string_view text)
+{
+  string line;
+  line.reserve(source.size() + text.size() + 3);
+  line.append("[").append(source).append("] ").append(text);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  bytes_ += line.size();
+  lines_.push_back(std::move(line));
+  while (lines_.size() > max_lines_ || (bytes_ > max_bytes_ && lines_.size() > 1))
+  {
+    bytes_ -= lines_.front().size();
+    lines_.pop_front();
+    first_sequence_++;
+  }
+  bool is_notify = !is_read_pending_;
+  is_read_pending_ = true;
+  return is_notify;
+}
+
+/**
+ * \brief Read the lines from the sequence number onwards (thread-safe),
+ * dropped lines are skipped when the reader is behind.
+ * \param[in] sequence Sequence number of the first line to read (the return value of the previous read, 0 at start)
+ * \param[out] lines The lines are appended
+ * \return Sequence number of the next line
+ */
+std::uint64_t ConsoleBuffer::read(std::uint64_t sequence, vector<string>& lines)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_read_pending_ = false;
+  std::uint64_t next_sequence = first_sequence_ + lines_.size();
+  if (sequence < first_sequence_)
+    sequence = first_sequence_;
+  if (sequence < next_sequence)
+    lines.insert(lines.end(), lines_.begin() + static_cast<std::ptrdiff_t>(sequence - first_sequence_), lines_.end());
+  return next_sequence;
+}
+
+/**
+ * \brief Remove all lines (thread-safe), the sequence numbers continue
+ */
+void ConsoleBuffer::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  first_sequence_ += lines_.size();
+  lines_.clear();
+  bytes_ = 0;
+}
+
+/**
+ * \brief Maximum number of lines kept in memory
+ */
+std::size_t ConsoleBuffer::max_lines() const
+{
+  return max_lines_;
+}
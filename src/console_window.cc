@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    console_window.cc
+ * \brief   Live output of the running programs and installs
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "console_window.h"
+#include "console_buffer.h"
+
+/**
+ * \brief Constructor
+ * \param parent Reference to parent GTK Window
+ * \param console_buffer Output lines of the running programs (owned by the bottle manager)
+ */
+ConsoleWindow::ConsoleWindow(Gtk::Window& parent, ConsoleBuffer& console_buffer)
+    : vbox(Gtk::ORIENTATION_VERTICAL, 4),
+      hbox_buttons(Gtk::ORIENTATION_HORIZONTAL, 4),
+      clear_button("Clear"),
+      close_button("Close"),
+      console_buffer_(console_buffer),
+      next_sequence_(0)
+{
+  set_transient_for(parent);
+  set_title("WineGUI Console");
+  set_default_size(900, 500);
+
+  text_view.set_editable(false);
+  text_view.set_cursor_visible(false);
+  text_view.set_monospace(true);
+  text_view.set_wrap_mode(Gtk::WRAP_CHAR);
+  end_mark_ = text_view.get_buffer()->create_mark("end", text_view.get_buffer()->end(), false);
+
+  scrolled_window.set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
+  scrolled_window.set_margin_top(5);
+  scrolled_window.set_margin_end(5);
+  scrolled_window.set_margin_start(5);
+  scrolled_window.add(text_view);
+
+  hbox_buttons.pack_end(close_button, false, false, 4);
+  hbox_buttons.pack_end(clear_button, false, false, 4);
+
+  vbox.pack_start(scrolled_window, true, true, 4);
+  vbox.pack_start(hbox_buttons, false, false, 4);
+  add(vbox);
+
+  // Signals
+  clear_button.signal_clicked().connect(sigc::mem_fun(*this, &ConsoleWindow::on_clear_button_clicked));
+  close_button.signal_clicked().connect(sigc::mem_fun(*this, &ConsoleWindow::hide));
+
+  show_all_children();
+}
+
+/**
+ * \brief Destructor
+ */
+ConsoleWindow::~ConsoleWindow()
+{
+}
+
+/**
+ * \brief Same as show() but will also add the output lines received until now
+ */
+void ConsoleWindow::show()
+{
+  update();
+  // Call parent show
+  Gtk::Widget::show();
+  text_view.scroll_to(end_mark_);
+}
+
+/**
+ * \brief Add the new lines of the console buffer (called in the GUI thread, when lines are appended)
+ */
+void ConsoleWindow::update()
+{
+  std::vector<std::string> lines;
+  next_sequence_ = console_buffer_.read(next_sequence_, lines);
+  if (lines.empty())
+    return;
+
+  // Only follow the output when the view is already scrolled to the end
+  auto adjustment = scrolled_window.get_vadjustment();
+  bool is_at_end = adjustment->get_value() + adjustment->get_page_size() >= adjustment->get_upper() - 1.0;
+
+  // Program output isn't always valid UTF-8 (eg. Windows code pages), invalid bytes are replaced
+  Glib::ustring text;
+  for (const std::string& line : lines)
+  {
+    gchar* valid_line = g_utf8_make_valid(line.data(), static_cast<gssize>(line.size()));
+    text.append(valid_line).append("\n");
+    g_free(valid_line);
+  }
+  auto text_buffer = text_view.get_buffer();
+  text_buffer->insert(text_buffer->end(), text);
+
+  // Same limit as the console buffer, drop the oldest lines
+  int max_lines = static_cast<int>(console_buffer_.max_lines());
+  int line_count = text_buffer->get_line_count() - 1; // Last line is empty
+  if (line_count > max_lines)
+    text_buffer->erase(text_buffer->begin(), text_buffer->get_iter_at_line(line_count - max_lines));
+
+  if (is_at_end)
+    text_view.scroll_to(end_mark_);
+}
+
+/**
+ * \brief Triggered when clear button is clicked
+ */
+void ConsoleWindow::on_clear_button_clicked()
+{
+  console_buffer_.clear();
+  text_view.get_buffer()->set_text("");
+}
@@ -0,0 +1,129 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    desktop_entry_index.cc
+ * \brief   Index of the Linux desktop files which are created by Wine (menu & desktop shortcuts)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "desktop_entry_index.h"
+#include <glibmm/fileutils.h>
+#include <glibmm/keyfile.h>
+#include <glibmm/miscutils.h>
+#include <iostream>
+#include <sys/stat.h>
+
+//// Group of the desktop entry keys (freedesktop.org Desktop Entry Specification)
+static const char* DesktopEntryGroup = "Desktop Entry";
+//// File extension of the desktop files
+static const string DesktopFileExtension = ".desktop";
+
+/// Meyers Singleton
+DesktopEntryIndex::DesktopEntryIndex() = default;
+/// Destructor
+DesktopEntryIndex::~DesktopEntryIndex() = default;
+
+/**
+ * \brief Get singleton instance
+ * \return DesktopEntryIndex reference (singleton)
+ */
+DesktopEntryIndex& DesktopEntryIndex::get_instance()
+{
+  static DesktopEntryIndex instance;
+  return instance;
+}
+
+/**
+ * \brief Lookup a desktop file, its directory is (re)indexed when needed
+ * \param[in] file_path Desktop file path (eg. ~/.local/share/applications/wine/Programs/Notepad++.desktop)
+ * \return Desktop entry or no value when the desktop file doesn't exist (or has no desktop entry group)
+ */
+std::optional<DesktopEntryIndex::Entry> DesktopEntryIndex::get_entry(const string& file_path)
+{
+  string dir_path = Glib::path_get_dirname(file_path);
+  string file_name = Glib::path_get_basename(file_path);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  struct stat dir_stat;
+  if (stat(dir_path.c_str(), &dir_stat) != 0)
+  {
+    directories_.erase(dir_path);
+    return std::nullopt;
+  }
+  std::int64_t modified_ns = static_cast<std::int64_t>(dir_stat.st_mtim.tv_sec) * 1000000000LL + dir_stat.st_mtim.tv_nsec;
+  auto it = directories_.find(dir_path);
+  if (it == directories_.end() || it->second.modified_ns != modified_ns)
+    it = directories_.insert_or_assign(dir_path, read_directory(dir_path, modified_ns)).first;
+
+  auto entry = it->second.entries.find(file_name);
+  if (entry == it->second.entries.end())
+    return std::nullopt;
+  return entry->second;
+}
+
+/**
+ * \brief Remove all the indexed directories, eg. when desktop files are rewritten in place
+ * (which doesn't change the modification time of the directory)
+ */
+void DesktopEntryIndex::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  directories_.clear();
+}
+
+/**
+ * \brief Parse all the desktop files in a directory (not recursive)
+ * \param[in] dir_path Directory
+ * \param[in] modified_ns Modification time of the directory
+ * \return Indexed directory (without entries when the directory couldn't be read)
+ */
+DesktopEntryIndex::Directory DesktopEntryIndex::read_directory(const string& dir_path, std::int64_t modified_ns)
+{
+  Directory directory{modified_ns, {}};
+  try
+  {
+    Glib::Dir dir(dir_path);
+    for (const string& name : dir)
+    {
+      if (!name.ends_with(DesktopFileExtension))
+        continue;
+      string path = Glib::build_filename(dir_path, name);
+      try
+      {
+        Glib::KeyFile keyfile;
+        keyfile.load_from_file(path);
+        if (!keyfile.has_group(DesktopEntryGroup))
+          continue;
+        Entry entry;
+        if (keyfile.has_key(DesktopEntryGroup, "Icon"))
+          entry.icon = keyfile.get_string(DesktopEntryGroup, "Icon");
+        if (keyfile.has_key(DesktopEntryGroup, "Comment"))
+          entry.comment = keyfile.get_locale_string(DesktopEntryGroup, "Comment");
+        if (keyfile.has_key(DesktopEntryGroup, "Exec"))
+          entry.exec = keyfile.get_string(DesktopEntryGroup, "Exec");
+        directory.entries.emplace(name, std::move(entry));
+      }
+      catch (const Glib::Error& error)
+      {
+        std::cerr << "Error: Could not read desktop file: " << path << ", error: " << error.what() << std::endl;
+      }
+    }
+  }
+  catch (const Glib::FileError& error)
+  {
+    std::cerr << "Error: Could not read directory: " << dir_path << ", error: " << error.what() << std::endl;
+  }
+  return directory;
+}
@@ -19,6 +19,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "general_config_file.h"
+#include "startup_profiler.h"
 #include <giomm.h>
 #include <glibmm.h>
 #include <iostream>
@@ -57,6 +58,7 @@ bool GeneralConfigFile::write_config_file(const GeneralConfigData& general_confi
     keyfile.set_string("General", "DefaultFolder", general_config.default_folder);
     keyfile.set_boolean("General", "DisplayDefaultWineMachine", general_config.display_default_wine_machine);
     keyfile.set_boolean("General", "EnableLoggingStderr", general_config.enable_logging_stderr);
+    keyfile.set_integer("General", "LogCompressionCpuShare", general_config.log_compression_cpu_share);
     success = keyfile.save_to_file(config_file_path);
   }
   catch (const Glib::Error& ex)
@@ -91,13 +93,18 @@ GeneralConfigData GeneralConfigFile::read_config_file()
 
   // Execute migration (if required)
   // Returns the default prefix folder, depending if there are bottles found in the old prefix location
-  std::string final_default_prefix_folder = config_and_folder_migration(config_file_path, default_prefix_folder);
+  std::string final_default_prefix_folder;
+  {
+    StartupProfiler::Scope scope("Config migration");
+    final_default_prefix_folder = config_and_folder_migration(config_file_path, default_prefix_folder);
+  }
 
   struct GeneralConfigData general_config;
   // Defaults config values
   general_config.default_folder = final_default_prefix_folder;
   general_config.display_default_wine_machine = true;
   general_config.enable_logging_stderr = true;
+  general_config.log_compression_cpu_share = 25;
 
   // Check if config file exists
   if (!Glib::file_test(config_file_path, Glib::FileTest::FILE_TEST_IS_REGULAR))
@@ -114,6 +121,9 @@ GeneralConfigData GeneralConfigFile::read_config_file()
       general_config.default_folder = keyfile.get_string("General", "DefaultFolder");
       general_config.display_default_wine_machine = keyfile.get_boolean("General", "DisplayDefaultWineMachine");
       general_config.enable_logging_stderr = keyfile.get_boolean("General", "EnableLoggingStderr");
+      // Added later, older config files don't have this key yet
+      if (keyfile.has_key("General", "LogCompressionCpuShare"))
+        general_config.log_compression_cpu_share = keyfile.get_integer("General", "LogCompressionCpuShare");
     }
     catch (const Glib::Error& ex)
     {
@@ -19,6 +19,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "helper.h"
+#include "desktop_entry_index.h"
+#include "registry_hive.h"
+#include "registry_query.h"
+#include "registry_tokenizer.h"
+#include "registry_writer.h"
+#include "shell_link.h"
 #include "wine_defaults.h"
 #include <algorithm>
 #include <array>
@@ -32,11 +38,16 @@
 #include <glibmm/timeval.h>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <pwd.h>
 #include <regex>
+#include <sstream>
 #include <stdexcept>
 #include <stdio.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
 #include <tuple>
@@ -51,9 +62,25 @@ static const string DefaultBottleWineDir = Glib::build_path(G_DIR_SEPARATOR_S, d
 // Wine & Winetricks exec
 static const string WineExecutable = "wine";     /*!< Currently expect to be installed globally */
 static const string WineExecutable64 = "wine64"; /*!< Currently expect to be installed globally */
+static const string WinetricksDownloadUrl = "https://raw.githubusercontent.com/Winetricks/winetricks/master/src/winetricks";
 static const string WinetricksExecutable =
     Glib::build_filename(WineGuiDataDir, "winetricks"); /*!< winetricks shall be located within the WineGUI data directory */
 
+//// Cached Wine version of a Wine binary, only valid as long as the binary is unchanged (same inode & modification time)
+struct WineVersionCacheEntry
+{
+  dev_t device;
+  ino_t inode;
+  std::int64_t modified_ns;
+  string version;
+};
+static std::mutex wine_version_cache_mutex;                        /*!< The Wine version is also retrieved by the bottle loading thread */
+static std::map<string, WineVersionCacheEntry> wine_version_cache; /*!< Resolved Wine binary path -> cache entry */
+
+// Images
+static const string ImageResourcePath = "/org/melroy/winegui/images/"; /*!< Images compiled into the binary, see winegui.gresource.xml */
+static const char* ImageOverrideDirEnv = "WINEGUI_IMAGE_DIR";          /*!< Optional directory with images that override the compiled images */
+
 // Reg files
 static const string SystemReg = "system.reg";
 static const string UserReg = "user.reg";
@@ -187,11 +214,11 @@ vector<string> Helper::get_bottles_paths(const string& dir_path, bool display_de
 
 /**
  * \brief Run any program with only setting the WINEPREFIX env variable (run this method async).
- * Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
- * Improvement/TODO: We could now also log the output from the program into a GUI console window.
+ * The program is started directly (without a shell), so the arguments don't need any quoting.
+ * Programs started by the user are run via the process supervisor instead, see BottleManager::start_job().
  * \param[in] prefix_path The path to wine bottle
  * \param[in] debug_log_level Debug log level
- * \param[in] program Program that gets executed (ideally full path)
+ * \param[in] argv Program that gets executed (ideally full path), followed by its arguments
  * \param[in] working_directory Working directory of where the program will be executed
  * \param[in] give_error Inform user when application exit with non-zero exit code
  * \param[in] stderr_output Also output stderr (together with stout)
@@ -200,48 +227,28 @@ vector<string> Helper::get_bottles_paths(const string& dir_path, bool display_de
  */
 string Helper::run_program(const string& prefix_path,
                            int debug_log_level,
-                           const string& program,
+                           const vector<string>& argv,
                            const string& working_directory,
                            const vector<pair<string, string>>& env_vars,
                            bool give_error,
                            bool stderr_output)
 {
-  string output;
-
-  string debug = (debug_log_level != 1) ? "WINEDEBUG=" + Helper::log_level_to_winedebug_string(debug_log_level) + " " : "";
-  string exec_program = (stderr_output) ? program + " 2>&1" : program;
-  string change_directory = working_directory.empty() ? "" : "cd \"" + working_directory + "\" && ";
-  string env_vars_str(debug + "WINEPREFIX=\"" + prefix_path + "\" ");
-
-  // Convert key/value pair to string, append to env_vars_str
-  for (const auto& [key, value] : env_vars)
-  {
-    env_vars_str += key + "=\"" + value + "\" ";
-  }
-
-  string command = change_directory + env_vars_str + exec_program;
+  ProcessOptions options = program_options(prefix_path, debug_log_level, working_directory, env_vars, stderr_output);
   if (give_error)
   {
-    // Execute the command that also shows an error message to the user when exit code is non-zero
-    output = exec_error_message(command);
-  }
-  else
-  {
-    // No error message when exit code is non-zero, but we can still return the output and log to disk (if logging is enabled)
-    const auto& [_, output_value] = exec(command);
-    output = output_value;
+    // Execute the program that also shows an error message to the user when exit code is non-zero
+    return exec_error_message(argv, options);
   }
-  return output;
+  // No error message when exit code is non-zero, but we can still return the output and log to disk (if logging is enabled)
+  return exec(argv, options).second;
 }
 
 /**
  * \brief Run a Windows program under Wine (run this method async).
- * Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
  * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary
  * \param[in] prefix_path The path to bottle wine
  * \param[in] debug_log_level Debug log level
- * \param[in] program Program/executable that will be executed (be sure your application executable is between
- * brackets in case of spaces)
+ * \param[in] argv Wine program/executable that will be executed followed by its arguments, eg. {"start", "/unix", path}
  * \param[in] working_directory Working directory of where the program will be executed
  * \param[in] give_error Inform user when application exit with non-zero exit code
  * \param[in] stderr_output Also output stderr (together with stout)
@@ -251,34 +258,40 @@ string Helper::run_program(const string& prefix_path,
 string Helper::run_program_under_wine(bool wine_64_bit,
                                       const string& prefix_path,
                                       int debug_log_level,
-                                      const string& program,
+                                      const vector<string>& argv,
                                       const string& working_directory,
                                       const vector<pair<string, string>>& env_vars,
                                       bool give_error,
                                       bool stderr_output)
 {
-  return Helper::run_program(prefix_path, debug_log_level, Helper::get_wine_executable_location(wine_64_bit) + " " + program, working_directory,
-                             env_vars, give_error, stderr_output);
+  vector<string> wine_argv{Helper::get_wine_executable_location(wine_64_bit)};
+  wine_argv.insert(wine_argv.end(), argv.begin(), argv.end());
+  return Helper::run_program(prefix_path, debug_log_level, wine_argv, working_directory, env_vars, give_error, stderr_output);
 }
 
 /**
- * \brief Write/append logging to WineGUI log file
- * \param logging_bottle_prefix Wine Bottle prefix location
- * \param logging Logging data
+ * \brief Launch options of a program run in a bottle
+ * \param[in] prefix_path The path to wine bottle
+ * \param[in] debug_log_level Debug log level (sets WINEDEBUG, except for the default level)
+ * \param[in] working_directory Working directory of where the program will be executed
+ * \param[in] env_vars Additional environment variables (eg. of the bottle)
+ * \param[in] stderr_output Also output stderr (together with stout)
+ * \return Process options
  */
-void Helper::write_to_log_file(const string& logging_bottle_prefix, const string& logging)
+ProcessOptions Helper::program_options(const string& prefix_path,
+                                       int debug_log_level,
+                                       const string& working_directory,
+                                       const vector<pair<string, string>>& env_vars,
+                                       bool stderr_output)
 {
-  string log_path = Helper::get_log_file_path(logging_bottle_prefix);
-  auto file = Gio::File::create_for_path(log_path);
-  try
-  {
-    auto output = file->append_to(Gio::FileCreateFlags::FILE_CREATE_NONE);
-    output->write(logging);
-  }
-  catch (const Glib::Error& ex)
-  {
-    std::cerr << "Error: Couldn't write debug logging to log file. Error " << ex.what() << std::endl;
-  }
+  ProcessOptions options;
+  options.working_directory = working_directory;
+  options.merge_stderr = stderr_output;
+  if (debug_log_level != 1)
+    options.env_vars.emplace_back("WINEDEBUG", Helper::log_level_to_winedebug_string(debug_log_level));
+  options.env_vars.emplace_back("WINEPREFIX", prefix_path);
+  options.env_vars.insert(options.env_vars.end(), env_vars.begin(), env_vars.end());
+  return options;
 }
 
 /**
@@ -296,7 +309,7 @@ string Helper::get_log_file_path(const string& logging_bottle_prefix)
  */
 void Helper::wait_until_wineserver_is_terminated(const string& prefix_path)
 {
-  const auto& [exit_code, output] = exec("WINEPREFIX=\"" + prefix_path + "\" timeout 60 wineserver -w 2>&1");
+  const auto& [exit_code, output] = exec({"timeout", "60", "wineserver", "-w"}, {.env_vars = {{"WINEPREFIX", prefix_path}}});
   if (exit_code == 124)
   {
     std::cout << "INFO: Time-out of wineserver wait command triggered (wineserver is still running..)" << std::endl;
@@ -310,24 +323,12 @@ void Helper::wait_until_wineserver_is_terminated(const string& prefix_path)
  */
 int Helper::determine_wine_executable()
 {
-  int return_status = -1;
-  // Try wine 32-bit
-  const auto& [exit_code32, _] = exec("command -v " + Helper::get_wine_executable_location(false));
-  if (exit_code32 == 0)
-  {
-    return_status = 0;
-  }
-  // Try wine 64-bit
-  if (return_status != 0)
-  {
-    // cppcheck-suppress shadowVariable
-    const auto& [exit_code64, _] = exec("command -v " + Helper::get_wine_executable_location(true));
-    if (exit_code64 == 0)
-    {
-      return_status = 1;
-    }
-  }
-  return return_status;
+  // PATH lookup, without spawning a shell
+  if (!find_wine_executable(false).empty())
+    return 0;
+  if (!find_wine_executable(true).empty())
+    return 1;
+  return -1;
 }
 
 /**
@@ -347,6 +348,25 @@ string Helper::get_wine_executable_location(bool bit64)
   }
 }
 
+/**
+ * \brief Find the Wine executable in the PATH environment variable (no shell is spawned)
+ * \param bit64 Use Wine 64 bit or 32 bit binary
+ * \return Absolute path of the Wine binary or empty string when not found
+ */
+string Helper::find_wine_executable(bool bit64)
+{
+  return Glib::find_program_in_path(Helper::get_wine_executable_location(bit64));
+}
+
+/**
+ * \brief Get the WineGUI data directory (eg. ~/.local/share/winegui)
+ * \return the full path to the WineGUI data directory
+ */
+string Helper::get_winegui_data_dir()
+{
+  return WineGuiDataDir;
+}
+
 /**
  * \brief Get the Winetricks binary location
  * \return the full path to Winetricks
@@ -373,7 +393,24 @@ string Helper::get_winetricks_location()
  */
 string Helper::get_wine_version(bool wine_64_bit)
 {
-  const auto& [exit_code, output] = exec(Helper::get_wine_executable_location(wine_64_bit) + " --version 2>&1");
+  // The version is only determined again (by starting Wine) when the Wine binary is changed
+  string executable_path = find_wine_executable(wine_64_bit);
+  struct stat file_stat;
+  bool is_cacheable = !executable_path.empty() && stat(executable_path.c_str(), &file_stat) == 0;
+  WineVersionCacheEntry entry{};
+  if (is_cacheable)
+  {
+    entry.device = file_stat.st_dev;
+    entry.inode = file_stat.st_ino;
+    entry.modified_ns = static_cast<std::int64_t>(file_stat.st_mtim.tv_sec) * 1000000000LL + file_stat.st_mtim.tv_nsec;
+    std::lock_guard<std::mutex> lock(wine_version_cache_mutex);
+    auto it = wine_version_cache.find(executable_path);
+    if (it != wine_version_cache.end() && it->second.device == entry.device && it->second.inode == entry.inode &&
+        it->second.modified_ns == entry.modified_ns)
+      return it->second.version;
+  }
+
+  const auto& [exit_code, output] = exec({Helper::get_wine_executable_location(wine_64_bit), "--version"});
   if (exit_code == 0 && !output.empty())
   {
     vector<string> results = split(output, '-');
@@ -386,6 +423,12 @@ string Helper::get_wine_version(bool wine_64_bit)
         string version = results2.at(0); // just only get the version number (eg. 6.0)
         // Remove new lines
         version.erase(std::remove(version.begin(), version.end(), '\n'), version.end());
+        if (is_cacheable)
+        {
+          entry.version = version;
+          std::lock_guard<std::mutex> lock(wine_version_cache_mutex);
+          wine_version_cache.insert_or_assign(executable_path, entry);
+        }
         return version;
       }
       else
@@ -446,20 +489,22 @@ string Helper::open_file_from_uri(const string& uri)
  */
 void Helper::create_wine_bottle(bool wine_64_bit, const string& prefix_path, BottleTypes::Bit bit, const bool disable_gecko_mono)
 {
-  string wine_arch = "";
+  ProcessOptions options;
+  options.env_vars.emplace_back("WINEPREFIX", prefix_path);
   switch (bit)
   {
   case BottleTypes::Bit::win32:
-    wine_arch = " WINEARCH=win32";
+    options.env_vars.emplace_back("WINEARCH", "win32");
     break;
   case BottleTypes::Bit::win64:
-    wine_arch = " WINEARCH=win64";
+    options.env_vars.emplace_back("WINEARCH", "win64");
     break;
   }
-  string wine_dll_overrides = (disable_gecko_mono) ? " WINEDLLOVERRIDES=\"mscoree=d;mshtml=d\"" : "";
-  string command =
-      "WINEPREFIX=\"" + prefix_path + "\"" + wine_arch + wine_dll_overrides + " " + Helper::get_wine_executable_location(wine_64_bit) + " wineboot";
-  const auto& [exit_code, output] = exec(command + " 2>&1");
+  if (disable_gecko_mono)
+    options.env_vars.emplace_back("WINEDLLOVERRIDES", "mscoree=d;mshtml=d");
+  vector<string> argv{Helper::get_wine_executable_location(wine_64_bit), "wineboot"};
+  string command = Process::to_display_string(argv, options.env_vars);
+  const auto& [exit_code, output] = exec(argv, options);
   if (exit_code != 0)
   {
     std::cerr << "Error: Couldn't create Wine bottle. Command: " << command << ", output: " << output << std::endl;
@@ -477,7 +522,7 @@ void Helper::remove_wine_bottle(const string& prefix_path)
 {
   if (Helper::dir_exists(prefix_path))
   {
-    const auto& [exit_code, output] = exec("rm -rf \"" + prefix_path + "\" 2>&1");
+    const auto& [exit_code, output] = exec({"rm", "-rf", prefix_path});
     if (exit_code != 0)
     {
       std::cerr << "Error: Couldn't remove Wine bottle. Wine prefix path: " << prefix_path << ", output: " << output << std::endl;
@@ -503,7 +548,7 @@ void Helper::rename_wine_bottle_folder(const string& current_prefix_path, const
 {
   if (Helper::dir_exists(current_prefix_path))
   {
-    const auto& [exit_code, output] = exec("mv \"" + current_prefix_path + "\" \"" + new_prefix_path + "\" 2>&1");
+    const auto& [exit_code, output] = exec({"mv", current_prefix_path, new_prefix_path});
     if (exit_code != 0)
     {
       std::cerr << "Error: Couldn't rename Wine bottle. Wine prefix path: " << current_prefix_path << ", output: " << output << std::endl;
@@ -529,7 +574,7 @@ void Helper::copy_wine_bottle_folder(const string& source_prefix_path, const str
 {
   if (Helper::dir_exists(source_prefix_path))
   {
-    const auto& [exit_code, output] = exec("cp -r \"" + source_prefix_path + "\" \"" + destination_prefix_path + "\" 2>&1");
+    const auto& [exit_code, output] = exec({"cp", "-r", source_prefix_path, destination_prefix_path});
     if (exit_code != 0)
     {
       std::cerr << "Error: Couldn't copy Wine bottle. Wine prefix path: " << source_prefix_path << ", output: " << output << std::endl;
@@ -556,6 +601,40 @@ string Helper::get_folder_name(const string& prefix_path)
   return get_bottle_dir_from_prefix(prefix_path);
 }
 
+/**
+ * \brief Add the registry values to the query that are needed for the bottle summary in the bottle list
+ * (Windows version, bitness and status)
+ * \param[in,out] registry Registry query
+ * \param[in] prefix_path Bottle prefix
+ */
+void Helper::add_bottle_summary_query(RegistryQuery& registry, const string& prefix_path)
+{
+  string user_reg_file_path = Glib::build_filename(prefix_path, UserReg);
+  string system_reg_file_path = Glib::build_filename(prefix_path, SystemReg);
+  registry.add_value(user_reg_file_path, RegKeyWine, RegNameWindowsVersion);
+  registry.add_meta_data(user_reg_file_path, "arch");
+  registry.add_value(system_reg_file_path, RegKeyNameNT, RegNameNTVersion);
+  registry.add_value(system_reg_file_path, RegKeyNameNT, RegNameNTBuildNumber);
+  registry.add_value(system_reg_file_path, RegKeyType, RegNameProductType);
+  registry.add_value(system_reg_file_path, RegKeyType2, RegNameProductType);
+  registry.add_value(system_reg_file_path, RegKeyName9x, RegName9xVersion);
+}
+
+/**
+ * \brief Add all the registry values to the query that are needed for the bottle details
+ * (summary values, see add_bottle_summary_query(), with the audio driver and virtual desktop)
+ * \param[in,out] registry Registry query
+ * \param[in] prefix_path Bottle prefix
+ */
+void Helper::add_bottle_details_query(RegistryQuery& registry, const string& prefix_path)
+{
+  add_bottle_summary_query(registry, prefix_path);
+  string user_reg_file_path = Glib::build_filename(prefix_path, UserReg);
+  registry.add_value(user_reg_file_path, RegKeyAudio, RegNameAudio);
+  registry.add_value(user_reg_file_path, RegKeyVirtualDesktop, RegNameVirtualDesktop);
+  registry.add_value(user_reg_file_path, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault);
+}
+
 /**
  * \brief Get current Windows OS version
  * \param[in] prefix_path Bottle prefix
@@ -563,11 +642,26 @@ string Helper::get_folder_name(const string& prefix_path)
  * \return Return the Windows OS version
  */
 BottleTypes::Windows Helper::get_windows_version(const string& prefix_path)
+{
+  RegistryQuery registry;
+  add_bottle_details_query(registry, prefix_path);
+  registry.execute();
+  return get_windows_version(registry, prefix_path);
+}
+
+/**
+ * \brief Get current Windows OS version from an executed registry query
+ * \param[in] registry Executed registry query, see add_bottle_details_query()
+ * \param[in] prefix_path Bottle prefix
+ * \throws runtime_error when Windows registry could not be opened or could not determine Windows version
+ * \return Return the Windows OS version
+ */
+BottleTypes::Windows Helper::get_windows_version(const RegistryQuery& registry, const string& prefix_path)
 {
   // Trying user registry first
   string user_reg_file_path = Glib::build_filename(prefix_path, UserReg);
 
-  string win_version = Helper::get_reg_value(user_reg_file_path, RegKeyWine, RegNameWindowsVersion);
+  const string& win_version = registry.get_value(user_reg_file_path, RegKeyWine, RegNameWindowsVersion);
   if (!win_version.empty())
   {
     for (unsigned int i = 0; i < WindowsStructSize; i++)
@@ -583,48 +677,46 @@ BottleTypes::Windows Helper::get_windows_version(const string& prefix_path)
   // Trying system registry
   string system_reg_file_path = Glib::build_filename(prefix_path, SystemReg);
   string version = "";
-  if (!(version = Helper::get_reg_value(system_reg_file_path, RegKeyNameNT, RegNameNTVersion)).empty())
+  if (!(version = registry.get_value(system_reg_file_path, RegKeyNameNT, RegNameNTVersion)).empty())
   {
-    string build_number_nt = Helper::get_reg_value(system_reg_file_path, RegKeyNameNT, RegNameNTBuildNumber);
-    string type_nt = Helper::get_reg_value(system_reg_file_path, RegKeyType, RegNameProductType);
+    const string& build_number_nt = registry.get_value(system_reg_file_path, RegKeyNameNT, RegNameNTBuildNumber);
+    string type_nt = registry.get_value(system_reg_file_path, RegKeyType, RegNameProductType);
     if (type_nt.empty())
     {
       // Check the second registry location
-      type_nt = Helper::get_reg_value(system_reg_file_path, RegKeyType2, RegNameProductType);
+      type_nt = registry.get_value(system_reg_file_path, RegKeyType2, RegNameProductType);
     }
-    // Find the correct Windows version, comparing the version, build number and NT type (if present)
-    for (unsigned int i = 0; i < WindowsStructSize; i++)
+    // Check if version + build number matches (and the NT type, if present)
+    auto is_exact_match = [&](unsigned int i)
     {
-      // Check if version + build number matches
-      if (((WindowsVersions[i].versionNumber).compare(version) == 0) && ((WindowsVersions[i].buildNumber).compare(build_number_nt) == 0))
+      return (WindowsVersions[i].versionNumber).compare(version) == 0 && (WindowsVersions[i].buildNumber).compare(build_number_nt) == 0 &&
+             (type_nt.empty() || (WindowsVersions[i].productType).compare(type_nt) == 0);
+    };
+    // Find the correct Windows version, the first Windows version is compared before the build number fall-back below,
+    // the other Windows versions after the fall-back
+    if (is_exact_match(0))
+    {
+      return WindowsVersions[0].windows;
+    }
+
+    // Fall-back - return the Windows version based on build NT number, even if the version number doesn't exactly match
+    if (!type_nt.empty())
+    {
+      for (unsigned int x = 0; x < WindowsStructSize; x++)
       {
-        if (!type_nt.empty())
-        {
-          if ((WindowsVersions[i].productType).compare(type_nt) == 0)
-          {
-            return WindowsVersions[i].windows;
-          }
-        }
-        else
+        // Check if build number + NT type matches
+        if ((WindowsVersions[x].buildNumber).compare(build_number_nt) == 0 && (WindowsVersions[x].productType).compare(type_nt) == 0)
         {
-          return WindowsVersions[i].windows;
+          return WindowsVersions[x].windows;
         }
       }
+    }
 
-      // Fall-back - return the Windows version based on build NT number, even if the version number doesn't exactly match
-      for (unsigned int x = 0; x < WindowsStructSize; x++)
+    for (unsigned int i = 1; i < WindowsStructSize; i++)
+    {
+      if (is_exact_match(i))
       {
-        // Check if build number matches
-        if ((WindowsVersions[x].buildNumber).compare(build_number_nt) == 0)
-        {
-          if (!type_nt.empty())
-          {
-            if ((WindowsVersions[x].productType).compare(type_nt) == 0)
-            {
-              return WindowsVersions[x].windows;
-            }
-          }
-        }
+        return WindowsVersions[i].windows;
       }
     }
 
@@ -634,32 +726,25 @@ BottleTypes::Windows Helper::get_windows_version(const string& prefix_path)
       // Check if version matches
       if ((WindowsVersions[y].versionNumber).compare(version) == 0)
       {
-        if (!type_nt.empty())
-        {
-          if ((WindowsVersions[y].productType).compare(type_nt) == 0)
-          {
-            return WindowsVersions[y].windows;
-          }
-        }
-        else
+        if (type_nt.empty() || (WindowsVersions[y].productType).compare(type_nt) == 0)
         {
           return WindowsVersions[y].windows;
         }
       }
     }
   }
-  else if (!(version = Helper::get_reg_value(system_reg_file_path, RegKeyName9x, RegName9xVersion)).empty())
+  else if (!(version = registry.get_value(system_reg_file_path, RegKeyName9x, RegName9xVersion)).empty())
   {
     string current_version = "";
     string current_build_number = "";
     vector<string> version_list = split(version, '.');
     // Only get minor & major
-    if (sizeof(version_list) >= 2)
+    if (version_list.size() >= 2)
     {
       current_version = version_list.at(0) + '.' + version_list.at(1);
     }
     // Get build number
-    if (sizeof(version_list) >= 3)
+    if (version_list.size() >= 3)
     {
       current_build_number = version_list.at(2);
     }
@@ -694,11 +779,25 @@ BottleTypes::Windows Helper::get_windows_version(const string& prefix_path)
  * \return 32-bit or 64-bit
  */
 BottleTypes::Bit Helper::get_windows_bitness(const string& prefix_path)
+{
+  RegistryQuery registry;
+  add_bottle_details_query(registry, prefix_path);
+  registry.execute();
+  return get_windows_bitness(registry, prefix_path);
+}
+
+/**
+ * \brief Get system processor bit (32/64) from an executed registry query. *Throw runtime_error* when not found.
+ * \param[in] registry Executed registry query, see add_bottle_details_query()
+ * \param[in] prefix_path Bottle prefix
+ * \throws runtime_error when Windows registry could not be opened or could not determine Windows version
+ * \return 32-bit or 64-bit
+ */
+BottleTypes::Bit Helper::get_windows_bitness(const RegistryQuery& registry, const string& prefix_path)
 {
   string file_path = Glib::build_filename(prefix_path, UserReg);
 
-  string meta_value_name = "arch";
-  string value = Helper::Helper::get_reg_meta_data(file_path, meta_value_name);
+  const string& value = registry.get_meta_data(file_path, "arch");
   if (!value.empty())
   {
     if (value.compare("win32") == 0)
@@ -731,9 +830,24 @@ BottleTypes::Bit Helper::get_windows_bitness(const string& prefix_path)
  * \return Audio Driver (eg. alsa/coreaudio/oss/pulse)
  */
 BottleTypes::AudioDriver Helper::get_audio_driver(const string& prefix_path)
+{
+  RegistryQuery registry;
+  add_bottle_details_query(registry, prefix_path);
+  registry.execute();
+  return get_audio_driver(registry, prefix_path);
+}
+
+/**
+ * \brief Get Audio driver from an executed registry query
+ * \param[in] registry Executed registry query, see add_bottle_details_query()
+ * \param[in] prefix_path Bottle prefix
+ * \throws runtime_error when Windows registry could not be opened
+ * \return Audio Driver (eg. alsa/coreaudio/oss/pulse)
+ */
+BottleTypes::AudioDriver Helper::get_audio_driver(const RegistryQuery& registry, const string& prefix_path)
 {
   string file_path = Glib::build_filename(prefix_path, UserReg);
-  string value = Helper::get_reg_value(file_path, RegKeyAudio, RegNameAudio);
+  const string& value = registry.get_value(file_path, RegKeyAudio, RegNameAudio);
   if (!value.empty())
   {
     if (value.compare("pulse") == 0)
@@ -776,16 +890,31 @@ BottleTypes::AudioDriver Helper::get_audio_driver(const string& prefix_path)
  * \return Return the virtual desktop resolution or empty string when disabled fully.
  */
 string Helper::get_virtual_desktop(const string& prefix_path)
+{
+  RegistryQuery registry;
+  add_bottle_details_query(registry, prefix_path);
+  registry.execute();
+  return get_virtual_desktop(registry, prefix_path);
+}
+
+/**
+ * \brief Get emulation resolution from an executed registry query
+ * \param[in] registry Executed registry query, see add_bottle_details_query()
+ * \param[in] prefix_path Bottle prefix
+ * \throws runtime_error when Windows registry could not be opened
+ * \return Return the virtual desktop resolution or empty string when disabled fully.
+ */
+string Helper::get_virtual_desktop(const RegistryQuery& registry, const string& prefix_path)
 {
   string file_path = Glib::build_filename(prefix_path, UserReg);
   // Check if emulate desktop is enabled. Eg. "Desktop"="Default"
-  string emulate_desktop_value = Helper::get_reg_value(file_path, RegKeyVirtualDesktop, RegNameVirtualDesktop);
+  const string& emulate_desktop_value = registry.get_value(file_path, RegKeyVirtualDesktop, RegNameVirtualDesktop);
   string resolution;
   if (!emulate_desktop_value.empty())
   {
     // The resolution can be found in Key: Software\\Wine\\Explorer\\Desktops with the Value name set as value
     // (see above, "Default" is the default value). eg. "Default"="1024x768"
-    string resolution_value = Helper::get_reg_value(file_path, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault);
+    const string& resolution_value = registry.get_value(file_path, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault);
     if (!resolution_value.empty())
     {
       resolution = resolution_value;
@@ -810,8 +939,11 @@ string Helper::get_last_wine_updated(const string& prefix_path)
     if (!epoch_time.empty())
     {
       time_t secsSinceEpoch = strtoul(epoch_time.c_str(), NULL, 0);
+      struct tm local_time;
+      // localtime_r(), this method is called from multiple threads
+      localtime_r(&secsSinceEpoch, &local_time);
       std::stringstream stringStream;
-      stringStream << std::put_time(localtime(&secsSinceEpoch), "%c");
+      stringStream << std::put_time(&local_time, "%c");
       return stringStream.str();
     }
     else
@@ -837,6 +969,20 @@ string Helper::get_last_wine_updated(const string& prefix_path)
  * \return True if everything is OK, otherwise false
  */
 bool Helper::get_bottle_status(const string& prefix_path)
+{
+  RegistryQuery registry;
+  add_bottle_details_query(registry, prefix_path);
+  registry.execute();
+  return get_bottle_status(registry, prefix_path);
+}
+
+/**
+ * \brief Get Bottle Status from an executed registry query, to validate some bear minimal Wine stuff
+ * \param[in] registry Executed registry query, see add_bottle_details_query()
+ * \param[in] prefix_path Bottle prefix
+ * \return True if everything is OK, otherwise false
+ */
+bool Helper::get_bottle_status(const RegistryQuery& registry, const string& prefix_path)
 {
   // Check if some directories exists, and system registry file,
   // and finally, if we can read-out the Windows OS version without errors
@@ -845,7 +991,7 @@ bool Helper::get_bottle_status(const string& prefix_path)
   {
     try
     {
-      Helper::get_windows_version(prefix_path);
+      Helper::get_windows_version(registry, prefix_path);
       return true;
     }
     catch (const std::runtime_error& error)
@@ -862,9 +1008,10 @@ bool Helper::get_bottle_status(const string& prefix_path)
 
 /**
  * \brief Retrieve the Linux icon path and comment from Linux .desktop file using the Windows shortcut path (.lnk file).
- * Searching for the desktop file at: ~/.local/share/applications/wine. And then search for the icon image at: ~/.local/share/icons.
+ * Searching for the desktop file at: ~/.local/share/applications/wine (see DesktopEntryIndex).
+ * And then search for the icon image at: ~/.local/share/icons.
  * \param[in] shortcut_path Path of Windows shortcut (*.lnk file)
- * \throws runtime_error when we could not find the file extension or application menu item. Or Glib::FileError when desktop file could not be opened.
+ * \throws runtime_error when we could not find the file extension or application menu item. Or Glib::FileError when desktop file could not be found.
  * \return Icon path under Linux + Comment tuple (in both cases an empty string is possible)
  */
 std::tuple<string, string> Helper::get_menu_program_icon_path_and_comment(const string& shortcut_path)
@@ -887,25 +1034,14 @@ std::tuple<string, string> Helper::get_menu_program_icon_path_and_comment(const
     if (dot_pos != std::string::npos)
     {
       path.replace(dot_pos + 1, std::string::npos, "desktop");
-      // Read desktop file from disk
-      string file_content = Helper::read_file(path);
-      // Get icon
-      std::size_t icon_pos = file_content.find("Icon=");
-      if (icon_pos != std::string::npos)
-      {
-        string icon_content = file_content.substr(icon_pos + 5); // 5 is the length of 'Icon='
-        icon_content.resize(icon_content.find_first_of('\n'));
-        //  Use the 32x32 png image
-        icon = home_dir + "/.local/share/icons/hicolor/32x32/apps/" + icon_content + ".png";
-      }
-      // Get comment
-      std::size_t comment_pos = file_content.find("Comment=");
-      if (comment_pos != std::string::npos)
-      {
-        string comment_content = file_content.substr(comment_pos + 8); // 8 is the length of 'Comment='
-        comment_content.resize(comment_content.find_first_of('\n'));
-        comment = comment_content;
-      }
+      // Lookup the desktop file in the index (the directory is only read once)
+      std::optional<DesktopEntryIndex::Entry> entry = DesktopEntryIndex::get_instance().get_entry(path);
+      if (!entry)
+        throw Glib::FileError(Glib::FileError::NO_SUCH_ENTITY, "Desktop file not found: " + path);
+      //  Use the 32x32 png image
+      if (!entry->icon.empty())
+        icon = home_dir + "/.local/share/icons/hicolor/32x32/apps/" + entry->icon + ".png";
+      comment = entry->comment;
     }
     else
     {
@@ -925,7 +1061,7 @@ std::tuple<string, string> Helper::get_menu_program_icon_path_and_comment(const
  * ~/.local/share/icons.
  * \param[in] prefix_path Bottle prefix
  * \param[in] desktop_file_path Path of the desktop file under Windows
- * \throws Glib::FileError when desktop file could not be opened
+ * \throws Glib::FileError when desktop file could not be found
  * \return Icon path under Linux (empty string is possible)
  */
 string Helper::get_desktop_program_icon_path(const string& prefix_path, const string& desktop_file_path)
@@ -936,27 +1072,22 @@ string Helper::get_desktop_program_icon_path(const string& prefix_path, const st
   std::replace(desktop_path.begin(), desktop_path.end(), '\\', '/');
   // Add prefix and /drive_c/ folder to path
   desktop_path = prefix_path + "/drive_c/" + desktop_path;
-  // Read desktop file from disk
-  string file_content = Helper::read_file(desktop_path);
-  // Get icon
-  std::size_t icon_pos = file_content.find("Icon=");
-  if (icon_pos != std::string::npos)
-  {
-    file_content = file_content.substr(icon_pos + 5);
-    file_content.resize(file_content.find_first_of('\n'));
-    // Use the 32x32 png image
-    icon = Glib::get_home_dir() + "/.local/share/icons/hicolor/32x32/apps/" + file_content + ".png";
-  }
+  // Lookup the desktop file in the index (the directory is only read once)
+  std::optional<DesktopEntryIndex::Entry> entry = DesktopEntryIndex::get_instance().get_entry(desktop_path);
+  if (!entry)
+    throw Glib::FileError(Glib::FileError::NO_SUCH_ENTITY, "Desktop file not found: " + desktop_path);
+  // Use the 32x32 png image
+  if (!entry->icon.empty())
+    icon = Glib::get_home_dir() + "/.local/share/icons/hicolor/32x32/apps/" + entry->icon + ".png";
   return icon;
 }
 
 /**
- * \brief Retrieve target path from Windows shortcut (*.lnk) file.
+ * \brief Retrieve target path from Windows shortcut (*.lnk) file (see ShellLinkReader).
  * Which could be used to guess the icon based on the file extension.
- * (in the future we might also read the comment from the lnk file)
  * \param[in] prefix_path Bottle prefix
  * \param[in] shortcut_path Windows shortcut file path
- * \throws runtime_error when target path could not be found or Glib::FileError when Windows shortcut file could not be opened
+ * \throws runtime_error when target path could not be found or Glib::FileError when Windows shortcut file could not be found
  * \return Icon path
  */
 string Helper::get_program_icon_from_shortcut_file(const string& prefix_path, const string& shortcut_path)
@@ -967,28 +1098,12 @@ string Helper::get_program_icon_from_shortcut_file(const string& prefix_path, co
   std::replace(shortcut_path_linux.begin(), shortcut_path_linux.end(), '\\', '/');
   // Add prefix and /drive_c/ folder to path
   shortcut_path_linux = prefix_path + "/drive_c/" + shortcut_path_linux;
-  // Read Shortcut file from disk
-  string file_content = Helper::read_file(shortcut_path_linux);
-  // Convert content to hex value string
-  string hex_content = Helper::string2hex(file_content);
-  std::size_t target_path_starts = hex_content.find("431000000000"); // Searching for x43x10x00x00x00x00 hex pattern (C:\ drive)
-  if (target_path_starts == std::string::npos)
-  {
-    // Fallback, try to search on D:\ drive
-    target_path_starts = hex_content.find("441000000000");
-  }
-  if (target_path_starts == std::string::npos)
-  {
-    // Fallback, try to search on Z:\ drive
-    target_path_starts = hex_content.find("5A1000000000");
-  }
-  if (target_path_starts != std::string::npos)
-  {
-    hex_content = hex_content.substr(target_path_starts + 12); // Remove all content incl. hex search string
-    hex_content.resize(hex_content.find("00"));                // Until the first x00 hex value
-    // Convert hex string back to normal string
-    target_path = Helper::hex2string(hex_content);
-  }
+  // Parse the shortcut file (cached until the file changes)
+  std::shared_ptr<const ShellLink> link = ShellLinkReader::open(shortcut_path_linux);
+  if (!link && !Helper::file_exists(shortcut_path_linux))
+    throw Glib::FileError(Glib::FileError::NO_SUCH_ENTITY, "Windows shortcut file not found: " + shortcut_path_linux);
+  if (link)
+    target_path = !link->target_path.empty() ? link->target_path : link->relative_path;
   if (!target_path.empty())
   {
     return string_to_icon(target_path);
@@ -1072,12 +1187,12 @@ void Helper::install_or_update_winetricks()
     }
   }
 
-  const auto& [exit_code, output] =
-      exec("cd \"$(mktemp -d)\" && wget -q https://raw.githubusercontent.com/Winetricks/winetricks/master/src/winetricks "
-           "&& chmod +x winetricks && mv winetricks " +
-           WinetricksExecutable + " 2>&1");
-  if (exit_code != 0)
+  // Download next to the final location, so the (executable) script is replaced at once
+  string download_path = WinetricksExecutable + ".download";
+  const auto& [exit_code, output] = exec({"wget", "-q", "-O", download_path, WinetricksDownloadUrl});
+  if (exit_code != 0 || chmod(download_path.c_str(), 0755) != 0 || rename(download_path.c_str(), WinetricksExecutable.c_str()) != 0)
   {
+    unlink(download_path.c_str());
     std::cerr << "Error: Downloading Winetricks failed. Winetricks path: " << WinetricksExecutable << std::endl;
     std::cerr << "Error: " << output << std::endl;
     throw std::runtime_error("Winetricks helper script can not be downloaded. This could/will result into issues with WineGUI!");
@@ -1100,7 +1215,7 @@ void Helper::self_update_winetricks()
 {
   if (file_exists(WinetricksExecutable))
   {
-    const auto& [exit_code, output] = exec(WinetricksExecutable + " --self-update 2>&1");
+    const auto& [exit_code, output] = exec({WinetricksExecutable, "--self-update"});
     if (exit_code != 0)
     {
       // TODO: This could be a bug as well, maybe fallback to redownloading the winetricks binary?
@@ -1117,132 +1232,167 @@ void Helper::self_update_winetricks()
 }
 
 /**
- * \brief Set Windows OS version by using Winetricks
+ * \brief Set Windows OS version (the change is written by apply_registry_changes())
+ * \param[in,out] registry Registry changes
  * \param[in] prefix_path Bottle prefix
  * \param[in] windows Windows version (enum)
- * \throws runtime_error when we could not set the Windows OS version
+ * \throws runtime_error when the Windows version is unknown
  */
-void Helper::set_windows_version(const string& prefix_path, BottleTypes::Windows windows)
+void Helper::set_windows_version(RegistryWriter& registry, const string& prefix_path, BottleTypes::Windows windows)
 {
-  if (file_exists(WinetricksExecutable))
+  // Windows XP has a different version for 64-bit bottles (just like Winetricks does)
+  bool is_64_bit = (windows == BottleTypes::Windows::WindowsXP) && (get_windows_bitness(prefix_path) == BottleTypes::Bit::win64);
+  for (unsigned int i = 0; i < WindowsStructSize; i++)
   {
-    string win = BottleTypes::get_winetricks_string(windows);
-    const auto& [exit_code, output] = exec("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " " + win + " 2>&1");
-    if (exit_code != 0)
+    if (WindowsVersions[i].windows == windows && (WindowsVersions[i].version != "winxp64" || is_64_bit))
     {
-      std::cerr << "Error: Couldn't set Windows OS version. Wine prefix path: " << prefix_path << ", Winetricks path: " << WinetricksExecutable
-                << ", to Windows version: " << BottleTypes::to_string(windows) << "(Winetricks string: " << win << ")"
-                << ", output: " << output << std::endl;
-      throw std::runtime_error("Could not set Windows OS version");
+      string file_path = Glib::build_filename(prefix_path, UserReg);
+      registry.set_value(file_path, RegKeyWine, RegNameWindowsVersion, WindowsVersions[i].version);
+      return;
     }
   }
-  else
-  {
-    std::cerr << "Error: Couldn't set Windows OS version, no Winetricks executable found. Winetricks path: " << WinetricksExecutable << std::endl;
-  }
+  std::cerr << "Error: Couldn't set Windows OS version. Wine prefix path: " << prefix_path << ", to Windows version: "
+            << BottleTypes::to_string(windows) << std::endl;
+  throw std::runtime_error("Could not set Windows OS version");
 }
 
 /**
- * \brief Set custom virtual desktop resolution by using Winetricks
+ * \brief Set custom virtual desktop resolution (the change is written by apply_registry_changes())
+ * \param[in,out] registry Registry changes
  * \param[in] prefix_path Bottle prefix
  * \param[in] resolution New screen resolution (eg. 1920x1080)
- * \throws runtime_error when we could not set the virtual desktop resolution
+ * \throws runtime_error when the virtual desktop resolution is invalid
  */
-void Helper::set_virtual_desktop(const string& prefix_path, string resolution)
+void Helper::set_virtual_desktop(RegistryWriter& registry, const string& prefix_path, string resolution)
 {
-  if (file_exists(WinetricksExecutable))
+  vector<string> res = split(resolution, 'x');
+  if (res.size() >= 2)
   {
-    vector<string> res = split(resolution, 'x');
-    if (res.size() >= 2)
+    int x = 0, y = 0;
+    try
     {
-      int x = 0, y = 0;
-      try
-      {
-        x = std::atoi(res.at(0).c_str());
-        y = std::atoi(res.at(1).c_str());
-      }
-      catch (std::exception const& e)
-      {
-        std::cerr << "Error: Couldn't set virtual desktop resolution, Winetricks path: " << WinetricksExecutable << ", error message: " << e.what()
-                  << std::endl;
-        throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
-      }
-
-      if (x < 640 || y < 480)
-      {
-        // Set to minimum resolution
-        resolution = "640x480";
-      }
-
-      const auto [exit_code, output] = exec("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " vd=" + resolution + " 2>&1");
-      if (exit_code != 0)
-      {
-        std::cerr << "Error: Couldn't set virtual desktop resolution. Wine prefix path: " << prefix_path
-                  << ", Winetricks path: " << WinetricksExecutable << ", output: " << output << std::endl;
-        throw std::runtime_error("Could not set virtual desktop resolution");
-      }
+      x = std::atoi(res.at(0).c_str());
+      y = std::atoi(res.at(1).c_str());
     }
-    else
+    catch (std::exception const& e)
     {
-      std::cerr << "Error: Couldn't set virtual desktop resolution, invalid input. Wine prefix path: " << prefix_path
-                << ", Winetricks path: " << WinetricksExecutable << std::endl;
+      std::cerr << "Error: Couldn't set virtual desktop resolution, error message: " << e.what() << std::endl;
       throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
     }
+
+    if (x < 640 || y < 480)
+    {
+      // Set to minimum resolution
+      resolution = "640x480";
+    }
+
+    string file_path = Glib::build_filename(prefix_path, UserReg);
+    registry.set_value(file_path, RegKeyVirtualDesktop, RegNameVirtualDesktop, RegNameVirtualDesktopDefault);
+    registry.set_value(file_path, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault, resolution);
   }
   else
   {
-    std::cerr << "Error:Couldn't set virtual desktop resolution, no Winetricks executable found. Wine prefix path: " << prefix_path
-              << ", Winetricks path: " << WinetricksExecutable << std::endl;
+    std::cerr << "Error: Couldn't set virtual desktop resolution, invalid input. Wine prefix path: " << prefix_path << std::endl;
+    throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
   }
 }
 
 /**
- * \brief Disable Virtual Desktop fully by using Winetricks
+ * \brief Disable Virtual Desktop fully (the change is written by apply_registry_changes())
+ * \param[in,out] registry Registry changes
  * \param[in] prefix_path Bottle prefix
- * \throws runtime_error when we could not disable the virtual desktop
  */
-void Helper::disable_virtual_desktop(const string& prefix_path)
+void Helper::disable_virtual_desktop(RegistryWriter& registry, const string& prefix_path)
 {
-  if (file_exists(WinetricksExecutable))
-  {
-    const auto& [exit_code, output] = exec("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " vd=off 2>&1");
-    if (exit_code != 0)
-    {
-      std::cerr << "Error: Couldn't disable desktop, Winetricks path: " << WinetricksExecutable << ", output: " << output << std::endl;
-      throw std::runtime_error("Could not disable virtual desktop");
-    }
-  }
-  else
-  {
-    std::cerr << "Error:Couldn't disable desktop, no Winetricks executable found. Winetricks path: " << WinetricksExecutable << std::endl;
-  }
+  string file_path = Glib::build_filename(prefix_path, UserReg);
+  registry.delete_value(file_path, RegKeyVirtualDesktop, RegNameVirtualDesktop);
+  registry.delete_value(file_path, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault);
 }
 
 /**
- * \brief Set Audio Driver by using Winetricks
+ * \brief Set Audio Driver (the change is written by apply_registry_changes())
+ * \param[in,out] registry Registry changes
  * \param[in] prefix_path Bottle prefix
  * \param[in] audio_driver Audio driver to be set
- * \throws runtime_error when we could not set the auditor driver
  */
-void Helper::set_audio_driver(const string& prefix_path, BottleTypes::AudioDriver audio_driver)
+void Helper::set_audio_driver(RegistryWriter& registry, const string& prefix_path, BottleTypes::AudioDriver audio_driver)
 {
-  if (file_exists(WinetricksExecutable))
+  string file_path = Glib::build_filename(prefix_path, UserReg);
+  registry.set_value(file_path, RegKeyAudio, RegNameAudio, BottleTypes::get_winetricks_string(audio_driver));
+}
+
+/**
+ * \brief Write all the registry changes of a bottle at once.
+ * When the wineserver of the bottle is not running, the registry files are changed directly (no need to start Wine).
+ * Otherwise the changes are imported via a single 'regedit' call, since the wineserver would overwrite the registry files.
+ * The changes are also imported when the wineserver is started while the registry files are changed.
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] registry Registry changes
+ * \throws runtime_error when the registry changes could not be written
+ */
+void Helper::apply_registry_changes(bool wine_64_bit, const string& prefix_path, const RegistryWriter& registry)
+{
+  if (registry.empty())
+    return;
+
+  if (!is_wineserver_running(prefix_path))
   {
-    string audio = BottleTypes::get_winetricks_string(audio_driver);
-    const auto& [exit_code, output] = exec("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " sound=" + audio + " 2>&1");
-    if (exit_code != 0)
-    {
-      std::cerr << "Error: Couldn't set audio driver. Wine prefix path: " << prefix_path << ", Winetricks path: " << WinetricksExecutable
-                << ", to audio driver: " << BottleTypes::to_string(audio_driver) << "(Winetricks string: " << audio << ")"
-                << ", output: " << output << std::endl;
-      throw std::runtime_error("Could not set Audio driver");
-    }
+    registry.commit();
+    // A wineserver that started before the files were renamed could have loaded the old registry (and writes it back on exit),
+    // check again and import the changes via the wineserver as well in that case
+    if (!is_wineserver_running(prefix_path))
+      return;
   }
-  else
+
+  string reg_contents = "REGEDIT4\n" + registry.to_regedit(Glib::build_filename(prefix_path, UserReg), "HKEY_CURRENT_USER") +
+                        registry.to_regedit(Glib::build_filename(prefix_path, SystemReg), "HKEY_LOCAL_MACHINE") + "\n";
+  string temp_dir = Glib::build_filename(prefix_path, "drive_c", "windows", "temp");
+  string reg_file_path = Glib::build_filename(temp_dir, "winegui-settings.reg");
+  try
   {
-    std::cerr << "Error:Couldn't set audio driver, no Winetricks executable found. Wine prefix path: " << prefix_path
-              << ", Winetricks path: " << WinetricksExecutable << std::endl;
+    if (!dir_exists(temp_dir))
+      create_dir(temp_dir);
+    write_file(reg_file_path, reg_contents);
   }
+  catch (const Glib::FileError& error)
+  {
+    std::cerr << "Error: Couldn't write registry import file: " << reg_file_path << ", error: " << error.what() << std::endl;
+    throw std::runtime_error("Could not write registry changes");
+  }
+  vector<string> argv{Helper::get_wine_executable_location(wine_64_bit), "regedit", "/S", "C:\\windows\\temp\\winegui-settings.reg"};
+  const auto& [exit_code, output] = exec(argv, {.env_vars = {{"WINEPREFIX", prefix_path}}});
+  unlink(reg_file_path.c_str());
+  if (exit_code != 0)
+  {
+    std::cerr << "Error: Couldn't import registry changes. Wine prefix path: " << prefix_path << ", output: " << output << std::endl;
+    throw std::runtime_error("Could not write registry changes");
+  }
+}
+
+/**
+ * \brief Check if the wineserver of a bottle is running, without starting Wine.
+ * A running wineserver holds a lock on the 'lock' file in its server directory (/tmp/.wine-<uid>/server-<dev>-<inode>).
+ * \param[in] prefix_path Bottle prefix
+ * \return True if the wineserver is running
+ */
+bool Helper::is_wineserver_running(const string& prefix_path)
+{
+  struct stat prefix_stat;
+  if (stat(prefix_path.c_str(), &prefix_stat) != 0)
+    return false;
+  std::ostringstream lock_file_path;
+  lock_file_path << "/tmp/.wine-" << getuid() << "/server-" << std::hex << static_cast<unsigned long long>(prefix_stat.st_dev) << "-"
+                 << static_cast<unsigned long long>(prefix_stat.st_ino) << "/lock";
+  int fd = open(lock_file_path.str().c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct flock lock = {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  bool is_locked = (fcntl(fd, F_GETLK, &lock) == 0) && (lock.l_type != F_UNLCK);
+  close(fd);
+  return is_locked;
 }
 
 /**
@@ -1314,13 +1464,23 @@ string Helper::log_level_to_winedebug_string(int log_level)
  */
 string Helper::get_wine_guid(bool wine_64_bit, const string& prefix_path, const string& application_name)
 {
-  auto [exit_code, output] = exec("WINEPREFIX=\"" + prefix_path + "\" " + Helper::get_wine_executable_location(wine_64_bit) +
-                                  " uninstaller --list | grep \"" + application_name + "\" | cut -d \"{\" -f2 | cut -d \"}\" -f1 2>&1");
-  if (exit_code == 0 && !output.empty())
+  vector<string> argv{Helper::get_wine_executable_location(wine_64_bit), "uninstaller", "--list"};
+  const auto& [exit_code, output] = exec(argv, {.env_vars = {{"WINEPREFIX", prefix_path}}, .merge_stderr = false});
+  if (exit_code != 0)
+    return "";
+  // Lines are formatted like: {GUID}|||Application name
+  std::istringstream lines(output);
+  string line;
+  while (std::getline(lines, line))
   {
-    output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
+    if (line.find(application_name) == string::npos)
+      continue;
+    std::size_t begin = line.find('{');
+    std::size_t end = line.find('}', begin);
+    if (begin != string::npos && end != string::npos)
+      return line.substr(begin + 1, end - begin - 1);
   }
-  return output;
+  return "";
 }
 
 /**
@@ -1333,9 +1493,35 @@ string Helper::get_wine_guid(bool wine_64_bit, const string& prefix_path, const
  */
 bool Helper::get_dll_override(const string& prefix_path, const string& dll_name, DLLOverride::LoadOrder load_order)
 {
-  string file_path = Glib::build_filename(prefix_path, UserReg);
-  string value_name = dll_name;
-  string value = Helper::get_reg_value(file_path, RegKeyDllOverrides, value_name);
+  RegistryQuery registry;
+  add_dll_override_query(registry, prefix_path, dll_name);
+  registry.execute();
+  return get_dll_override(registry, prefix_path, dll_name, load_order);
+}
+
+/**
+ * \brief Add the DLL override registry value to the query
+ * \param[in,out] registry Registry query
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] dll_name DLL Name
+ */
+void Helper::add_dll_override_query(RegistryQuery& registry, const string& prefix_path, const string& dll_name)
+{
+  registry.add_value(Glib::build_filename(prefix_path, UserReg), RegKeyDllOverrides, dll_name);
+}
+
+/**
+ * \brief Check DLL can be found in overrides and set to a specific load order, using an executed registry query
+ * \param[in] registry Executed registry query, see add_dll_override_query()
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] dll_name DLL Name
+ * \param[in] load_order (Optional) DLL load order enum value (Default 'native')
+ * \throws runtime_error when Windows registry could not be opened
+ * \return True if specified load order matches the DLL overrides registry value
+ */
+bool Helper::get_dll_override(const RegistryQuery& registry, const string& prefix_path, const string& dll_name, DLLOverride::LoadOrder load_order)
+{
+  const string& value = registry.get_value(Glib::build_filename(prefix_path, UserReg), RegKeyDllOverrides, dll_name);
   return DLLOverride::to_string(load_order) == value;
 }
 
@@ -1349,9 +1535,34 @@ bool Helper::get_dll_override(const string& prefix_path, const string& dll_name,
  */
 string Helper::get_uninstaller(const string& prefix_path, const string& uninstallerKey)
 {
-  string file_path = Glib::build_filename(prefix_path, SystemReg);
-  string key_name = "[Software\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Uninstall\\\\" + uninstallerKey;
-  return Helper::get_reg_value(file_path, key_name, "DisplayName");
+  RegistryQuery registry;
+  add_uninstaller_query(registry, prefix_path, uninstallerKey);
+  registry.execute();
+  return get_uninstaller(registry, prefix_path, uninstallerKey);
+}
+
+/**
+ * \brief Add the uninstaller display name registry value to the query
+ * \param[in,out] registry Registry query
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] uninstallerKey GUID or application name of the uninstaller
+ */
+void Helper::add_uninstaller_query(RegistryQuery& registry, const string& prefix_path, const string& uninstallerKey)
+{
+  registry.add_value(Glib::build_filename(prefix_path, SystemReg), get_uninstaller_reg_key(uninstallerKey), "DisplayName");
+}
+
+/**
+ * \brief Retrieve the uninstaller from GUID (if available), using an executed registry query
+ * \param[in] registry Executed registry query, see add_uninstaller_query()
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] uninstallerKey GUID or application name of the uninstaller
+ * \throws runtime_error when Windows registry could not be opened
+ * \return Uninstaller display name or empty string if not found
+ */
+string Helper::get_uninstaller(const RegistryQuery& registry, const string& prefix_path, const string& uninstallerKey)
+{
+  return registry.get_value(Glib::build_filename(prefix_path, SystemReg), get_uninstaller_reg_key(uninstallerKey), "DisplayName");
 }
 
 /**
@@ -1364,55 +1575,63 @@ string Helper::get_uninstaller(const string& prefix_path, const string& uninstal
  */
 string Helper::get_font_filename(const string& prefix_path, BottleTypes::Bit bit, const string& fontName)
 {
-  string file_path = Glib::build_filename(prefix_path, SystemReg);
-  string key_name = "";
-  switch (bit)
-  {
-  case BottleTypes::Bit::win32:
-    key_name = "[Software\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Fonts]";
-    break;
-  case BottleTypes::Bit::win64:
-    key_name = "[Software\\\\Wow6432Node\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Fonts]";
-    break;
-  }
-  return Helper::get_reg_value(file_path, key_name, fontName);
+  RegistryQuery registry;
+  add_font_filename_query(registry, prefix_path, bit, fontName);
+  registry.execute();
+  return get_font_filename(registry, prefix_path, bit, fontName);
 }
 
 /**
- * \brief Get path to an image resource located in a global data directory (like /usr/share)
- * \param[in] filename Name of image
- * \return Path to the requested image (or empty string if not found)
+ * \brief Add the font file registry value to the query
+ * \param[in,out] registry Registry query
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] bit Bottle bit (32 or 64) enum
+ * \param[in] fontName Font name
  */
-string Helper::get_image_location(const string& filename)
+void Helper::add_font_filename_query(RegistryQuery& registry, const string& prefix_path, BottleTypes::Bit bit, const string& fontName)
 {
-  // Try absolute path first
-  for (const string& data_dir : Glib::get_system_data_dirs())
+  registry.add_value(Glib::build_filename(prefix_path, SystemReg), get_font_reg_key(bit), fontName);
+}
+
+/**
+ * \brief Retrieve a font file_path from the system registry, using an executed registry query
+ * \param[in] registry Executed registry query, see add_font_filename_query()
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] bit Bottle bit (32 or 64) enum
+ * \param[in] fontName Font name
+ * \throws runtime_error when Windows registry could not be opened
+ * \return Font file_path (or empty string if not found)
+ */
+string Helper::get_font_filename(const RegistryQuery& registry, const string& prefix_path, BottleTypes::Bit bit, const string& fontName)
+{
+  return registry.get_value(Glib::build_filename(prefix_path, SystemReg), get_font_reg_key(bit), fontName);
+}
+
+/**
+ * \brief Load an image, which is compiled into the binary (GResource).
+ * When the WINEGUI_IMAGE_DIR environment variable is set (theming), the image in that directory is used instead (if present).
+ * \param[in] filename Name of image, relative to the images directory (eg. "apps/notepad.png")
+ * \return Image or empty pointer when the image couldn't be loaded
+ */
+Glib::RefPtr<Gdk::Pixbuf> Helper::get_image(const string& filename)
+{
+  // The environment is only read once, without an override directory there are no file system look-ups
+  static const string override_dir = Glib::getenv(ImageOverrideDirEnv);
+  try
   {
-    vector<string> path_builder{data_dir, "winegui", "images", filename};
-    string file_path = Glib::build_path(G_DIR_SEPARATOR_S, path_builder);
-    if (file_exists(file_path))
+    if (!override_dir.empty())
     {
-      return file_path;
+      string file_path = Glib::build_filename(override_dir, filename);
+      if (file_exists(file_path))
+        return Gdk::Pixbuf::create_from_file(file_path);
     }
+    return Gdk::Pixbuf::create_from_resource(ImageResourcePath + filename);
   }
-
-  // Try local path if the images are not installed (yet)
-  // When working directory is in the build folder (relative path)
-  string file_path = Glib::build_filename("../images", filename);
-  // When working directory is in the build/bin folder (relative path)
-  string file_path2 = Glib::build_filename("../../images", filename);
-  if (file_exists(file_path))
+  catch (const Glib::Error& error)
   {
-    return file_path;
-  }
-  else if (file_exists(file_path2))
-  {
-    return file_path2;
-  }
-  else
-  {
-    return "";
+    std::cerr << "Error: Could not load image: " << filename << ", error: " << error.what() << std::endl;
   }
+  return Glib::RefPtr<Gdk::Pixbuf>();
 }
 
 /**
@@ -1540,92 +1759,37 @@ string Helper::string_to_icon(const std::string& filename)
  ****************************************************************************/
 
 /**
- * \brief Execute command on terminal. Returns both the exit code as well as stdout output.
- * Note: Redirect stderr to stdout (2>&1), if you want stderr as well.
- * \param[in] command The command to be executed
- * \example const auto& [exit_code, output] = exec("echo 1");
- * \throws runtime_error when popen failed (empty pipe pointer)
- * \return Exit code and terminal stdout output as a pair
+ * \brief Execute a program (without a shell, see Process). Returns both the exit code as well as the output.
+ * \param[in] argv The program followed by its arguments
+ * \param[in] options Working directory, environment variables & whether stderr is captured as well (by default)
+ * \example const auto& [exit_code, output] = exec({"echo", "1"});
+ * \throws runtime_error when the output pipe could not be created
+ * \return Exit code and output as a pair
  */
-std::pair<int, string> Helper::exec(const string& command)
+std::pair<int, string> Helper::exec(const vector<string>& argv, const ProcessOptions& options)
 {
-  int exit_code = -1;
-  string output = "";
-
-  // local scope kicks off pclose before returning exit_code
-  {
-    std::array<char, 128> buffer{};
-    // And use the standard C pclose method during stream closure.
-    auto deleter = [&exit_code](std::FILE* ptr) { exit_code = pclose(ptr); };
-
-    // Execute command using popen,
-    std::unique_ptr<std::FILE, decltype(deleter)> pipe(popen(command.c_str(), "r"), deleter);
-    if (!pipe)
-    {
-      throw std::runtime_error("popen() failed!");
-    }
-    while (std::fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
-    {
-      output += buffer.data();
-    }
-  }
-  return std::make_pair(exit_code, output);
+  ProcessResult result = Process::run(argv, options);
+  return std::make_pair(result.exit_code, std::move(result.output));
 }
 
 /**
- * \brief Execute command on terminal, give user an error message when exit code is non-zero.
- * Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
- * \param[in] command The command to be executed
- * \throws runtime_error when popen failed (empty pipe pointer)
- * \return Terminal stdout output
+ * \brief Execute a program (without a shell), give user an error message when exit code is non-zero.
+ * \param[in] argv The program followed by its arguments
+ * \param[in] options Working directory, environment variables & whether stderr is captured as well (by default)
+ * \throws runtime_error when the output pipe could not be created
+ * \return Output
  */
-string Helper::exec_error_message(const string& command)
+string Helper::exec_error_message(const vector<string>& argv, const ProcessOptions& options)
 {
-  // Max 128 characters
-  std::array<char, 128> buffer;
-  string output = "";
-
-  // Execute command using popen
-  struct custom_file_deleter
+  ProcessResult result = Process::run(argv, options);
+  if (result.exit_code != 0)
   {
-    void operator()(std::FILE* fp)
-    {
-      // Use a custom close file function during the pipe close (close_exec_stream)
-      // See close_exec_stream below.
-      Helper::close_exec_stream(fp);
-    }
-  };
-  using unique_file_custom_deleter = std::unique_ptr<std::FILE, custom_file_deleter>;
-  unique_file_custom_deleter pipe{popen(command.c_str(), "r")};
-  if (!pipe)
-  {
-    throw std::runtime_error("popen() failed!");
+    // Dispatcher will run the connected slot in the main loop,
+    // instead of the same context/thread in case of a signal.emit() call.
+    // Signal error message to the user:
+    Helper::get_instance().failure_on_exec.emit();
   }
-  while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
-  {
-    output += buffer.data();
-  }
-  return output;
-}
-
-/**
- * Custom pclose method, which is executed during the stream closure of C popen command.
- * Check on pclose return value, signal a failure/pop-up to the user, when exit-code is non-zero.
- */
-int Helper::close_exec_stream(std::FILE* file)
-{
-  if (file)
-  {
-    if (pclose(file) != 0)
-    {
-      // Dispatcher will run the connected slot in the main loop,
-      // instead of the same context/thread in case of a signal.emit() call.
-      // This is needed because the CloseFile is called in a different context then usual!
-      // Signal error message to the user:
-      Helper::get_instance().failure_on_exec.emit();
-    }
-  }
-  return 0; // Just always return OK
+  return result.output;
 }
 
 /**
@@ -1660,7 +1824,7 @@ string Helper::get_winetricks_version()
   string version = "unknown";
   if (file_exists(WinetricksExecutable))
   {
-    const auto& [exit_code, output] = exec(WinetricksExecutable + " --version");
+    const auto& [exit_code, output] = exec({WinetricksExecutable, "--version"}, {.merge_stderr = false});
     if (exit_code == 0 && !output.empty())
     {
       if (output.length() >= 8)
@@ -1672,54 +1836,6 @@ string Helper::get_winetricks_version()
   return version;
 }
 
-/**
- * \brief Get a specific value from the Wine registry from disk
- * \param[in] file_path  File path of registry
- * \param[in] key_name   Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
- * \param[in] value_name Specifies the registry value name (eg. Desktop)
- * \throws runtime_error when we couldn't load the Windows registry
- * \return Data of value name
- */
-string Helper::get_reg_value(const string& file_path, const string& key_name, const string& value_name)
-{
-  string output;
-  output.reserve(10);
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
-    {
-      if (!match)
-      {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        string value_pattern = '"' + value_name + "\"=";
-        std::size_t pos = line.find(value_pattern);
-        if (pos != std::string::npos)
-        {
-          output = line.substr(pos + value_pattern.size());
-          // Remove quotes
-          output.erase(std::remove(output.begin(), output.end(), '\"'), output.end());
-          break;
-        }
-      }
-    }
-    reg_file.close();
-  }
-  else
-  {
-    std::cerr << "Error: Couldn't open registry file during get_reg_value(). Trying to read from file: " << file_path << "(using key: " << key_name
-              << " and value: " << value_name << ")" << std::endl;
-    throw std::runtime_error("Could not open registry file!");
-  }
-  return output;
-}
-
 /**
  * \brief Get subkeys from a specific key from the Wine registry from disk
  * \param[in] file_path  File path of registry
@@ -1729,36 +1845,22 @@ string Helper::get_reg_value(const string& file_path, const string& key_name, co
  */
 vector<string> Helper::get_reg_keys(const string& file_path, const string& key_name)
 {
-  vector<string> keys;
-  keys.reserve(10);
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
-    {
-      if (!match)
-      {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        if (line.empty() || reg_file.eof())
-          break; // End of key section in registry
-        if (!line.starts_with('#'))
-          keys.emplace_back(line);
-      }
-    }
-    reg_file.close();
-  }
-  else
+  auto hive = RegistryHive::open(file_path);
+  if (!hive)
   {
     std::cerr << "Error: Couldn't open registry file during get_reg_keys(). Trying to read from file: " << file_path << "(using key: " << key_name
               << ")" << std::endl;
     throw std::runtime_error("Could not open registry file!");
   }
+  vector<string> keys;
+  keys.reserve(10);
+  RegistryTokenizer tokenizer(hive->get_key_body(key_name));
+  std::string_view line;
+  while (tokenizer.next_line(line))
+  {
+    if (!line.starts_with('#'))
+      keys.emplace_back(line);
+  }
   return keys;
 }
 
@@ -1804,51 +1906,40 @@ vector<pair<string, string>> Helper::get_reg_keys_name_data_pair_filter_ignore(c
                                                                                const string& key_value_filter,
                                                                                const string& key_name_ignore_filter)
 {
-  vector<pair<string, string>> pairs;
-  pairs.reserve(3);
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
-    {
-      if (!match)
-      {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        if (line.empty() || reg_file.eof())
-          break; // End of key section in registry
-
-        line = unescape_reg_key_data(line);
-        // Skip '#' elements and if filter is not empty it will only continue if the line contains the filter string
-        if (!line.starts_with('#') && (key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
-            (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
-        {
-          auto results = split(line, '"');
-          if (results.size() >= 5)
-          {
-            auto key = results.at(1);
-            key.erase(std::remove(key.begin(), key.end(), '\"'), key.end());
-            auto value = results.at(3);
-            value.erase(std::remove(value.begin(), value.end(), '\"'), value.end());
-            pairs.emplace_back(std::make_pair(key, value));
-          }
-        }
-      }
-    }
-    reg_file.close();
-  }
-  else
+  auto hive = RegistryHive::open(file_path);
+  if (!hive)
   {
     std::cerr << "Error: Couldn't open registry file during get_reg_keys_name_data_pair_filter_ignore(). Trying to read from file: " << file_path
               << "(using key: " << key_name << ", key value filter: " << key_value_filter << " and key ignore filter: " << key_name_ignore_filter
               << ")" << std::endl;
     throw std::runtime_error("Could not open registry file!");
   }
+  vector<pair<string, string>> pairs;
+  pairs.reserve(3);
+  string name_buffer, data_buffer;
+  RegistryTokenizer tokenizer(hive->get_key_body(key_name));
+  RegistryValue value;
+  while (tokenizer.next_value(value))
+  {
+    if (!value.is_string)
+      continue;
+    std::string_view name = value.name;
+    std::string_view data = value.data;
+    // Only unescape when needed, most names and data are plain ASCII
+    if (value.is_escaped)
+    {
+      name_buffer.clear();
+      data_buffer.clear();
+      RegistryTokenizer::unescape(value.name, name_buffer);
+      RegistryTokenizer::unescape(value.data, data_buffer);
+      name = name_buffer;
+      data = data_buffer;
+    }
+    if (is_reg_value_matching_filter(name, data, key_value_filter, key_name_ignore_filter))
+    {
+      pairs.emplace_back(string(name), string(data));
+    }
+  }
   return pairs;
 }
 
@@ -1892,49 +1983,40 @@ vector<string> Helper::get_reg_keys_value_data_filter_ignore(const string& file_
                                                              const string& key_value_filter,
                                                              const string& key_name_ignore_filter)
 {
-  vector<string> keys;
-  keys.reserve(10);
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
-    {
-      if (!match)
-      {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        if (line.empty() || reg_file.eof())
-          break; // End of key section in registry
-
-        line = unescape_reg_key_data(line);
-        // Skip '#' elements and if filter is not empty it will only continue if the line contains the filter string
-        if (!line.starts_with('#') && (key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
-            (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
-        {
-          auto results = split(line, '"');
-          if (results.size() >= 5)
-          {
-            line = results.at(3);
-            line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
-            keys.emplace_back(line);
-          }
-        }
-      }
-    }
-    reg_file.close();
-  }
-  else
+  auto hive = RegistryHive::open(file_path);
+  if (!hive)
   {
     std::cerr << "Error: Couldn't open registry file during get_reg_keys_value_data_filter_ignore(). Trying to read from file: " << file_path
               << "(using key: " << key_name << ", key value filter: " << key_value_filter << " and key ignore filter: " << key_name_ignore_filter
               << ")" << std::endl;
     throw std::runtime_error("Could not open registry file!");
   }
+  vector<string> keys;
+  keys.reserve(10);
+  string name_buffer, data_buffer;
+  RegistryTokenizer tokenizer(hive->get_key_body(key_name));
+  RegistryValue value;
+  while (tokenizer.next_value(value))
+  {
+    if (!value.is_string)
+      continue;
+    std::string_view name = value.name;
+    std::string_view data = value.data;
+    // Only unescape when needed, most names and data are plain ASCII
+    if (value.is_escaped)
+    {
+      name_buffer.clear();
+      data_buffer.clear();
+      RegistryTokenizer::unescape(value.name, name_buffer);
+      RegistryTokenizer::unescape(value.data, data_buffer);
+      name = name_buffer;
+      data = data_buffer;
+    }
+    if (is_reg_value_matching_filter(name, data, key_value_filter, key_name_ignore_filter))
+    {
+      keys.emplace_back(data);
+    }
+  }
   return keys;
 }
 
@@ -1947,34 +2029,44 @@ vector<string> Helper::get_reg_keys_value_data_filter_ignore(const string& file_
  */
 string Helper::get_reg_meta_data(const string& file_path, const string& meta_value_name)
 {
-  string output;
-  output.reserve(10);
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    string meta_pattern = "#" + meta_value_name + "=";
-    string line;
-    line.reserve(80);
-    while (std::getline(reg_file, line))
-    {
-      std::size_t pos = line.find(meta_pattern);
-      if (pos != std::string::npos)
-      {
-        output = line.substr(pos + meta_pattern.size());
-        // Remove quotes
-        output.erase(std::remove(output.begin(), output.end(), '\"'), output.end());
-        break;
-      }
-    }
-    reg_file.close();
-  }
-  else
+  auto hive = RegistryHive::open(file_path);
+  if (!hive)
   {
     std::cerr << "Error: Couldn't open registry file during get_reg_meta_data(). Trying to read from file: " << file_path
               << "(using meta value name: " << meta_value_name << ")" << std::endl;
     throw std::runtime_error("Could not open registry file!");
   }
-  return output;
+  return hive->get_meta_data(meta_value_name);
+}
+
+/**
+ * \brief Get the registry key name of an uninstaller
+ * \param[in] uninstallerKey GUID or application name of the uninstaller
+ * \return Key name, without closing bracket. So it also matches keys with a suffix (eg. " - 1033")
+ */
+string Helper::get_uninstaller_reg_key(const string& uninstallerKey)
+{
+  return "[Software\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Uninstall\\\\" + uninstallerKey;
+}
+
+/**
+ * \brief Get the registry key name of the installed fonts
+ * \param[in] bit Bottle bit (32 or 64) enum
+ * \return Key name
+ */
+string Helper::get_font_reg_key(BottleTypes::Bit bit)
+{
+  string key_name = "";
+  switch (bit)
+  {
+  case BottleTypes::Bit::win32:
+    key_name = "[Software\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Fonts]";
+    break;
+  case BottleTypes::Bit::win64:
+    key_name = "[Software\\\\Wow6432Node\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Fonts]";
+    break;
+  }
+  return key_name;
 }
 
 /**
@@ -2055,152 +2147,23 @@ vector<string> Helper::split(const string& s, const char delimiter)
 }
 
 /**
- * \brief Parse an escaped Wine registry key data back into an UTF-8 string
- * The code is adopted from the parse_strW() method:
- * https://source.winehq.org/git/wine.git/blob/refs/heads/master:/server/unicode.c#l101
- *
- * \param[in] src Key data to be unescaped
- * \return UTF-8 string
+ * \brief Check if a registry value (name + data) passes the filters
+ * \param[in] name Unescaped value name
+ * \param[in] data Unescaped value data
+ * \param[in] key_value_filter Name or data should contain the filter (empty string means no filtering)
+ * \param[in] key_name_ignore_filter Name and data should not contain the ignore filter (empty string means nothing is ignored)
+ * \return True if the value should be returned
  */
-string Helper::unescape_reg_key_data(const string& src)
+bool Helper::is_reg_value_matching_filter(std::string_view name,
+                                          std::string_view data,
+                                          const string& key_value_filter,
+                                          const string& key_name_ignore_filter)
 {
-  auto to_hex = [](char ch) -> char { return std::isdigit(ch) ? ch - '0' : std::tolower(ch) - 'a' + 10; };
-
-  auto wchar_to_utf8 = [](wchar_t wc) -> string
-  {
-    string s;
-    if (0 <= wc && wc <= 0x7f)
-    {
-      s += (char)wc;
-    }
-    else if (0x80 <= wc && wc <= 0x7ff)
-    {
-      s += (0xc0 | (wc >> 6));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x800 <= wc && wc <= 0xffff)
-    {
-      s += (0xe0 | (wc >> 12));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x10000 <= wc && wc <= 0x1fffff)
-    {
-      s += (0xf0 | (wc >> 18));
-      s += (0x80 | ((wc >> 12) & 0x3f));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x200000 <= wc && wc <= 0x3ffffff)
-    {
-      s += (0xf8 | (wc >> 24));
-      s += (0x80 | ((wc >> 18) & 0x3f));
-      s += (0x80 | ((wc >> 12) & 0x3f));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x4000000 <= wc && wc <= 0x7fffffff)
-    {
-      s += (0xfc | (wc >> 30));
-      s += (0x80 | ((wc >> 24) & 0x3f));
-      s += (0x80 | ((wc >> 18) & 0x3f));
-      s += (0x80 | ((wc >> 12) & 0x3f));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    return s;
-  };
-
-  string dest;
-  dest.reserve(src.length());
-
-  const char* p = src.c_str();
-  while (*p)
-  {
-    if (*p == '\\')
-    {
-      p++;
-      if (!*p)
-        break;
-
-      switch (*p)
-      {
-      case 'a':
-        dest += '\a';
-        p++;
-        continue;
-      case 'b':
-        dest += '\b';
-        p++;
-        continue;
-      case 'e':
-        dest += '\e';
-        p++;
-        continue;
-      case 'f':
-        dest += '\f';
-        p++;
-        continue;
-      case 'n':
-        dest += '\n';
-        p++;
-        continue;
-      case 'r':
-        dest += '\r';
-        p++;
-        continue;
-      case 't':
-        dest += '\t';
-        p++;
-        continue;
-      case 'v':
-        dest += '\v';
-        p++;
-        continue;
-
-      // hex escape
-      case 'x':
-        p++;
-        if (!std::isxdigit(*p))
-          dest += 'x';
-        else
-        {
-          wchar_t wch = to_hex(*p++);
-          if (std::isxdigit(*p))
-            wch = (wch * 16) + to_hex(*p++);
-          if (std::isxdigit(*p))
-            wch = (wch * 16) + to_hex(*p++);
-          if (std::isxdigit(*p))
-            wch = (wch * 16) + to_hex(*p++);
-          dest += wchar_to_utf8(wch);
-        }
-        continue;
-
-      // octal escape
-      case '0':
-      case '1':
-      case '2':
-      case '3':
-      case '4':
-      case '5':
-      case '6':
-      case '7':
-      {
-        wchar_t wch = *p++ - '0';
-        if (*p >= '0' && *p <= '7')
-          wch = (wch * 8) + (*p++ - '0');
-        if (*p >= '0' && *p <= '7')
-          wch = (wch * 8) + (*p++ - '0');
-        dest += wchar_to_utf8(wch);
-        continue;
-      }
-      }
-      // unrecognized escape: fall through to normal char handling
-    }
-
-    dest += *p++;
-  }
-  return dest;
+  bool is_matching = key_value_filter.empty() || name.find(key_value_filter) != std::string_view::npos ||
+                     data.find(key_value_filter) != std::string_view::npos;
+  bool is_ignored = !key_name_ignore_filter.empty() &&
+                    (name.find(key_name_ignore_filter) != std::string_view::npos || data.find(key_name_ignore_filter) != std::string_view::npos);
+  return is_matching && !is_ignored;
 }
 
 /**
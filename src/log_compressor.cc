@@ -0,0 +1,393 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    log_compressor.cc
+ * \brief   Rotates the log files and compresses the rotated log files in the background (gzip)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_compressor.h"
+#include "log_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+//// Size of the blocks that are compressed in parallel, every block is an independent gzip member
+static const std::size_t BlockSize = 4 * 1024 * 1024;
+//// Fastest level, Wine debug output is very repetitive so it still compresses about 10 times
+static const int CompressionLevel = Z_BEST_SPEED;
+//// Read buffer of the decompression
+static const std::size_t DecompressBufferSize = 256 * 1024;
+
+/**
+ * \brief Write all data to the file descriptor
+ * \return True on success
+ */
+static bool write_all(int fd, const char* data, std::size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t count = write(fd, data, size);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+/**
+ * \brief Read the next block of the file
+ * \param[out] block Data, empty at the end of the file
+ * \return True on success
+ */
+static bool read_block(int fd, std::string& block)
+{
+  block.resize(BlockSize);
+  std::size_t size = 0;
+  while (size < BlockSize)
+  {
+    ssize_t count = read(fd, block.data() + size, BlockSize - size);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (count == 0)
+      break;
+    size += static_cast<std::size_t>(count);
+  }
+  block.resize(size);
+  return true;
+}
+
+/**
+ * \brief Compress the block into a complete gzip member
+ * \return True on success
+ */
+static bool compress_block(const std::string& block, std::string& compressed)
+{
+  z_stream stream{};
+  // 16 + window bits: gzip header & trailer
+  if (deflateInit2(&stream, CompressionLevel, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  compressed.resize(deflateBound(&stream, static_cast<uLong>(block.size())));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data()));
+  stream.avail_in = static_cast<uInt>(block.size());
+  stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  int result = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return result == Z_STREAM_END;
+}
+
+/**
+ * \brief Constructor, starts the compressor thread (compression is disabled until set_max_threads() is called)
+ */
+LogCompressor::LogCompressor() : max_threads_(0), is_stopping_(false), is_cancelled_(false)
+{
+  thread_ = std::thread(&LogCompressor::run, this);
+}
+
+/**
+ * \brief Destructor, stops the compressor thread. A running compression is cancelled, its rotated log file stays uncompressed.
+ */
+LogCompressor::~LogCompressor()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  is_cancelled_ = true;
+  condition_.notify_one();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+/**
+ * \brief Set the number of compression threads (thread-safe), used by the next compression
+ * \param[in] max_threads Number of threads, 0 disables the compression of rotated log files
+ */
+void LogCompressor::set_max_threads(int max_threads)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_threads_ = std::max(max_threads, 0);
+}
+
+/**
+ * \brief Number of compression threads for a share of the CPU
+ * \param[in] cpu_share Percentage of the CPU cores (0 - 100), at least one thread is used when the share is not 0
+ * \return Number of threads, 0 when the compression is disabled
+ */
+int LogCompressor::get_max_threads(int cpu_share)
+{
+  if (cpu_share <= 0)
+    return 0;
+  int cpu_cores = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+  return std::max(1, cpu_cores * std::min(cpu_share, 100) / 100);
+}
+
+/**
+ * \brief Rotate the log files (thread-safe): the oldest generation is removed, the other generations are renamed to the next generation.
+ * The log file becomes generation 1 and is compressed in the background (when enabled).
+ * \param[in] file_path Log file path
+ * \param[in] generations Number of rotated log files kept
+ */
+void LogCompressor::rotate(const string& file_path, int generations)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A missing generation is not an error
+  unlink(LogWriter::get_generation_path(file_path, generations).c_str());
+  unlink(get_compressed_path(file_path, generations).c_str());
+  for (int generation = generations - 1; generation >= 0; generation--)
+  {
+    rename(LogWriter::get_generation_path(file_path, generation).c_str(), LogWriter::get_generation_path(file_path, generation + 1).c_str());
+    if (generation > 0)
+      rename(get_compressed_path(file_path, generation).c_str(), get_compressed_path(file_path, generation + 1).c_str());
+  }
+
+  // The rotated log files that are not yet compressed are renamed as well
+  for (CompressTask& task : compress_tasks_)
+  {
+    if (task.file_path == file_path)
+      task.generation++;
+  }
+  std::erase_if(compress_tasks_, [](const CompressTask& task) { return task.generation > task.generations; });
+  if (running_compression_ && running_compression_->file_path == file_path)
+    running_compression_->generation++;
+
+  if (max_threads_ > 0)
+  {
+    compress_tasks_.push_back(CompressTask{file_path, 1, generations});
+    condition_.notify_one();
+  }
+}
+
+/**
+ * \brief Decompress a rotated log file in the background (thread-safe), before the pending compressions
+ * \param[in] compressed_path Compressed log file
+ * \param[in] output_path Decompressed log file, overwritten when it exists
+ * \param[in] on_finished Called when finished (in the compressor thread)
+ */
+void LogCompressor::decompress(const string& compressed_path, const string& output_path, DecompressCallback on_finished)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    decompress_tasks_.push_back(DecompressTask{compressed_path, output_path, std::move(on_finished)});
+  }
+  condition_.notify_one();
+}
+
+/**
+ * \brief Get the path of a compressed log file generation
+ * \param[in] file_path Log file path
+ * \param[in] generation Generation (1 or higher)
+ * \return Compressed path, eg. winegui.log.1.gz
+ */
+string LogCompressor::get_compressed_path(const string& file_path, int generation)
+{
+  return LogWriter::get_generation_path(file_path, generation) + ".gz";
+}
+
+/**
+ * \brief Compress the file to gzip, the blocks of the file are compressed in parallel
+ * \param[in] input_fd File to compress
+ * \param[in] output_path Compressed file, overwritten when it exists
+ * \param[in] threads Number of blocks compressed at the same time
+ * \param[in] is_cancelled Stop compressing when set (optional)
+ * \return True when the complete file is compressed
+ */
+bool LogCompressor::compress_file(int input_fd, const string& output_path, int threads, const std::atomic<bool>* is_cancelled)
+{
+  int output_fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (output_fd < 0)
+  {
+    std::cerr << "Error: Couldn't create compressed log file: " << output_path << ", " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  // Memory usage is bounded by the number of threads, not by the file size
+  std::size_t block_count = static_cast<std::size_t>(std::max(threads, 1));
+  std::vector<std::string> blocks(block_count);
+  std::vector<std::string> compressed_blocks(block_count);
+  std::vector<int> is_block_compressed(block_count);
+  bool is_success = true;
+  bool is_end = false;
+  while (is_success && !is_end)
+  {
+    if (is_cancelled != nullptr && *is_cancelled)
+    {
+      is_success = false;
+      break;
+    }
+    std::size_t count = 0;
+    while (count < block_count)
+    {
+      if (!read_block(input_fd, blocks.at(count)))
+      {
+        is_success = false;
+        break;
+      }
+      if (blocks.at(count).empty())
+      {
+        is_end = true;
+        break;
+      }
+      count++;
+    }
+    if (!is_success || count == 0)
+      break;
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < count; i++)
+      workers.emplace_back([&, i] { is_block_compressed[i] = compress_block(blocks[i], compressed_blocks[i]); });
+    is_block_compressed[0] = compress_block(blocks[0], compressed_blocks[0]);
+    for (std::thread& worker : workers)
+      worker.join();
+
+    // Concatenated in the original order
+    for (std::size_t i = 0; i < count && is_success; i++)
+    {
+      is_success = is_block_compressed.at(i) && write_all(output_fd, compressed_blocks.at(i).data(), compressed_blocks.at(i).size());
+    }
+  }
+  if (close(output_fd) != 0)
+    is_success = false;
+  if (!is_success)
+    unlink(output_path.c_str());
+  return is_success;
+}
+
+/**
+ * \brief Decompress a gzip file (all gzip members)
+ * \param[in] compressed_path Compressed file
+ * \param[in] output_path Decompressed file, overwritten when it exists
+ * \return True on success
+ */
+bool LogCompressor::decompress_file(const string& compressed_path, const string& output_path)
+{
+  gzFile input = gzopen(compressed_path.c_str(), "rb");
+  if (input == nullptr)
+  {
+    std::cerr << "Error: Couldn't open compressed log file: " << compressed_path << std::endl;
+    return false;
+  }
+  gzbuffer(input, static_cast<unsigned int>(DecompressBufferSize));
+  int output_fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (output_fd < 0)
+  {
+    std::cerr << "Error: Couldn't create log file: " << output_path << ", " << std::strerror(errno) << std::endl;
+    gzclose(input);
+    return false;
+  }
+  std::vector<char> buffer(DecompressBufferSize);
+  bool is_success = true;
+  int count;
+  while ((count = gzread(input, buffer.data(), static_cast<unsigned int>(buffer.size()))) > 0)
+  {
+    if (!write_all(output_fd, buffer.data(), static_cast<std::size_t>(count)))
+    {
+      is_success = false;
+      break;
+    }
+  }
+  if (count < 0)
+  {
+    int error_number;
+    std::cerr << "Error: Couldn't decompress log file: " << compressed_path << ", " << gzerror(input, &error_number) << std::endl;
+    is_success = false;
+  }
+  gzclose(input);
+  if (close(output_fd) != 0)
+    is_success = false;
+  return is_success;
+}
+
+/**
+ * \brief Compressor thread, handles the decompress requests first (the user is waiting on those)
+ */
+void LogCompressor::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    condition_.wait(lock, [this] { return is_stopping_ || !decompress_tasks_.empty() || !compress_tasks_.empty(); });
+    if (is_stopping_)
+      break;
+    if (!decompress_tasks_.empty())
+    {
+      DecompressTask task = std::move(decompress_tasks_.front());
+      decompress_tasks_.pop_front();
+      lock.unlock();
+      bool is_decompressed = decompress_file(task.compressed_path, task.output_path);
+      if (task.on_finished)
+        task.on_finished(is_decompressed);
+      lock.lock();
+      continue;
+    }
+    compress(lock);
+  }
+}
+
+/**
+ * \brief Compress the oldest rotated log file that is not yet compressed (compressor thread, the lock is released while compressing)
+ */
+void LogCompressor::compress(std::unique_lock<std::mutex>& lock)
+{
+  CompressTask task = compress_tasks_.front();
+  compress_tasks_.pop_front();
+  // Compression is disabled meanwhile, the rotated log file is kept as-is
+  if (max_threads_ <= 0)
+    return;
+  int threads = max_threads_;
+  // Opened within the lock, the rotation could rename the file right after
+  int input_fd = open(LogWriter::get_generation_path(task.file_path, task.generation).c_str(), O_RDONLY | O_CLOEXEC);
+  if (input_fd < 0)
+    return;
+  running_compression_ = task;
+  string output_path = task.file_path + ".compressing.gz";
+  lock.unlock();
+
+  bool is_compressed = compress_file(input_fd, output_path, threads, &is_cancelled_);
+  close(input_fd);
+
+  lock.lock();
+  // The generation is updated when the log file is rotated during the compression
+  const CompressTask& running = *running_compression_;
+  if (is_compressed && running.generation <= running.generations)
+  {
+    if (rename(output_path.c_str(), get_compressed_path(running.file_path, running.generation).c_str()) == 0)
+      unlink(LogWriter::get_generation_path(running.file_path, running.generation).c_str());
+    else
+      unlink(output_path.c_str());
+  }
+  else if (is_compressed)
+  {
+    // Too old already, removed by the rotation
+    unlink(output_path.c_str());
+  }
+  running_compression_.reset();
+}
@@ -0,0 +1,285 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    log_writer.cc
+ * \brief   Writes the log lines of the jobs from a single background thread, with size-based log rotation
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//// Lines are collected for at most this time before they are written, unless the buffers are half full
+static const std::chrono::milliseconds FlushInterval(250);
+
+/**
+ * \brief Constructor, starts the writer thread
+ * \param[in] log_compressor Rotates & compresses the log files (should outlive the log writer)
+ * \param[in] max_file_size Maximum log file size in bytes, the log file is rotated when it's exceeded
+ * \param[in] generations Number of rotated log files kept per bottle (0 = the log file is truncated instead)
+ * \param[in] max_pending_bytes Maximum total size of the lines that are not yet written, further lines are dropped
+ */
+LogWriter::LogWriter(LogCompressor& log_compressor, std::size_t max_file_size, int generations, std::size_t max_pending_bytes)
+    : log_compressor_(log_compressor),
+      max_file_size_(max_file_size),
+      generations_(generations),
+      max_pending_bytes_(max_pending_bytes),
+      pending_bytes_(0),
+      is_stopping_(false),
+      timestamp_second_(-1)
+{
+  thread_ = std::thread(&LogWriter::run, this);
+}
+
+/**
+ * \brief Destructor, writes the pending lines and stops the writer thread
+ */
+LogWriter::~LogWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  condition_.notify_one();
+  if (thread_.joinable())
+    thread_.join();
+}
+
+/**
+ * \brief Create the log stream of a job
+ * \param[in] file_path Log file of the bottle
+ * \param[in] bottle Bottle name
+ * \param[in] name Job name
+ * \return Log channel, pass it to write()
+ */
+LogChannel LogWriter::open_channel(const string& file_path, std::string_view bottle, std::string_view name)
+{
+  string source;
+  source.reserve(bottle.size() + name.size() + 6);
+  source.append("[").append(bottle).append("] [").append(name).append("]");
+  return LogChannel{file_path, std::move(source)};
+}
+
+/**
+ * \brief Add a log line (thread-safe), it's written by the writer thread. Never waits on the disk.
+ * The line is written as: <date> <time>.<milliseconds> [job <id>] [<bottle>] [<job name>] <line>
+ * \param[in] channel Log channel of the job
+ * \param[in] job_id Job ID
+ * \param[in] line Line, without line ending
+ */
+void LogWriter::write(const LogChannel& channel, std::uint64_t job_id, std::string_view line)
+{
+  auto now = std::chrono::system_clock::now();
+  std::time_t second = std::chrono::system_clock::to_time_t(now);
+  auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+  char prefix[48];
+  int prefix_length = std::snprintf(prefix, sizeof(prefix), ".%03d [job %llu] ", static_cast<int>(milliseconds),
+                                    static_cast<unsigned long long>(job_id));
+  if (prefix_length < 0)
+    return;
+  std::size_t prefix_size = std::min(static_cast<std::size_t>(prefix_length), sizeof(prefix) - 1);
+
+  bool is_notify = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (second != timestamp_second_)
+    {
+      // Only format the date & time once per second, localtime_r() is relatively slow
+      struct tm local_time;
+      localtime_r(&second, &local_time);
+      char buffer[32];
+      std::size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_time);
+      timestamp_.assign(buffer, length);
+      timestamp_second_ = second;
+    }
+    std::size_t size = timestamp_.size() + prefix_size + channel.source.size() + line.size() + 2;
+    // Wake-up the writer when the first line is added, or when the buffers become half full (no need to wait any longer)
+    is_notify = pending_.empty() || (pending_bytes_ < max_pending_bytes_ / 2 && pending_bytes_ + size >= max_pending_bytes_ / 2);
+    PendingLines& pending = pending_[channel.file_path];
+    if (pending_bytes_ + size > max_pending_bytes_)
+    {
+      pending.dropped_lines++;
+    }
+    else
+    {
+      pending.data.append(timestamp_).append(prefix, prefix_size).append(channel.source).append(" ").append(line).append("\n");
+      pending_bytes_ += size;
+    }
+  }
+  if (is_notify)
+    condition_.notify_one();
+}
+
+/**
+ * \brief Get the path of a log file generation
+ * \param[in] file_path Log file path
+ * \param[in] generation Generation, 0 is the current log file, 1 the last rotated log file, etc.
+ * \return Path of the generation
+ */
+string LogWriter::get_generation_path(const string& file_path, int generation)
+{
+  if (generation == 0)
+    return file_path;
+  return file_path + "." + std::to_string(generation);
+}
+
+/**
+ * \brief Number of rotated log files kept per bottle
+ */
+int LogWriter::generations() const
+{
+  return generations_;
+}
+
+/**
+ * \brief Writer thread, writes the pending lines in batches until the writer is stopped
+ */
+void LogWriter::run()
+{
+  std::map<string, PendingLines> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    condition_.wait(lock, [this] { return is_stopping_ || !pending_.empty(); });
+    if (pending_.empty())
+      break;
+    // Collect more lines, so they are written with a single write() call
+    condition_.wait_for(lock, FlushInterval, [this] { return is_stopping_ || pending_bytes_ >= max_pending_bytes_ / 2; });
+    batch.swap(pending_);
+    pending_bytes_ = 0;
+    lock.unlock();
+
+    write_batch(batch);
+    batch.clear();
+
+    lock.lock();
+    if (pending_.empty())
+    {
+      // Close the log files when idle, so a removed bottle doesn't keep the old file around
+      lock.unlock();
+      close_files();
+      lock.lock();
+    }
+  }
+  close_files();
+}
+
+/**
+ * \brief Write the pending lines to the log files (writer thread)
+ * \param[in] batch Pending lines per log file path
+ */
+void LogWriter::write_batch(std::map<string, PendingLines>& batch)
+{
+  for (auto& [file_path, pending] : batch)
+  {
+    if (pending.dropped_lines > 0)
+      pending.data.append("WineGUI: " + std::to_string(pending.dropped_lines) + " log lines dropped, writing the log file is too slow\n");
+    write_file(file_path, pending.data);
+  }
+}
+
+/**
+ * \brief Append the data to the log file, the log file is rotated first when the data doesn't fit (writer thread)
+ * \param[in] file_path Log file path
+ * \param[in] data Lines to append
+ */
+void LogWriter::write_file(const string& file_path, const string& data)
+{
+  auto it = open_files_.find(file_path);
+  if (it == open_files_.end())
+  {
+    OpenFile file;
+    if (!open_file(file_path, file))
+      return;
+    it = open_files_.emplace(file_path, file).first;
+  }
+  OpenFile& file = it->second;
+  if (file.size > 0 && static_cast<std::size_t>(file.size) + data.size() > max_file_size_)
+  {
+    close(file.fd);
+    open_files_.erase(it);
+    rotate(file_path);
+    OpenFile new_file;
+    if (!open_file(file_path, new_file))
+      return;
+    it = open_files_.emplace(file_path, new_file).first;
+  }
+
+  const char* buffer = data.data();
+  std::size_t remaining = data.size();
+  while (remaining > 0)
+  {
+    ssize_t count = ::write(it->second.fd, buffer, remaining);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      std::cerr << "Error: Couldn't write to log file: " << file_path << ", " << std::strerror(errno) << std::endl;
+      break;
+    }
+    buffer += count;
+    remaining -= static_cast<std::size_t>(count);
+    it->second.size += count;
+  }
+}
+
+/**
+ * \brief Open (or create) the log file for appending (writer thread)
+ * \param[in] file_path Log file path
+ * \param[out] file Opened file
+ * \return True when the file is opened
+ */
+bool LogWriter::open_file(const string& file_path, OpenFile& file)
+{
+  file.fd = open(file_path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (file.fd < 0)
+  {
+    std::cerr << "Error: Couldn't open log file: " << file_path << ", " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  struct stat file_stat;
+  file.size = fstat(file.fd, &file_stat) == 0 ? file_stat.st_size : 0;
+  return true;
+}
+
+/**
+ * \brief Rotate the log file, the log file must be closed (writer thread)
+ * \param[in] file_path Log file path
+ */
+void LogWriter::rotate(const string& file_path)
+{
+  if (generations_ <= 0)
+    truncate(file_path.c_str(), 0);
+  else
+    log_compressor_.rotate(file_path, generations_);
+}
+
+/**
+ * \brief Close all opened log files (writer thread)
+ */
+void LogWriter::close_files()
+{
+  for (auto& [file_path, file] : open_files_)
+    close(file.fd);
+  open_files_.clear();
+}
@@ -19,20 +19,16 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "about_dialog.h"
-#include "add_app_window.h"
-#include "bottle_clone_window.h"
-#include "bottle_configure_env_var_window.h"
-#include "bottle_configure_window.h"
-#include "bottle_edit_window.h"
 #include "bottle_manager.h"
 #include "main_window.h"
 #include "menu.h"
-#include "preferences_window.h"
-#include "remove_app_window.h"
+#include "pixbuf_cache.h"
 #include "signal_controller.h"
+#include "startup_profiler.h"
 
 #include <gtkmm/application.h>
 #include <iostream>
+#include <memory>
 
 // Prototype
 static MainWindow& setupApplication();
@@ -43,55 +39,86 @@ static MainWindow& setupApplication();
  */
 int main(int argc, char* argv[])
 {
-  if (argc > 1)
+  bool is_profile_startup = false;
+  std::string trace_file_path;
+  for (int i = 1; i < argc; ++i)
   {
-    for (int i = 1; i < argc; ++i)
+    std::string arg = argv[i];
+    if (arg == "--version")
     {
-      std::string arg = argv[i];
-      if (arg == "--version")
-      {
-        // Retrieve version and print it
-        std::string version = AboutDialog::get_version();
-        std::cout << "WineGUI " << version << std::endl;
-        return 0;
-      }
+      // Retrieve version and print it
+      std::string version = AboutDialog::get_version();
+      std::cout << "WineGUI " << version << std::endl;
+      return 0;
+    }
+    else if (arg == "--profile-startup")
+    {
+      is_profile_startup = true;
+    }
+    else if (arg.starts_with("--profile-startup="))
+    {
+      // Also write a Chrome trace file
+      is_profile_startup = true;
+      trace_file_path = arg.substr(std::string("--profile-startup=").size());
+    }
+    else
+    {
+      std::cerr << "Error: Parameter not understood (only --version and --profile-startup[=trace.json] are accepted parameters)!" << std::endl;
+      return 1;
     }
-    std::cerr << "Error: Parameter not understood (only --version is an accepted parameter)!" << std::endl;
-    return 1;
   }
-  else
+
+  if (is_profile_startup)
+    StartupProfiler::enable(trace_file_path, {StartupProfiler::FirstFrame, StartupProfiler::BottlesLoaded});
+  Glib::RefPtr<Gtk::Application> app;
+  {
+    StartupProfiler::Scope scope("Create application");
+    app = Gtk::Application::create("org.melroy.winegui");
+  }
+  // Setup
+  MainWindow& main_window = setupApplication();
+  if (is_profile_startup)
   {
-    auto app = Gtk::Application::create("org.melroy.winegui");
-    // Setup
-    MainWindow& main_window = setupApplication();
-    // Start main loop of GTK
-    return app->run(main_window, argc, argv);
+    auto first_draw = std::make_shared<sigc::connection>();
+    *first_draw = main_window.signal_draw().connect(
+        [first_draw](const Cairo::RefPtr<Cairo::Context>& /* cr */)
+        {
+          StartupProfiler::milestone(StartupProfiler::FirstFrame);
+          first_draw->disconnect();
+          return false;
+        },
+        true);
   }
+  // Start main loop of GTK (the command-line parameters are already handled)
+  int status = app->run(main_window);
+  // Closed before all the milestones are reached
+  StartupProfiler::report();
+  if (is_profile_startup)
+    PixbufCache::get_instance().print_statistics(); // Icons decoded vs. reused during the session
+  return status;
 }
 
 static MainWindow& setupApplication()
 {
-  // Constructing the top level objects:
+  StartupProfiler::Scope scope("Setup application");
+  gint64 construct_start_time = g_get_monotonic_time();
+  // Constructing the top level objects, the secondary windows (preferences, edit, etc.) are constructed on first use by the signal controller
   static Menu menu;
   static MainWindow main_window(menu);
   static BottleManager manager(main_window);
-  static PreferencesWindow preferences_window(main_window);
-  static AboutDialog about_dialog(main_window);
-  static BottleEditWindow edit_window(main_window);
-  static BottleCloneWindow clone_window(main_window);
-  static BottleConfigureEnvVarWindow settings_env_var_window(edit_window);
-  static BottleConfigureWindow settings_window(main_window);
-  static AddAppWindow add_app_window(main_window);
-  static RemoveAppWindow remove_app_window(main_window);
-  static SignalController signal_controller(manager, menu, preferences_window, about_dialog, edit_window, clone_window, settings_env_var_window,
-                                            settings_window, add_app_window, remove_app_window);
+  static SignalController signal_controller(manager, menu);
+  StartupProfiler::record("Construct windows", "", construct_start_time, g_get_monotonic_time());
 
   signal_controller.set_main_window(&main_window);
   // Do all the signal connections of the life-time of the app
-  signal_controller.dispatch_signals();
+  {
+    StartupProfiler::Scope signals_scope("Connect signals");
+    signal_controller.dispatch_signals();
+  }
 
   // Call the Bottle Manager prepare method,
   // it will prepare Winetricks & retrieve Wine Bottles
+  StartupProfiler::Scope prepare_scope("Prepare bottle manager");
   manager.prepare();
   return main_window;
 }
@@ -19,14 +19,25 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "main_window.h"
+#include "app_search.h"
+#include "desktop_entry_index.h"
 #include "helper.h"
+#include "pixbuf_cache.h"
 #include "project_config.h"
+#include "startup_profiler.h"
 #include <algorithm>
 #include <cctype>
+#include <climits>
+#include <iterator>
 #include <locale>
 #include <set>
 #include <utility>
 
+//// Number of resolved application rows that are added to the application list at once
+static const std::size_t AppListBatchSize = 50;
+//// Search rank of an application row that is not yet ranked for the current search query
+static const int UnknownRank = INT_MIN;
+
 /************************
  * Public methods       *
  ************************/
@@ -46,21 +57,20 @@ MainWindow::MainWindow(Menu& menu)
       busy_dialog_(*this),
       unknown_menu_item_name_("- Unknown menu item -"),
       unknown_desktop_item_name_("- Unknown desktop item -"),
-      thread_check_version_(nullptr)
+      bottles_(nullptr),
+      thread_check_version_(nullptr),
+      app_list_cancelled_(false),
+      app_list_finished_(false),
+      app_list_next_order_(1)
 {
   // Set some Window properties
   set_title("WineGUI - WINE Manager");
   set_default_size(1120, 675);
   set_position(Gtk::WIN_POS_CENTER);
 
-  try
-  {
-    set_icon_from_file(Helper::get_image_location("logo.png"));
-  }
-  catch (Glib::FileError& e)
-  {
-    cout << "Error: couldn't load our logo: " << e.what() << endl;
-  }
+  Glib::RefPtr<Gdk::Pixbuf> logo = Helper::get_image("logo.png");
+  if (logo)
+    set_icon(logo);
 
   // Add menu to box (top), no expand/fill
   vbox.pack_start(menu, false, false);
@@ -87,6 +97,9 @@ MainWindow::MainWindow(Menu& menu)
 
   // Left side (listbox)
   listbox.signal_row_selected().connect(sigc::mem_fun(*this, &MainWindow::on_bottle_row_clicked));
+  // Only the visible rows get their widgets
+  scrolled_window_listbox.get_vadjustment()->signal_value_changed().connect(sigc::mem_fun(*this, &MainWindow::update_visible_bottle_rows));
+  listbox.signal_size_allocate().connect(sigc::hide(sigc::mem_fun(*this, &MainWindow::schedule_update_visible_bottle_rows)));
   // Disabled right-click menu for now, since it doesn't activate the right-clicked bottle as active
   // listbox.signal_button_press_event().connect(right_click_menu);
 
@@ -98,8 +111,8 @@ MainWindow::MainWindow(Menu& menu)
   // Connect the new bottle assistant signal to the mainWindow signal
   new_bottle_assistant_.new_bottle_finished.connect(finished_new_bottle);
 
-  // Application search
-  app_list_search_entry.signal_changed().connect(sigc::mem_fun(*this, &MainWindow::on_app_list_changed));
+  // Application search, the search entry already delays the signal until the user stopped typing (debounce)
+  app_list_search_entry.signal_search_changed().connect(sigc::mem_fun(*this, &MainWindow::on_app_list_changed));
 
   // Trigger row activated signal on a single click
   application_list_treeview.set_activate_on_single_click(true);
@@ -126,6 +139,7 @@ MainWindow::MainWindow(Menu& menu)
   info_message_check_version_dispatcher_.connect(sigc::mem_fun(this, &MainWindow::on_info_message_check_version));
   new_version_available_dispatcher_.connect(sigc::mem_fun(this, &MainWindow::on_new_version_available));
   check_version_finished_dispatcher_.connect(sigc::mem_fun(this, &MainWindow::cleanup_check_version_thread));
+  app_list_rows_dispatcher_.connect(sigc::mem_fun(this, &MainWindow::on_application_rows_resolved));
 
   // Check for update without (error) messages, when app is idle
   Glib::signal_idle().connect_once(sigc::bind(sigc::mem_fun(*this, &MainWindow::check_version_update), false), Glib::PRIORITY_DEFAULT_IDLE);
@@ -143,38 +157,103 @@ MainWindow::~MainWindow()
 {
   // Avoid zombies
   this->cleanup_check_version_thread();
+  this->cancel_application_list();
+  visible_rows_idle_.disconnect();
 }
 
 /**
- * \brief Set a list of bottles to the left panel
- * \param[in] bottles - Wine Bottle item list
+ * \brief Set a list of bottles to the left panel. The bottle list model is reconciled on prefix path: rows that are already
+ * in the listbox are kept (incl. their widgets), only the removed rows are removed and the new rows are inserted.
+ * \param[in] bottles - Wine Bottle data (in the order of the listbox), the vector is owned by the caller
  */
-void MainWindow::set_wine_bottles(std::list<BottleItem>& bottles)
+void MainWindow::set_wine_bottles(std::vector<BottleRecord>& bottles)
 {
-  // Clear whole listbox
-  std::vector<Gtk::Widget*> children = listbox.get_children();
-  for (Gtk::Widget* el : children)
+  bottles_ = &bottles;
+  // Remove the items that are no longer in the list (from the end, so the positions of the other items are unchanged)
+  std::set<string> prefixes;
+  for (const BottleRecord& bottle : bottles)
+    prefixes.insert(bottle.wine_location().raw());
+  for (guint position = bottle_list_store->get_n_items(); position-- > 0;)
   {
-    listbox.remove(*el);
+    if (!prefixes.contains(bottle_list_store->get_item(position)->wine_location()))
+      bottle_list_store->remove(position);
   }
 
-  for (BottleItem& bottle : bottles)
+  // Insert the new items at their position (the remaining items are in the same order), consecutive items are inserted at once
+  guint position = 0;
+  std::vector<Glib::RefPtr<BottleListItem>> additions;
+  for (const BottleRecord& bottle : bottles)
   {
-    listbox.add(bottle);
+    if (position < bottle_list_store->get_n_items() && bottle_list_store->get_item(position)->wine_location() == bottle.wine_location().raw())
+    {
+      if (!additions.empty())
+      {
+        bottle_list_store->splice(position, 0, additions);
+        position += static_cast<guint>(additions.size());
+        additions.clear();
+      }
+      position++;
+    }
+    else
+    {
+      additions.push_back(BottleListItem::create(bottle.wine_location().raw()));
+    }
   }
-  // Enable/disable toolbar buttons depending on listbox
-  set_sensitive_toolbar_buttons(bottles.size() > 0);
-  listbox.show_all();
+  if (!additions.empty())
+    bottle_list_store->splice(position, 0, additions);
+
+  // The bottles are moved in memory, update the active bottle of the connected modules
+  Gtk::ListBoxRow* selected_row = listbox.get_selected_row();
+  if (selected_row != nullptr)
+  {
+    BottleRecord& selected_bottle = bottles.at(selected_row->get_index());
+    active_bottle.emit(&selected_bottle);
+    // Enable/disable toolbar buttons depending on the kept selected row
+    set_sensitive_toolbar_buttons(!selected_bottle.is_loading() && selected_bottle.is_details_loaded());
+  }
+  else
+  {
+    set_sensitive_toolbar_buttons(bottles.size() > 0);
+  }
+  schedule_update_visible_bottle_rows();
 }
 
 /**
- * \brief Set provided bottle as current selected row (if nothing was selected yet)
- * \param[in] bottle - Wine Bottle item object
+ * \brief Update a bottle in the left panel, after the bottle details are (re)loaded
+ * \param[in] index - Row index of the bottle
  */
-void MainWindow::select_row_bottle(BottleItem& bottle)
+void MainWindow::update_wine_bottle(std::size_t index)
 {
-  if (!bottle.is_selected())
-    this->listbox.select_row(bottle);
+  auto* row = dynamic_cast<BottleItem*>(listbox.get_row_at_index(static_cast<int>(index)));
+  if (row == nullptr || bottles_ == nullptr || index >= bottles_->size())
+    return;
+  const BottleRecord& bottle = bottles_->at(index);
+  // Rows that are not visible yet, are created with the latest data once they become visible
+  if (row->is_ui_created())
+    row->update_ui(bottle);
+  // Refresh the detailed info when the updated bottle is the selected bottle (eg. inspected again after a change outside WineGUI).
+  // The application list and the search text are kept, the application list is only loaded again when the applications are changed.
+  if (row->is_selected())
+  {
+    set_sensitive_toolbar_buttons(!bottle.is_loading() && bottle.is_details_loaded());
+    set_detailed_info(bottle);
+    if (bottle.wine_location().raw() != app_list_prefix_ || bottle.app_list() != app_list_data_)
+      set_application_list(bottle.wine_location(), bottle.app_list());
+    // Placeholder row is loaded, the details are loaded on demand
+    if (!bottle.is_loading() && !bottle.is_details_loaded())
+      load_bottle_details.emit(index);
+  }
+}
+
+/**
+ * \brief Set provided bottle as current selected row (if not yet selected)
+ * \param[in] index - Row index of the bottle
+ */
+void MainWindow::select_row_bottle(std::size_t index)
+{
+  Gtk::ListBoxRow* row = listbox.get_row_at_index(static_cast<int>(index));
+  if (row != nullptr && !row->is_selected())
+    this->listbox.select_row(*row);
 }
 
 /**
@@ -203,7 +282,10 @@ void MainWindow::reset_detailed_info()
  */
 void MainWindow::reset_application_list()
 {
-  app_list_tree_model->clear();
+  clear_application_list();
+  app_list_prefix_.clear();
+  app_list_data_.clear();
+  app_list_query_.clear();
   app_list_search_entry.set_text("");
 }
 
@@ -390,16 +472,18 @@ void MainWindow::on_run_button_clicked()
 }
 
 /**
- * \brief Triggered when the user pressed the application list refresh button
+ * \brief Triggered when the user pressed the application list refresh button (or the Wine desktop files changed)
  */
 void MainWindow::on_refresh_app_list_button_clicked()
 {
+  // Desktop files could be rewritten in place, read them again
+  DesktopEntryIndex::get_instance().clear();
   Gtk::ListBoxRow* selected_row = listbox.get_selected_row();
   if (selected_row)
   {
     // Refresh the current app list
-    const auto* current_bottle = dynamic_cast<BottleItem*>(selected_row);
-    set_application_list(current_bottle->wine_location(), current_bottle->app_list());
+    const BottleRecord& current_bottle = bottles_->at(selected_row->get_index());
+    set_application_list(current_bottle.wine_location(), current_bottle.app_list());
   }
 }
 
@@ -462,31 +546,47 @@ void MainWindow::on_exec_failure()
  */
 void MainWindow::on_bottle_row_clicked(Gtk::ListBoxRow* row)
 {
-  if (row != nullptr)
+  if (row != nullptr && bottles_ != nullptr && static_cast<std::size_t>(row->get_index()) < bottles_->size())
   {
-    auto current_bottle = dynamic_cast<BottleItem*>(row);
+    std::size_t index = static_cast<std::size_t>(row->get_index());
+    BottleRecord* current_bottle = &bottles_->at(index);
+    // Bottle actions are only possible once the bottle (incl. details) is loaded
+    set_sensitive_toolbar_buttons(!current_bottle->is_loading() && current_bottle->is_details_loaded());
     // Set bottle details
     set_detailed_info(*current_bottle);
-    // Set application list
+    // Clear the application filter & set application list
+    reset_application_list();
     set_application_list(current_bottle->wine_location(), current_bottle->app_list());
-    // Clear the application filter
-    app_list_search_entry.set_text("");
 
-    // Signal activate Bottle with current BottleItem as parameter to the dispatcher
+    // Signal activate Bottle with current BottleRecord as parameter to the dispatcher
     // Which updates the connected modules accordingly.
     active_bottle.emit(current_bottle);
+
+    // Details are loaded on demand, the detailed info is updated once loaded (see update_wine_bottle())
+    if (!current_bottle->is_loading() && !current_bottle->is_details_loaded())
+      load_bottle_details.emit(index);
   }
 }
 
+/**
+ * \brief Search query changed, rank all the applications again & show the matching applications (best match first)
+ */
 void MainWindow::on_app_list_changed()
 {
-  // Refilter
+  string query = AppSearch::normalize(app_list_search_entry.get_text());
+  if (query == app_list_query_)
+    return;
+  app_list_query_ = query;
+  // The rows are ranked on demand (see app_list_rank())
+  app_list_ranks_.clear();
   app_list_filter->refilter();
+  create_app_list_sort_model();
 }
 
 void MainWindow::on_application_row_activated(const Gtk::TreeModel::Path& path, Gtk::TreeViewColumn* /* column */)
 {
-  const auto iter = app_list_tree_model->get_iter(path);
+  // Path of the (filtered & sorted) tree view model
+  const auto iter = application_list_treeview.get_model()->get_iter(path);
   if (iter)
   {
     const auto row = *iter;
@@ -581,7 +681,7 @@ bool MainWindow::on_delete_window(GdkEventAny* any_event __attribute__((unused))
  * \brief set the detailed info panel on the right
  * \param[in] bottle - Wine Bottle item object
  */
-void MainWindow::set_detailed_info(const BottleItem& bottle)
+void MainWindow::set_detailed_info(const BottleRecord& bottle)
 {
   // Set right side of the GUI
   name_label.set_text(bottle.name());
@@ -618,21 +718,49 @@ void MainWindow::set_detailed_info(const BottleItem& bottle)
 }
 
 /**
- * \brief Set application list
+ * \brief Set application list, the list is resolved in a thread (reading desktop & shortcut files and decoding the icons).
+ * The rows are added in batches, any previous (unfinished) list is cancelled. The search text is kept.
  * \param prefix_path Wine bottle prefix
- * \param app_List Custom application list for this bottle
+ * \param app_list Custom application list for this bottle
  */
 void MainWindow::set_application_list(const string& prefix_path, const std::map<int, ApplicationData>& app_list)
 {
-  // First clear list + clear search entry
-  reset_application_list();
+  // First clear list
+  clear_application_list();
+  app_list_prefix_ = prefix_path;
+  app_list_data_ = app_list;
+  app_list_cancelled_ = false;
+  thread_app_list_ = std::make_unique<std::thread>([this, prefix_path, app_list] { resolve_application_list(prefix_path, app_list); });
+}
+
+/**
+ * \brief Resolve the application list (runs in the app list thread), the rows are passed to the GUI thread in batches
+ * \param prefix_path Wine bottle prefix
+ * \param app_list Custom application list for this bottle
+ */
+void MainWindow::resolve_application_list(const string& prefix_path, const std::map<int, ApplicationData>& app_list)
+{
+  StartupProfiler::Scope scope("Resolve application list", prefix_path);
+  std::vector<ApplicationRow> batch;
+  // Add a resolved application to the batch, returns false when the resolving is cancelled
+  auto add_application = [this, &batch](const string& name, const string& description, const string& command, const string& icon,
+                                        bool is_icon_full_path = false)
+  {
+    if (app_list_cancelled_)
+      return false;
+    batch.push_back(create_application_row(name, description, command, icon, is_icon_full_path));
+    if (batch.size() >= AppListBatchSize)
+      push_application_rows(batch, false);
+    return true;
+  };
 
   // First add the custom application items
   for (const auto& [_, app_data] : app_list)
   {
     string command = app_data.command;
     string icon = Helper::string_to_icon(command);
-    add_application(app_data.name, app_data.description, command, icon);
+    if (!add_application(app_data.name, app_data.description, command, icon))
+      return;
   }
 
   // Temporally store the list of menu item names,
@@ -708,7 +836,8 @@ void MainWindow::set_application_list(const string& prefix_path, const std::map<
         icon = Helper::string_to_icon(item);
         is_icon_full_path = false;
       }
-      add_application(name, comment, item, icon, is_icon_full_path);
+      if (!add_application(name, comment, item, icon, is_icon_full_path))
+        return;
       // Also add the name to your list, used for finding duplicates when adding desktop files
       if (name != unknown_menu_item_name_)
         menu_item_names.insert(name);
@@ -787,7 +916,8 @@ void MainWindow::set_application_list(const string& prefix_path, const std::map<
           icon = Helper::string_to_icon(value_name);
           is_icon_full_path = false;
         }
-        add_application(name, "", value_data, icon, is_icon_full_path);
+        if (!add_application(name, "", value_data, icon, is_icon_full_path))
+          return;
       }
     }
   }
@@ -796,7 +926,7 @@ void MainWindow::set_application_list(const string& prefix_path, const std::map<
     cout << "Error: " << error.what() << std::endl;
   }
 
-  // Lastly, the additional programs
+  // Lastly, the additional programs (cheap, the icons are compiled into the binary)
   add_application("Wine Config", "Wine configuration program", "winecfg", "winecfg");
   add_application("Uninstaller", "Remove programs", "uninstaller", "uninstaller");
   add_application("Control Panel", "Wine control panel", "control", "winecontrol");
@@ -811,32 +941,123 @@ void MainWindow::set_application_list(const string& prefix_path, const std::map<
   add_application("Command Prompt", "Command-line interpreter", "wineconsole", "command_prompt");
   add_application("Registry editor", "Windows registry editor", "regedit", "regedit");
   add_application("Wine OLE View", "Windows OLE object viewer", "oleview", "oleview");
+
+  push_application_rows(batch, true);
 }
 
 /**
- * \brief Add application to tree model list
+ * \brief Create an application row, including the decoded icon (runs in the app list thread)
  * \param name Application name
  * \param description Application description
  * \param command Application command
  * \param icon Application icon (icon name or full path to icon)
  * \param is_icon_full_path (Optionally) Use icon as full path (default: false, meaning icon is only the icon file name)
+ * \return Application row
  */
-void MainWindow::add_application(const string& name, const string& description, const string& command, const string& icon, bool is_icon_full_path)
+MainWindow::ApplicationRow
+MainWindow::create_application_row(const string& name, const string& description, const string& command, const string& icon, bool is_icon_full_path)
+{
+  StartupProfiler::Scope scope("Load application icon", icon);
+  // Decoded icons are shared by all the bottles
+  PixbufCache& pixbuf_cache = PixbufCache::get_instance();
+  Glib::RefPtr<Gdk::Pixbuf> pixbuf = (is_icon_full_path) ? pixbuf_cache.get_file(icon) // Use icon as full path
+                                                         : pixbuf_cache.get_image("apps/" + icon + ".png");
+  // Search keys & markup are prepared once, instead of during every search or render
+  Glib::ustring encoded_name = Helper::encode_text(name);
+  Glib::ustring encoded_description = Helper::encode_text(description);
+  Glib::ustring markup = "<b>" + encoded_name + "</b>\n" + encoded_description;
+  return {encoded_name, encoded_description, command, pixbuf, markup, AppSearch::normalize(name), AppSearch::normalize(description)};
+}
+
+/**
+ * \brief Pass a batch of resolved application rows to the GUI thread (runs in the app list thread)
+ * \param[in,out] batch Application rows, the batch is empty afterwards
+ * \param is_finished True when this is the last batch
+ */
+void MainWindow::push_application_rows(std::vector<ApplicationRow>& batch, bool is_finished)
 {
-  auto row = *(app_list_tree_model->append());
-  row[app_list_columns.name] = Helper::encode_text(name);
-  row[app_list_columns.description] = Helper::encode_text(description);
-  row[app_list_columns.command] = command;
-  try
   {
-    if (!is_icon_full_path)
-      row[app_list_columns.icon] = Gdk::Pixbuf::create_from_file(Helper::get_image_location("apps/" + icon + ".png"));
-    else
-      row[app_list_columns.icon] = Gdk::Pixbuf::create_from_file(icon); // Use icon as full path
+    std::lock_guard<std::mutex> lock(app_list_mutex_);
+    std::move(batch.begin(), batch.end(), std::back_inserter(app_list_rows_));
+    app_list_finished_ = is_finished;
   }
-  catch (const Glib::Error& error)
+  batch.clear();
+  app_list_rows_dispatcher_.emit();
+}
+
+/**
+ * \brief Signal handler when a batch of application rows is resolved, add the rows to the application list (GUI thread)
+ */
+void MainWindow::on_application_rows_resolved()
+{
+  std::vector<ApplicationRow> rows;
+  bool is_finished;
   {
-    std::cerr << "ERROR: Could not find icon (" << icon << ") for app " << name << ": " << error.what() << std::endl;
+    std::lock_guard<std::mutex> lock(app_list_mutex_);
+    rows.swap(app_list_rows_);
+    is_finished = app_list_finished_;
+    app_list_finished_ = false;
+  }
+  {
+    StartupProfiler::Scope scope("Insert application rows");
+    for (const ApplicationRow& application : rows)
+      add_application(application);
+  }
+  if (is_finished)
+    cleanup_app_list_thread();
+}
+
+/**
+ * \brief Add application to tree model list
+ * \param application Resolved application row
+ */
+void MainWindow::add_application(const ApplicationRow& application)
+{
+  auto row = *(app_list_tree_model->append());
+  row[app_list_columns.name] = application.name;
+  row[app_list_columns.description] = application.description;
+  row[app_list_columns.command] = application.command;
+  row[app_list_columns.icon] = application.icon;
+  row[app_list_columns.markup] = application.markup;
+  row[app_list_columns.name_key] = application.name_key;
+  row[app_list_columns.description_key] = application.description_key;
+  // Set as last column, the row is only ranked once the order is set (see app_list_rank())
+  row[app_list_columns.order] = app_list_next_order_++;
+}
+
+/**
+ * \brief Clear the application list rows, without clearing the search text
+ */
+void MainWindow::clear_application_list()
+{
+  // Stop resolving the list of the previous bottle
+  cancel_application_list();
+  app_list_tree_model->clear();
+  app_list_ranks_.clear();
+  app_list_next_order_ = 1;
+}
+
+/**
+ * \brief Cancel the application list thread (if running) and discard its pending rows
+ */
+void MainWindow::cancel_application_list()
+{
+  app_list_cancelled_ = true;
+  cleanup_app_list_thread();
+  std::lock_guard<std::mutex> lock(app_list_mutex_);
+  app_list_rows_.clear();
+  app_list_finished_ = false;
+}
+
+/**
+ * \brief Helper method for cleaning the app list thread.
+ */
+void MainWindow::cleanup_app_list_thread()
+{
+  if (thread_app_list_ && thread_app_list_->joinable())
+  {
+    thread_app_list_->join();
+    thread_app_list_.reset();
   }
 }
 
@@ -963,10 +1184,62 @@ void MainWindow::create_left_panel()
   // Set function that will add separators between each item
   listbox.set_header_func(sigc::ptr_fun(&MainWindow::cc_list_box_update_header_func));
 
+  // Bottle list model, the rows are created by the listbox
+  bottle_list_store = Gio::ListStore<BottleListItem>::create();
+  listbox.bind_list_store(bottle_list_store, sigc::mem_fun(*this, &MainWindow::create_bottle_row));
+
   // Add list box to scrolled window
   scrolled_window_listbox.add(listbox);
 }
 
+/**
+ * \brief Create the listbox row of a bottle list model item (called by the listbox).
+ * The row is empty until it becomes visible, see update_visible_bottle_rows().
+ * \param[in] item Bottle list model item
+ * \return Row widget (managed by the listbox)
+ */
+Gtk::Widget* MainWindow::create_bottle_row(const Glib::RefPtr<BottleListItem>& /* item */)
+{
+  return Gtk::manage(new BottleItem());
+}
+
+/**
+ * \brief Update the visible bottle rows once idle (after the listbox is allocated)
+ */
+void MainWindow::schedule_update_visible_bottle_rows()
+{
+  if (!visible_rows_idle_.connected())
+    visible_rows_idle_ = Glib::signal_idle().connect(
+        [this]
+        {
+          update_visible_bottle_rows();
+          return false;
+        });
+}
+
+/**
+ * \brief Create the widgets of the bottle rows that are visible in the scrolled window (only once per row),
+ * the widgets of the other rows are created once the user scrolls to them.
+ */
+void MainWindow::update_visible_bottle_rows()
+{
+  StartupProfiler::Scope scope("Create visible bottle rows");
+  Glib::RefPtr<Gtk::Adjustment> adjustment = scrolled_window_listbox.get_vadjustment();
+  if (bottles_ == nullptr || adjustment->get_page_size() <= 0)
+    return; // Not yet allocated
+  double top = adjustment->get_value();
+  double bottom = top + adjustment->get_page_size();
+  const Gtk::ListBoxRow* first_row = listbox.get_row_at_y(static_cast<int>(top));
+  for (int index = (first_row != nullptr) ? first_row->get_index() : 0; static_cast<std::size_t>(index) < bottles_->size(); index++)
+  {
+    auto* row = dynamic_cast<BottleItem*>(listbox.get_row_at_index(index));
+    if (row == nullptr || row->get_allocation().get_y() > bottom)
+      break;
+    if (!row->is_ui_created())
+      row->update_ui(bottles_->at(index));
+  }
+}
+
 /**
  * \brief Create right side of the GUI
  */
@@ -1211,12 +1484,12 @@ void MainWindow::create_right_panel()
   app_list_tree_model = Gtk::ListStore::create(app_list_columns);
   app_list_filter = Gtk::TreeModelFilter::create(app_list_tree_model);
   app_list_filter->set_visible_func(sigc::mem_fun(*this, &MainWindow::app_list_visible_func));
-  application_list_treeview.set_model(app_list_filter);
+  create_app_list_sort_model();
 
   name_desc_column.pack_start(name_desc_renderer_text);
-  application_list_treeview.append_column("icon", app_list_columns.icon); // TODO: Add spacing, maybe also use a custom method like below
+  application_list_treeview.append_column("icon", app_list_columns.icon); // TODO: Add spacing
   application_list_treeview.append_column(name_desc_column);
-  name_desc_column.set_cell_data_func(name_desc_renderer_text, sigc::mem_fun(*this, &MainWindow::treeview_set_cell_data_name_desc));
+  name_desc_column.add_attribute(name_desc_renderer_text.property_markup(), app_list_columns.markup);
 
   application_list_treeview.set_headers_visible(false);
   application_list_treeview.set_hover_selection(true);
@@ -1333,34 +1606,58 @@ void MainWindow::cc_list_box_update_header_func(Gtk::ListBoxRow* list_box_row, G
 }
 
 /**
- * \brief Filter application list
+ * \brief Filter application list, only the applications that match the search query are visible
  * \param iter Tree model iterator
  * \return true if application should be visible, otherwise false
  */
 bool MainWindow::app_list_visible_func(const Gtk::TreeModel::const_iterator& iter)
 {
-  Gtk::TreeModel::Row row = *iter;
-  Glib::ustring name = row[app_list_columns.name];
-  Glib::ustring description = row[app_list_columns.description];
-  if (name.lowercase().find(app_list_search_entry.get_text().lowercase()) != Glib::ustring::npos)
-  {
-    return true;
-  }
-  if (description.lowercase().find(app_list_search_entry.get_text().lowercase()) != Glib::ustring::npos)
+  return app_list_rank(*iter) != AppSearch::NoMatch;
+}
+
+/**
+ * \brief Sort the application list on the search rank (best match first), equal ranks keep the insertion order
+ * \return Negative if a comes before b, positive if b comes before a
+ */
+int MainWindow::app_list_sort_func(const Gtk::TreeModel::iterator& a, const Gtk::TreeModel::iterator& b)
+{
+  int rank_a = app_list_rank(*a);
+  int rank_b = app_list_rank(*b);
+  if (rank_a != rank_b)
+    return (rank_a > rank_b) ? -1 : 1;
+  int order_a = (*a)[app_list_columns.order];
+  int order_b = (*b)[app_list_columns.order];
+  return order_a - order_b;
+}
+
+/**
+ * \brief Search rank of an application row for the current search query, the rank is calculated once per query
+ * \param row Application row
+ * \return Rank or AppSearch::NoMatch
+ */
+int MainWindow::app_list_rank(const Gtk::TreeModel::Row& row)
+{
+  int order = row[app_list_columns.order];
+  if (order <= 0)
+    return 0; // Row is being added, the columns are not yet set
+  std::size_t index = static_cast<std::size_t>(order);
+  if (index >= app_list_ranks_.size())
+    app_list_ranks_.resize(index + 1, UnknownRank);
+  if (app_list_ranks_[index] == UnknownRank)
   {
-    return true;
+    const string name_key = row[app_list_columns.name_key];
+    const string description_key = row[app_list_columns.description_key];
+    app_list_ranks_[index] = AppSearch::rank(name_key, description_key, app_list_query_);
   }
-  return false;
+  return app_list_ranks_[index];
 }
 
 /**
- * \brief Render name + description text
+ * \brief (Re)create the sorted model of the application list, so the rows are sorted on the latest search ranks
  */
-void MainWindow::treeview_set_cell_data_name_desc(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter)
+void MainWindow::create_app_list_sort_model()
 {
-  // cppcheck-suppress cstyleCast
-  Gtk::CellRendererText* text_renderer = (Gtk::CellRendererText*)renderer;
-  Glib::ustring name = "<b>" + (*iter)[app_list_columns.name] + "</b>\n";
-  name += (*iter)[app_list_columns.description];
-  text_renderer->property_markup().set_value(name);
+  app_list_sort = Gtk::TreeModelSort::create(app_list_filter);
+  app_list_sort->set_default_sort_func(sigc::mem_fun(*this, &MainWindow::app_list_sort_func));
+  application_list_treeview.set_model(app_list_sort);
 }
\ No newline at end of file
@@ -41,6 +41,8 @@ Menu::Menu() : file("_File", true), view("_View", true), machine("_Machine", tru
   // View submenu
   auto refresh_menuitem = create_image_menu_item("Refresh List", "view-refresh");
   refresh_menuitem->signal_activate().connect(refresh_view);
+  auto console_menuitem = create_image_menu_item("Console", "utilities-terminal");
+  console_menuitem->signal_activate().connect(show_console);
 
   // Machine submenu
   auto newitem_menuitem = create_image_menu_item("New", "list-add");
@@ -59,6 +61,8 @@ Menu::Menu() : file("_File", true), view("_View", true), machine("_Machine", tru
   open_drive_c_menuitem->signal_activate().connect(open_c_drive);
   auto open_log_file_menuitem = create_image_menu_item("Open Log file", "text-x-generic");
   open_log_file_menuitem->signal_activate().connect(open_log_file);
+  auto open_previous_log_file_menuitem = create_image_menu_item("Open Previous Log file", "text-x-generic");
+  open_previous_log_file_menuitem->signal_activate().connect(open_previous_log_file);
 
   // Help submenu
   auto feedback_menuitem = create_image_menu_item("Give feedback", "help-faq");
@@ -78,6 +82,7 @@ Menu::Menu() : file("_File", true), view("_View", true), machine("_Machine", tru
 
   // View menu
   view_submenu.append(*refresh_menuitem);
+  view_submenu.append(*console_menuitem);
 
   // Machine menu
   machine_submenu.append(*newitem_menuitem);
@@ -90,6 +95,7 @@ Menu::Menu() : file("_File", true), view("_View", true), machine("_Machine", tru
   machine_submenu.append(separator3);
   machine_submenu.append(*open_drive_c_menuitem);
   machine_submenu.append(*open_log_file_menuitem);
+  machine_submenu.append(*open_previous_log_file_menuitem);
 
   // Help menu
   help_submenu.append(*feedback_menuitem);
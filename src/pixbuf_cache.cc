@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    pixbuf_cache.cc
+ * \brief   Process-wide cache of decoded images (LRU, bounded by bytes)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "pixbuf_cache.h"
+#include "helper.h"
+#include <iostream>
+#include <sys/stat.h>
+
+//// Default limit of the decoded images (16 MiB, a 48x48 RGBA icon is about 9 KiB)
+static const std::size_t DefaultMaxBytes = 16 * 1024 * 1024;
+
+/// Meyers Singleton
+PixbufCache::PixbufCache() : max_bytes_(DefaultMaxBytes), bytes_(0), hits_(0), misses_(0), evictions_(0)
+{
+}
+/// Destructor
+PixbufCache::~PixbufCache() = default;
+
+/**
+ * \brief Get singleton instance
+ * \return PixbufCache reference (singleton)
+ */
+PixbufCache& PixbufCache::get_instance()
+{
+  static PixbufCache instance;
+  return instance;
+}
+
+/**
+ * \brief Get an image which is compiled into the binary (see Helper::get_image())
+ * \param[in] filename Name of image, relative to the images directory (eg. "apps/notepad.png")
+ * \param[in] size Scale the image to size x size pixels, -1 for the original size
+ * \return Image or empty pointer when the image couldn't be loaded
+ */
+Glib::RefPtr<Gdk::Pixbuf> PixbufCache::get_image(const string& filename, int size)
+{
+  return get({"image:" + filename, size}, -1, [&filename] { return Helper::get_image(filename); });
+}
+
+/**
+ * \brief Get an image file from disk (eg. an icon of a Wine desktop file)
+ * \param[in] file_path Image file path
+ * \param[in] size Scale the image to size x size pixels, -1 for the original size
+ * \return Image or empty pointer when the image couldn't be loaded
+ */
+Glib::RefPtr<Gdk::Pixbuf> PixbufCache::get_file(const string& file_path, int size)
+{
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0)
+  {
+    std::cerr << "Error: Could not find image file: " << file_path << std::endl;
+    return Glib::RefPtr<Gdk::Pixbuf>();
+  }
+  std::int64_t modified_ns = static_cast<std::int64_t>(file_stat.st_mtim.tv_sec) * 1000000000LL + file_stat.st_mtim.tv_nsec;
+  return get({"file:" + file_path, size}, modified_ns,
+             [&file_path]
+             {
+               try
+               {
+                 return Gdk::Pixbuf::create_from_file(file_path);
+               }
+               catch (const Glib::Error& error)
+               {
+                 std::cerr << "Error: Could not load image file: " << file_path << ", error: " << error.what() << std::endl;
+               }
+               return Glib::RefPtr<Gdk::Pixbuf>();
+             });
+}
+
+/**
+ * \brief Set the limit of the decoded images, the least recently used images are evicted when needed
+ * \param[in] max_bytes Limit in bytes
+ */
+void PixbufCache::set_max_bytes(std::size_t max_bytes)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_bytes_ = max_bytes;
+  evict();
+}
+
+/**
+ * \brief Get the cache counters
+ * \return Statistics
+ */
+PixbufCache::Statistics PixbufCache::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {hits_, misses_, evictions_, bytes_, entries_.size()};
+}
+
+/**
+ * \brief Print the cache counters
+ */
+void PixbufCache::print_statistics() const
+{
+  Statistics statistics = get_statistics();
+  std::cout << "INFO: Image cache: " << statistics.hits << " hits, " << statistics.misses << " misses, " << statistics.evictions << " evictions, "
+            << statistics.images << " images (" << (statistics.bytes / 1024) << " KiB)" << std::endl;
+}
+
+/**
+ * \brief Remove all the images from the cache (the counters are kept)
+ */
+void PixbufCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+/**
+ * \brief Lookup an image, the image is decoded (and scaled) on a miss
+ * \param[in] key Path and size
+ * \param[in] modified_ns Modification time of the file (-1 for images compiled into the binary)
+ * \param[in] load Decode the image (without the lock, so other threads are not blocked)
+ * \return Image or empty pointer when the image couldn't be loaded
+ */
+Glib::RefPtr<Gdk::Pixbuf> PixbufCache::get(const Key& key, std::int64_t modified_ns, const std::function<Glib::RefPtr<Gdk::Pixbuf>()>& load)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+      if (it->second->modified_ns == modified_ns)
+      {
+        hits_++;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->pixbuf;
+      }
+      // Outdated file
+      bytes_ -= it->second->bytes;
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    misses_++;
+  }
+
+  Glib::RefPtr<Gdk::Pixbuf> pixbuf = load();
+  if (!pixbuf)
+    return pixbuf; // Failures are not cached, the error is already reported
+  if (key.second > 0 && (pixbuf->get_width() != key.second || pixbuf->get_height() != key.second))
+    pixbuf = pixbuf->scale_simple(key.second, key.second, Gdk::INTERP_BILINEAR);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread could have decoded the same image in the meantime
+  if (index_.contains(key))
+    return pixbuf;
+  std::size_t bytes = static_cast<std::size_t>(pixbuf->get_rowstride()) * static_cast<std::size_t>(pixbuf->get_height());
+  entries_.push_front({key, pixbuf, modified_ns, bytes});
+  index_.emplace(key, entries_.begin());
+  bytes_ += bytes;
+  evict();
+  return pixbuf;
+}
+
+/**
+ * \brief Evict the least recently used images until the decoded images fit in the limit (mutex is locked).
+ * The most recently used image is always kept.
+ */
+void PixbufCache::evict()
+{
+  while (bytes_ > max_bytes_ && entries_.size() > 1)
+  {
+    const Entry& entry = entries_.back();
+    bytes_ -= entry.bytes;
+    index_.erase(entry.key);
+    entries_.pop_back();
+    evictions_++;
+  }
+}
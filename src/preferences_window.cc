@@ -29,10 +29,13 @@
 PreferencesWindow::PreferencesWindow(Gtk::Window& parent)
     : vbox(Gtk::ORIENTATION_VERTICAL, 4),
       hbox_buttons(Gtk::ORIENTATION_HORIZONTAL, 4),
+      hbox_log_compression(Gtk::ORIENTATION_HORIZONTAL, 6),
       header_preferences_label("Preferences"),
       default_folder_label("Machine folder location: "),
       display_default_wine_machine_label("Show default Wine machine: "),
       logging_stderr_label("Log standard error:"),
+      log_compression_label("Compress old log files:"),
+      log_compression_unit_label("% of the CPU cores (0 = no compression)"),
       display_default_wine_machine_check("Display default Wine prefix bottle (at: ~/.wine)"),
       enable_logging_stderr_check("Also log standard error (if logging is enabled)"),
       select_folder_button("Select folder..."),
@@ -65,6 +68,13 @@ PreferencesWindow::PreferencesWindow(Gtk::Window& parent)
   default_folder_label.set_halign(Gtk::Align::ALIGN_END);
   display_default_wine_machine_label.set_halign(Gtk::Align::ALIGN_END);
   logging_stderr_label.set_halign(Gtk::Align::ALIGN_END);
+  log_compression_label.set_halign(Gtk::Align::ALIGN_END);
+  log_compression_label.set_tooltip_text("Rotated log files (older than the current log file) are compressed in the background");
+  log_compression_cpu_share_spin.set_range(0, 100);
+  log_compression_cpu_share_spin.set_increments(5, 25);
+  log_compression_cpu_share_spin.set_digits(0);
+  hbox_log_compression.pack_start(log_compression_cpu_share_spin, false, false);
+  hbox_log_compression.pack_start(log_compression_unit_label, false, false);
   default_folder_entry.set_hexpand(true);
 
   settings_grid.attach(default_folder_label, 0, 0);
@@ -77,6 +87,8 @@ PreferencesWindow::PreferencesWindow(Gtk::Window& parent)
   settings_grid.attach(logging_label_heading, 0, 5, 3);
   settings_grid.attach(logging_stderr_label, 0, 6);
   settings_grid.attach(enable_logging_stderr_check, 1, 6, 2);
+  settings_grid.attach(log_compression_label, 0, 7);
+  settings_grid.attach(hbox_log_compression, 1, 7, 2);
 
   hbox_buttons.pack_end(save_button, false, false, 4);
   hbox_buttons.pack_end(cancel_button, false, false, 4);
@@ -110,6 +122,7 @@ void PreferencesWindow::show()
   default_folder_entry.set_text(general_config.default_folder);
   display_default_wine_machine_check.set_active(general_config.display_default_wine_machine);
   enable_logging_stderr_check.set_active(general_config.enable_logging_stderr);
+  log_compression_cpu_share_spin.set_value(general_config.log_compression_cpu_share);
   // Call parent show
   Gtk::Widget::show();
 }
@@ -174,6 +187,7 @@ void PreferencesWindow::on_save_button_clicked()
   general_config.default_folder = default_folder_entry.get_text();
   general_config.display_default_wine_machine = display_default_wine_machine_check.get_active();
   general_config.enable_logging_stderr = enable_logging_stderr_check.get_active();
+  general_config.log_compression_cpu_share = log_compression_cpu_share_spin.get_value_as_int();
   if (!GeneralConfigFile::write_config_file(general_config))
   {
     Gtk::MessageDialog dialog(*this, "Error occurred during saving generic config file.", false, Gtk::MESSAGE_ERROR, Gtk::BUTTONS_OK);
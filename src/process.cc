@@ -0,0 +1,241 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    process.cc
+ * \brief   Start programs without a shell (posix_spawn), using an argument vector
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "process.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+//// Output is read in chunks of this size, the captured output grows by (at least) this size
+static const std::size_t ReadChunkSize = 64 * 1024;
+
+/**
+ * \brief Run a program and capture its output (blocking, run this method async)
+ * \param[in] argv Program followed by its arguments, eg. {"wine", "--version"}
+ * \param[in] options Working directory, environment variables & stderr capturing
+ * \throws runtime_error when the output pipe could not be created
+ * \return Exit code and output
+ */
+ProcessResult Process::run(const vector<string>& argv, const ProcessOptions& options)
+{
+  ProcessResult result{ExitCodeNotStarted, ""};
+  int output_fd = -1;
+  pid_t pid = start(argv, options, output_fd, result.output);
+  if (pid < 0)
+    return result;
+
+  // Read directly into the output string, which grows in large chunks
+  std::size_t length = 0;
+  result.output.resize(ReadChunkSize);
+  while (true)
+  {
+    if (result.output.size() - length < ReadChunkSize / 2)
+      result.output.resize(result.output.size() * 2);
+    ssize_t count = read(output_fd, result.output.data() + length, result.output.size() - length);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      break;
+    length += static_cast<std::size_t>(count);
+  }
+  result.output.resize(length);
+  close(output_fd);
+  result.exit_code = wait(pid);
+  return result;
+}
+
+/**
+ * \brief Run a program and stream its output to a callback (blocking, run this method async)
+ * \param[in] argv Program followed by its arguments
+ * \param[in] options Working directory, environment variables & stderr capturing
+ * \param[in] on_output Called (in the calling thread) for every chunk of output, chunks are not aligned to lines
+ * \throws runtime_error when the output pipe could not be created
+ * \return Exit code
+ */
+int Process::run(const vector<string>& argv, const ProcessOptions& options, const OutputCallback& on_output)
+{
+  string error_message;
+  int output_fd = -1;
+  pid_t pid = start(argv, options, output_fd, error_message);
+  if (pid < 0)
+  {
+    on_output(error_message);
+    return ExitCodeNotStarted;
+  }
+
+  string buffer(ReadChunkSize, '\0');
+  while (true)
+  {
+    ssize_t count = read(output_fd, buffer.data(), buffer.size());
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      break;
+    on_output(std::string_view(buffer.data(), static_cast<std::size_t>(count)));
+  }
+  close(output_fd);
+  return wait(pid);
+}
+
+/**
+ * \brief Readable command-line, only used for logging & error messages (never executed)
+ * \param[in] argv Program followed by its arguments
+ * \param[in] env_vars Environment variables, shown in front of the program
+ * \return Command-line, arguments with spaces or quotes are quoted
+ */
+string Process::to_display_string(const vector<string>& argv, const vector<pair<string, string>>& env_vars)
+{
+  auto quote = [](const string& text)
+  {
+    if (!text.empty() && text.find_first_of(" \t\n\"'\\$`") == string::npos)
+      return text;
+    string quoted = "\"";
+    for (char c : text)
+    {
+      if (c == '"' || c == '\\' || c == '$' || c == '`')
+        quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  };
+  string command;
+  for (const auto& [key, value] : env_vars)
+    command += key + "=" + quote(value) + " ";
+  for (const string& argument : argv)
+    command += quote(argument) + " ";
+  if (!command.empty())
+    command.pop_back();
+  return command;
+}
+
+/**
+ * \brief Start the process, stdout (and stderr when merged) is connected to a pipe.
+ * The caller reads the pipe, closes it and reaps the process (see ProcessSupervisor).
+ * \param[in] argv Program followed by its arguments
+ * \param[in] options Working directory, environment variables & stderr capturing
+ * \param[out] output_fd Read end of the output pipe (only when started)
+ * \param[out] error_message Reason when the program could not be started
+ * \throws runtime_error when the output pipe could not be created
+ * \return Process ID or -1 when the program could not be started
+ */
+pid_t Process::start(const vector<string>& argv, const ProcessOptions& options, int& output_fd, string& error_message)
+{
+  if (argv.empty() || argv.front().empty())
+  {
+    error_message = "No program to run\n";
+    return -1;
+  }
+
+  // Close-on-exec, so processes started by other threads at the same time don't inherit the pipe
+  int pipe_fds[2];
+  if (pipe2(pipe_fds, O_CLOEXEC) != 0)
+    throw std::runtime_error("pipe() failed!");
+
+  vector<char*> arguments;
+  arguments.reserve(argv.size() + 1);
+  for (const string& argument : argv)
+    arguments.push_back(const_cast<char*>(argument.c_str()));
+  arguments.push_back(nullptr);
+
+  // Environment: the current environment, with the extra variables added or replaced
+  vector<string> environment;
+  vector<char*> environment_pointers;
+  char** envp = environ;
+  if (!options.env_vars.empty())
+  {
+    for (char** variable = environ; *variable != nullptr; variable++)
+    {
+      std::string_view entry(*variable);
+      std::string_view key = entry.substr(0, entry.find('='));
+      bool is_replaced = false;
+      for (const auto& [env_key, _] : options.env_vars)
+        is_replaced = is_replaced || key == env_key;
+      if (!is_replaced)
+        environment.emplace_back(entry);
+    }
+    for (const auto& [key, value] : options.env_vars)
+      environment.push_back(key + "=" + value);
+    environment_pointers.reserve(environment.size() + 1);
+    for (string& variable : environment)
+      environment_pointers.push_back(variable.data());
+    environment_pointers.push_back(nullptr);
+    envp = environment_pointers.data();
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+  if (options.merge_stderr)
+    posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDERR_FILENO);
+  if (!options.working_directory.empty())
+    posix_spawn_file_actions_addchdir_np(&actions, options.working_directory.c_str());
+
+  pid_t pid = -1;
+  int error = posix_spawnp(&pid, arguments.front(), &actions, nullptr, arguments.data(), envp);
+  posix_spawn_file_actions_destroy(&actions);
+  close(pipe_fds[1]);
+  if (error != 0)
+  {
+    close(pipe_fds[0]);
+    error_message = argv.front() + ": " + std::strerror(error);
+    if (!options.working_directory.empty())
+      error_message += " (working directory: " + options.working_directory + ")";
+    error_message += "\n";
+    return -1;
+  }
+  output_fd = pipe_fds[0];
+  return pid;
+}
+
+/**
+ * \brief Exit code of a finished process
+ * \param[in] wait_status Status returned by waitpid()
+ * \return Exit code, or 128 + signal number when the process was killed
+ */
+int Process::exit_code(int wait_status)
+{
+  if (WIFEXITED(wait_status))
+    return WEXITSTATUS(wait_status);
+  if (WIFSIGNALED(wait_status))
+    return 128 + WTERMSIG(wait_status);
+  return -1;
+}
+
+/**
+ * \brief Wait until the process is finished
+ * \param[in] pid Process ID
+ * \return Exit code, or 128 + signal number when the process was killed
+ */
+int Process::wait(pid_t pid)
+{
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0)
+  {
+    if (errno != EINTR)
+      return -1;
+  }
+  return exit_code(status);
+}
@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    process_supervisor.cc
+ * \brief   Runs the programs & installs of all bottles from a single I/O thread (GLib main loop)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "process_supervisor.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <glib-unix.h>
+#include <stdexcept>
+#include <unistd.h>
+
+//// Output is read in chunks of this size
+static const std::size_t ReadChunkSize = 64 * 1024;
+//// Maximum number of chunks read from one pipe at once, so a very chatty program doesn't starve the other jobs
+static const int MaxChunksPerRead = 4;
+
+/**
+ * \brief Constructor, starts the I/O thread
+ */
+ProcessSupervisor::ProcessSupervisor()
+    : context_(g_main_context_new()), loop_(g_main_loop_new(context_, FALSE)), next_job_id_(1), read_buffer_(ReadChunkSize)
+{
+  thread_ = std::thread(
+      [this]
+      {
+        g_main_context_push_thread_default(context_);
+        g_main_loop_run(loop_);
+        g_main_context_pop_thread_default(context_);
+      });
+}
+
+/**
+ * \brief Destructor, stops the I/O thread. Running programs are not stopped, their output is no longer read.
+ */
+ProcessSupervisor::~ProcessSupervisor()
+{
+  // Quit from within the loop, a quit before the loop is running would be lost
+  g_main_context_invoke(
+      context_,
+      [](gpointer loop) -> gboolean
+      {
+        g_main_loop_quit(static_cast<GMainLoop*>(loop));
+        return G_SOURCE_REMOVE;
+      },
+      loop_);
+  if (thread_.joinable())
+    thread_.join();
+
+  for (auto& [id, job] : jobs_)
+  {
+    close_output(*job);
+    if (job->child_source != nullptr)
+    {
+      g_source_destroy(job->child_source);
+      g_source_unref(job->child_source);
+    }
+  }
+  jobs_.clear();
+  g_main_loop_unref(loop_);
+  // Also deletes the jobs of the start requests that are not yet handled
+  g_main_context_unref(context_);
+}
+
+/**
+ * \brief Start a job (thread-safe), the commands of the job are started one after the other in the I/O thread
+ * \param[in] name Job name
+ * \param[in] commands Commands to run, the next command starts when the previous command is exited and its output is read
+ * \param[in] on_output Called for every output chunk of the commands (in the I/O thread)
+ * \param[in] on_exit Called when the last command is finished (in the I/O thread), with the first non-zero exit code of the commands
+ * that give an error (or 127 when a program could not be started), otherwise 0
+ * \return Job ID
+ */
+std::uint64_t ProcessSupervisor::start(const string& name, vector<JobCommand> commands, OutputCallback on_output, ExitCallback on_exit)
+{
+  auto job = std::make_unique<Job>(Job{this, 0, name, std::move(commands), std::move(on_output), std::move(on_exit)});
+  job->start_time = g_get_monotonic_time();
+  {
+    std::lock_guard<std::mutex> lock(running_jobs_mutex_);
+    job->id = next_job_id_++;
+    running_jobs_[job->id] = JobInfo{job->id, name, -1, job->start_time, 0};
+  }
+  std::uint64_t id = job->id;
+
+  // The request (and job) is deleted without starting, when the I/O thread is already stopped
+  auto request = new StartRequest{this, std::move(job)};
+  g_main_context_invoke_full(
+      context_, G_PRIORITY_DEFAULT,
+      [](gpointer user_data) -> gboolean
+      {
+        auto* request = static_cast<StartRequest*>(user_data);
+        Job& job = *request->job;
+        request->supervisor->jobs_[job.id] = std::move(request->job);
+        request->supervisor->start_command(job);
+        return G_SOURCE_REMOVE;
+      },
+      request, [](gpointer user_data) { delete static_cast<StartRequest*>(user_data); });
+  return id;
+}
+
+/**
+ * \brief Get the jobs that are not finished yet (thread-safe)
+ * \return Running jobs, in start order
+ */
+vector<JobInfo> ProcessSupervisor::get_running_jobs() const
+{
+  std::lock_guard<std::mutex> lock(running_jobs_mutex_);
+  vector<JobInfo> jobs;
+  jobs.reserve(running_jobs_.size());
+  for (const auto& [id, info] : running_jobs_)
+    jobs.push_back(info);
+  return jobs;
+}
+
+/**
+ * \brief Start the current command of the job (I/O thread), the job is finished when there are no commands left.
+ * Note: the job is deleted when it's finished.
+ */
+void ProcessSupervisor::start_command(Job& job)
+{
+  while (job.command < job.commands.size())
+  {
+    const JobCommand& command = job.commands.at(job.command);
+    string error_message;
+    int output_fd = -1;
+    pid_t pid = -1;
+    try
+    {
+      pid = Process::start(command.argv, command.options, output_fd, error_message);
+    }
+    catch (const std::runtime_error& error)
+    {
+      error_message = string(error.what()) + "\n";
+    }
+    if (pid >= 0)
+    {
+      job.pid = pid;
+      job.output_fd = output_fd;
+      job.is_exited = false;
+      fcntl(output_fd, F_SETFL, fcntl(output_fd, F_GETFL) | O_NONBLOCK);
+      job.output_source = g_unix_fd_source_new(output_fd, static_cast<GIOCondition>(G_IO_IN | G_IO_HUP | G_IO_ERR));
+      g_source_set_callback(job.output_source, reinterpret_cast<GSourceFunc>(reinterpret_cast<void (*)()>(&ProcessSupervisor::on_output_ready)),
+                            &job, nullptr);
+      g_source_attach(job.output_source, context_);
+      job.child_source = g_child_watch_source_new(pid);
+      g_source_set_callback(job.child_source, reinterpret_cast<GSourceFunc>(reinterpret_cast<void (*)()>(&ProcessSupervisor::on_child_exited)),
+                            &job, nullptr);
+      g_source_attach(job.child_source, context_);
+      update_running_job(job);
+      return;
+    }
+    // Could not be started, continue with the next command
+    job.on_output(job.id, error_message);
+    if (command.give_error && job.exit_code == 0)
+      job.exit_code = Process::ExitCodeNotStarted;
+    job.command++;
+  }
+
+  // All commands are finished
+  std::uint64_t id = job.id;
+  int exit_code = job.exit_code;
+  ExitCallback on_exit = std::move(job.on_exit);
+  {
+    std::lock_guard<std::mutex> lock(running_jobs_mutex_);
+    running_jobs_.erase(id);
+  }
+  jobs_.erase(id);
+  if (on_exit)
+    on_exit(id, exit_code);
+}
+
+/**
+ * \brief The current command is exited and its output is read (I/O thread), start the next command
+ */
+void ProcessSupervisor::finish_command(Job& job)
+{
+  if (job.commands.at(job.command).give_error && job.command_exit_code != 0 && job.exit_code == 0)
+    job.exit_code = job.command_exit_code;
+  job.pid = -1;
+  job.command++;
+  start_command(job);
+}
+
+/**
+ * \brief Stop reading the output of the current command and close the pipe
+ */
+void ProcessSupervisor::close_output(Job& job)
+{
+  if (job.output_source != nullptr)
+  {
+    g_source_destroy(job.output_source);
+    g_source_unref(job.output_source);
+    job.output_source = nullptr;
+  }
+  if (job.output_fd >= 0)
+  {
+    close(job.output_fd);
+    job.output_fd = -1;
+  }
+}
+
+/**
+ * \brief Copy the process ID & command index to the running jobs
+ */
+void ProcessSupervisor::update_running_job(const Job& job)
+{
+  std::lock_guard<std::mutex> lock(running_jobs_mutex_);
+  auto it = running_jobs_.find(job.id);
+  if (it != running_jobs_.end())
+  {
+    it->second.pid = job.pid;
+    it->second.command = job.command;
+  }
+}
+
+/**
+ * \brief Output pipe is readable or closed (I/O thread)
+ */
+gboolean ProcessSupervisor::on_output_ready(gint fd, GIOCondition /* condition */, gpointer user_data)
+{
+  Job& job = *static_cast<Job*>(user_data);
+  ProcessSupervisor& supervisor = *job.supervisor;
+  for (int i = 0; i < MaxChunksPerRead; i++)
+  {
+    ssize_t count = read(fd, supervisor.read_buffer_.data(), supervisor.read_buffer_.size());
+    if (count > 0)
+    {
+      job.on_output(job.id, std::string_view(supervisor.read_buffer_.data(), static_cast<std::size_t>(count)));
+      continue;
+    }
+    if (count < 0 && (errno == EAGAIN || errno == EINTR))
+      return G_SOURCE_CONTINUE;
+    // End of file (all writers closed the pipe) or read error
+    supervisor.close_output(job);
+    if (job.is_exited)
+      supervisor.finish_command(job);
+    return G_SOURCE_REMOVE;
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+/**
+ * \brief Process of the current command is exited (I/O thread), the process is already reaped
+ */
+void ProcessSupervisor::on_child_exited(GPid pid, gint wait_status, gpointer user_data)
+{
+  Job& job = *static_cast<Job*>(user_data);
+  g_spawn_close_pid(pid);
+  // The source is destroyed after this callback
+  g_source_unref(job.child_source);
+  job.child_source = nullptr;
+  job.is_exited = true;
+  job.command_exit_code = Process::exit_code(wait_status);
+  // Wait until the output is read as well (a child process of the program can keep the pipe open)
+  if (job.output_fd < 0)
+    job.supervisor->finish_command(job);
+}
@@ -0,0 +1,296 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_hive.cc
+ * \brief   Memory-mapped and indexed Wine registry file (read-only)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "registry_hive.h"
+#include "file_cache.h"
+#include "registry_tokenizer.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//// Maximum number of registry files kept in the cache (least recently used hive is dropped first)
+static const std::size_t MaxCachedHives = 32;
+
+//// Registry hives, the file is only mapped and indexed again when it changed on disk
+static FileCache<RegistryHive> hive_cache(MaxCachedHives);
+
+/// Private constructor, use open()
+RegistryHive::RegistryHive(const string& file_path, const char* data, std::size_t size) : file_path_(file_path), data_(data), size_(size)
+{
+}
+
+/// Destructor, unmaps the registry file
+RegistryHive::~RegistryHive()
+{
+  if (data_ != nullptr)
+  {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+/**
+ * \brief Get the (cached) registry hive of a registry file. The file is only mapped and indexed again
+ * when it changed on disk since the previous call.
+ * \param[in] file_path File path of registry
+ * \return Shared registry hive or nullptr when the file could not be opened
+ */
+std::shared_ptr<const RegistryHive> RegistryHive::open(const string& file_path)
+{
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0)
+    return nullptr;
+
+  if (auto hive = hive_cache.get(file_path, file_stat))
+    return hive;
+
+  int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+  // Use the status of the opened file, the path could be replaced in the meantime
+  if (fstat(fd, &file_stat) != 0)
+  {
+    close(fd);
+    return nullptr;
+  }
+  const char* data = nullptr;
+  std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+  if (size > 0)
+  {
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+    {
+      close(fd);
+      return nullptr;
+    }
+    posix_madvise(address, size, POSIX_MADV_SEQUENTIAL);
+    data = static_cast<const char*>(address);
+  }
+  close(fd);
+
+  std::shared_ptr<RegistryHive> hive(new RegistryHive(file_path, data, size));
+  hive->build_index();
+
+  hive_cache.insert(file_path, file_stat, hive);
+  return hive;
+}
+
+/**
+ * \brief Drop a registry file from the cache, forcing a reload during the next open()
+ * \param[in] file_path File path of registry
+ */
+void RegistryHive::invalidate(const string& file_path)
+{
+  hive_cache.erase(file_path);
+}
+
+/**
+ * \brief File path of the registry file
+ * \return File path
+ */
+const string& RegistryHive::get_file_path() const
+{
+  return file_path_;
+}
+
+/**
+ * \brief Check if the key is present in the registry
+ * \param[in] key_name Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \return True if found
+ */
+bool RegistryHive::has_key(std::string_view key_name) const
+{
+  return find_section(key_name) != nullptr;
+}
+
+/**
+ * \brief Get a specific value of a key
+ * \param[in] key_name   Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Specifies the registry value name (eg. Desktop)
+ * \return Data of value name (without quotes and unescaped) or empty string when not found
+ */
+string RegistryHive::get_value(std::string_view key_name, std::string_view value_name) const
+{
+  return std::move(get_values(key_name, {value_name}).front());
+}
+
+/**
+ * \brief Get multiple values of the same key, the key section is only scanned once
+ * \param[in] key_name    Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_names Registry value names (eg. Desktop)
+ * \return Data of each value name (without quotes and unescaped), in the same order as value_names. Empty string for values that are not found.
+ */
+std::vector<string> RegistryHive::get_values(std::string_view key_name, const std::vector<std::string_view>& value_names) const
+{
+  std::vector<string> output(value_names.size());
+  const Section* section = find_section(key_name);
+  if (section == nullptr)
+    return output;
+
+  std::vector<bool> found(value_names.size(), false);
+  std::size_t remaining_values = value_names.size();
+  RegistryTokenizer tokenizer(section->body);
+  RegistryValue value;
+  while (remaining_values > 0 && tokenizer.next_value(value))
+  {
+    for (std::size_t i = 0; i < value_names.size(); i++)
+    {
+      if (!found[i] && value.name == value_names[i])
+      {
+        // ASCII fast path: data without any escapes can be copied as-is
+        if (value.is_escaped)
+          RegistryTokenizer::unescape(value.data, output[i]);
+        else
+          output[i].assign(value.data);
+        found[i] = true;
+        remaining_values--;
+      }
+    }
+  }
+  return output;
+}
+
+/**
+ * \brief Get all the lines of a key (that is everything below the key name until the next empty line)
+ * \param[in] key_name Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \return Lines (raw and still escaped), can be tokenized using RegistryTokenizer. Empty when the key is not found.
+ * Only valid as long as the hive is alive.
+ */
+std::string_view RegistryHive::get_key_body(std::string_view key_name) const
+{
+  const Section* section = find_section(key_name);
+  return (section != nullptr) ? section->body : std::string_view();
+}
+
+/**
+ * \brief Get a meta value from the registry file header
+ * \param[in] meta_value_name Specifies the registry value name (eg. arch)
+ * \return Data of value name (without quotes) or empty string when not found
+ */
+string RegistryHive::get_meta_data(std::string_view meta_value_name) const
+{
+  string output;
+  string meta_pattern;
+  meta_pattern.reserve(meta_value_name.size() + 2);
+  meta_pattern.append(1, '#').append(meta_value_name).append(1, '=');
+  for (std::string_view line : meta_lines_)
+  {
+    if (line.starts_with(meta_pattern))
+    {
+      line.remove_prefix(meta_pattern.size());
+      // Remove quotes
+      std::copy_if(line.begin(), line.end(), std::back_inserter(output), [](char c) { return c != '"'; });
+      break;
+    }
+  }
+  return output;
+}
+
+/**
+ * \brief Build the key index in a single pass over the mapped file.
+ * Sections are skipped as a whole by searching for the empty line that ends them.
+ */
+void RegistryHive::build_index()
+{
+  RegistryTokenizer tokenizer(std::string_view(data_ != nullptr ? data_ : "", size_));
+  // Header lines (eg. WINE REGISTRY Version 2 and #arch=win64) until the first key
+  std::string_view line;
+  while (!tokenizer.remaining().empty() && tokenizer.remaining().front() != '[' && tokenizer.next_line(line))
+  {
+    if (line.starts_with('#'))
+      meta_lines_.emplace_back(line);
+  }
+
+  sections_.reserve(size_ / 128);
+  std::string_view name, body;
+  while (tokenizer.next_key(name, body))
+  {
+    sections_.push_back({name, body});
+  }
+
+  // Hash table size is a power of two, with a load factor of at most 50%
+  std::size_t table_size = 16;
+  while (table_size < sections_.size() * 2)
+    table_size *= 2;
+  index_.assign(table_size, 0);
+  for (std::size_t i = 0; i < sections_.size(); i++)
+  {
+    std::uint32_t& slot = index_[find_slot(sections_[i].name)];
+    // Only the first occurrence of a key is used, like a sequential search would do
+    if (slot == 0)
+      slot = static_cast<std::uint32_t>(i + 1);
+  }
+}
+
+/**
+ * \brief Find the hash table slot of a key name (linear probing)
+ * \param[in] key_name Full key name including brackets
+ * \return Slot that contains the key, or the empty slot where the key should be inserted
+ */
+std::size_t RegistryHive::find_slot(std::string_view key_name) const
+{
+  std::size_t mask = index_.size() - 1;
+  std::size_t slot = std::hash<std::string_view>{}(key_name) & mask;
+  while (index_[slot] != 0 && sections_[index_[slot] - 1].name != key_name)
+    slot = (slot + 1) & mask;
+  return slot;
+}
+
+/**
+ * \brief Find the section of a key. A full key name (ending with ']') is looked-up directly, otherwise the
+ * key name is treated as prefix and the first matching key (in file order) is returned.
+ * \param[in] key_name Full or part of the path of the key, always starting with '['
+ * \return Section or nullptr when not found
+ */
+const RegistryHive::Section* RegistryHive::find_section(std::string_view key_name) const
+{
+  if (key_name.ends_with(']'))
+  {
+    std::uint32_t section_index = index_[find_slot(key_name)];
+    return (section_index != 0) ? &sections_[section_index - 1] : nullptr;
+  }
+
+  std::call_once(sorted_index_once_,
+                 [this]()
+                 {
+                   sorted_index_.resize(sections_.size());
+                   for (std::size_t i = 0; i < sorted_index_.size(); i++)
+                     sorted_index_[i] = i;
+                   std::stable_sort(sorted_index_.begin(), sorted_index_.end(),
+                                    [this](std::size_t a, std::size_t b) { return sections_[a].name < sections_[b].name; });
+                 });
+  auto it = std::lower_bound(sorted_index_.begin(), sorted_index_.end(), key_name,
+                             [this](std::size_t index, std::string_view key) { return sections_[index].name < key; });
+  const Section* found = nullptr;
+  std::size_t found_index = sections_.size();
+  for (; it != sorted_index_.end() && sections_[*it].name.starts_with(key_name); ++it)
+  {
+    if (*it < found_index)
+    {
+      found_index = *it;
+      found = &sections_[*it];
+    }
+  }
+  return found;
+}
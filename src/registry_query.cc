@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_query.cc
+ * \brief   Batched look-up of multiple Wine registry values
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "registry_query.h"
+#include "registry_hive.h"
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Request a value of a key
+ * \param[in] file_path  File path of registry
+ * \param[in] key_name   Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Specifies the registry value name (eg. Desktop)
+ */
+void RegistryQuery::add_value(const string& file_path, const string& key_name, const string& value_name)
+{
+  requests_.try_emplace(std::make_tuple(file_path, key_name, value_name));
+}
+
+/**
+ * \brief Request a meta value from the registry file header
+ * \param[in] file_path       File path of registry
+ * \param[in] meta_value_name Specifies the registry value name (eg. arch)
+ */
+void RegistryQuery::add_meta_data(const string& file_path, const string& meta_value_name)
+{
+  requests_.try_emplace(std::make_tuple(file_path, "", meta_value_name));
+}
+
+/**
+ * \brief Execute all the requests, can be called again to refresh the results
+ */
+void RegistryQuery::execute()
+{
+  auto it = requests_.begin();
+  while (it != requests_.end())
+  {
+    const string& file_path = std::get<0>(it->first);
+    auto hive = RegistryHive::open(file_path);
+    // All requests of the same registry file are next to each other (sorted map)
+    while (it != requests_.end() && std::get<0>(it->first) == file_path)
+    {
+      const string& key_name = std::get<1>(it->first);
+      auto group_end = it;
+      std::vector<std::string_view> value_names;
+      for (; group_end != requests_.end() && std::get<0>(group_end->first) == file_path && std::get<1>(group_end->first) == key_name; ++group_end)
+      {
+        value_names.emplace_back(std::get<2>(group_end->first));
+      }
+
+      std::vector<string> values(value_names.size());
+      if (hive && key_name.empty())
+      {
+        for (std::size_t i = 0; i < value_names.size(); i++)
+          values[i] = hive->get_meta_data(value_names[i]);
+      }
+      else if (hive)
+      {
+        values = hive->get_values(key_name, value_names);
+      }
+      for (std::size_t i = 0; it != group_end; ++it, i++)
+      {
+        it->second.data = std::move(values[i]);
+        it->second.loaded = (hive != nullptr);
+      }
+    }
+  }
+}
+
+/**
+ * \brief Get the result of a value request
+ * \param[in] file_path  File path of registry
+ * \param[in] key_name   Key name, like used in add_value()
+ * \param[in] value_name Registry value name
+ * \throws runtime_error when we couldn't load the Windows registry
+ * \return Data of value name (or empty string if not found)
+ */
+const string& RegistryQuery::get_value(const string& file_path, const string& key_name, const string& value_name) const
+{
+  return get_result(file_path, key_name, value_name);
+}
+
+/**
+ * \brief Get the result of a meta value request
+ * \param[in] file_path       File path of registry
+ * \param[in] meta_value_name Meta value name (eg. arch)
+ * \throws runtime_error when we couldn't load the Windows registry
+ * \return Data of meta value (or empty string if not found)
+ */
+const string& RegistryQuery::get_meta_data(const string& file_path, const string& meta_value_name) const
+{
+  return get_result(file_path, "", meta_value_name);
+}
+
+/**
+ * \brief Look-up of a request result
+ * \throws runtime_error when we couldn't load the Windows registry or the value was never requested
+ * \return Data of value name
+ */
+const string& RegistryQuery::get_result(const string& file_path, const string& key_name, const string& value_name) const
+{
+  auto it = requests_.find(std::make_tuple(file_path, key_name, value_name));
+  if (it == requests_.end())
+  {
+    std::cerr << "Error: Registry value is not part of the query. File: " << file_path << " (using key: " << key_name
+              << " and value: " << value_name << ")" << std::endl;
+    throw std::runtime_error("Registry value was not requested!");
+  }
+  if (!it->second.loaded)
+  {
+    std::cerr << "Error: Couldn't open registry file during query. Trying to read from file: " << file_path << "(using key: " << key_name
+              << " and value: " << value_name << ")" << std::endl;
+    throw std::runtime_error("Could not open registry file!");
+  }
+  return it->second.data;
+}
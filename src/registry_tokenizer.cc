@@ -0,0 +1,352 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_tokenizer.cc
+ * \brief   Zero-allocation tokenizer for Wine registry files
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "registry_tokenizer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+/**
+ * \brief Find a character in a view
+ * \return Index of the character or std::string_view::npos
+ */
+static std::size_t find_char(std::string_view view, std::size_t offset, char ch)
+{
+  if (offset >= view.size())
+    return std::string_view::npos;
+  const void* found = std::memchr(view.data() + offset, ch, view.size() - offset);
+  return found ? static_cast<std::size_t>(static_cast<const char*>(found) - view.data()) : std::string_view::npos;
+}
+
+/**
+ * \brief Find a (short) string in a view
+ * \return Index of the string or std::string_view::npos
+ */
+static std::size_t find_string(std::string_view view, std::string_view needle)
+{
+  const void* found = memmem(view.data(), view.size(), needle.data(), needle.size());
+  return found ? static_cast<std::size_t>(static_cast<const char*>(found) - view.data()) : std::string_view::npos;
+}
+
+/**
+ * \brief Tokenizer constructor
+ * \param[in] buffer Registry file content (or the body of a single key), needs to outlive the tokenizer
+ */
+RegistryTokenizer::RegistryTokenizer(std::string_view buffer) : remaining_(buffer)
+{
+}
+
+/**
+ * \brief Get the next line (without the newline character)
+ * \param[out] line Line
+ * \return False when the end of the buffer is reached
+ */
+bool RegistryTokenizer::next_line(std::string_view& line)
+{
+  if (remaining_.empty())
+    return false;
+  std::size_t length = find_char(remaining_, 0, '\n');
+  if (length == std::string_view::npos)
+    length = remaining_.size();
+  line = remaining_.substr(0, length);
+  remaining_.remove_prefix(std::min(length + 1, remaining_.size()));
+  return true;
+}
+
+/**
+ * \brief Jump to the next key of the registry, and return the key name and all the lines of the key.
+ * The key section ends with an empty line.
+ * \param[out] key_name Key name including brackets, without the timestamp (eg. [Software\\\\Wine\\\\Drivers])
+ * \param[out] key_body All the lines below the key name (eg. #time=1da.. and "Audio"="pulse")
+ * \return False when there are no keys left
+ */
+bool RegistryTokenizer::next_key(std::string_view& key_name, std::string_view& key_body)
+{
+  // Skip to the next line that starts with '['
+  while (!remaining_.empty() && remaining_.front() != '[')
+  {
+    std::size_t found = find_string(remaining_, "\n[");
+    if (found == std::string_view::npos)
+    {
+      remaining_ = {};
+      return false;
+    }
+    remaining_.remove_prefix(found + 1);
+  }
+  std::string_view line;
+  if (!next_line(line))
+    return false;
+
+  // Key name line, eg. [Software\\Wine\\Drivers] 1700000000
+  std::size_t name_end = line.rfind(']');
+  key_name = (name_end != std::string_view::npos) ? line.substr(0, name_end + 1) : line;
+
+  key_body = {};
+  if (!remaining_.empty() && remaining_.front() != '\n')
+  {
+    std::size_t length = find_string(remaining_, "\n\n");
+    if (length == std::string_view::npos)
+    {
+      key_body = remaining_;
+      if (key_body.ends_with('\n'))
+        key_body.remove_suffix(1);
+      remaining_ = {};
+    }
+    else
+    {
+      key_body = remaining_.substr(0, length);
+      remaining_.remove_prefix(length + 2);
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Get the next value, lines that are not a value (like #time=.. meta data) are skipped
+ * \param[out] value Registry value
+ * \return False when there are no values left
+ */
+bool RegistryTokenizer::next_value(RegistryValue& value)
+{
+  std::string_view line;
+  while (next_line(line))
+  {
+    if (parse_value(line, value))
+      return true;
+  }
+  return false;
+}
+
+/**
+ * \brief The part of the buffer that isn't tokenized yet
+ * \return Remaining buffer
+ */
+std::string_view RegistryTokenizer::remaining() const
+{
+  return remaining_;
+}
+
+/**
+ * \brief Parse a single value line, eg. "Audio"="pulse", "Version"=dword:00000001 or @="Default"
+ * \param[in] line Registry line
+ * \param[out] value Registry value (only valid if true is returned)
+ * \return True if the line is a value line
+ */
+bool RegistryTokenizer::parse_value(std::string_view line, RegistryValue& value)
+{
+  std::size_t name_end;
+  if (line.starts_with('@'))
+  {
+    value.name = {};
+    name_end = 0;
+  }
+  else if (line.starts_with('"'))
+  {
+    // Search for the closing quote, skipping escaped quotes (preceded by an odd number of backslashes)
+    name_end = find_char(line, 1, '"');
+    while (name_end != std::string_view::npos)
+    {
+      std::size_t backslashes = 0;
+      while (name_end > backslashes + 1 && line[name_end - backslashes - 1] == '\\')
+        backslashes++;
+      if (backslashes % 2 == 0)
+        break;
+      name_end = find_char(line, name_end + 1, '"');
+    }
+    if (name_end == std::string_view::npos)
+      return false;
+    value.name = line.substr(1, name_end - 1);
+  }
+  else
+  {
+    return false;
+  }
+
+  if (name_end + 1 >= line.size() || line[name_end + 1] != '=')
+    return false;
+  value.data = line.substr(name_end + 2);
+  value.is_string = value.data.size() >= 2 && value.data.front() == '"' && value.data.back() == '"';
+  if (value.is_string)
+  {
+    value.data = value.data.substr(1, value.data.size() - 2);
+  }
+  value.is_escaped = find_char(value.name, 0, '\\') != std::string_view::npos || find_char(value.data, 0, '\\') != std::string_view::npos;
+  return true;
+}
+
+/**
+ * \brief Parse an escaped Wine registry key data back into an UTF-8 string
+ * \param[in] src Key data to be unescaped
+ * \return UTF-8 string
+ */
+string RegistryTokenizer::unescape(std::string_view src)
+{
+  string dest;
+  unescape(src, dest);
+  return dest;
+}
+
+/**
+ * \brief Parse an escaped Wine registry key data back into an UTF-8 string.
+ * The code is adopted from the parse_strW() method:
+ * https://source.winehq.org/git/wine.git/blob/refs/heads/master:/server/unicode.c#l101
+ *
+ * \param[in] src Key data to be unescaped
+ * \param[in,out] dest The UTF-8 string is appended to dest (allows reusing the same buffer)
+ */
+void RegistryTokenizer::unescape(std::string_view src, string& dest)
+{
+  auto to_hex = [](char ch) -> char { return std::isdigit(ch) ? ch - '0' : std::tolower(ch) - 'a' + 10; };
+
+  auto append_utf8 = [&dest](wchar_t wc)
+  {
+    if (0 <= wc && wc <= 0x7f)
+    {
+      dest += (char)wc;
+    }
+    else if (0x80 <= wc && wc <= 0x7ff)
+    {
+      dest += (0xc0 | (wc >> 6));
+      dest += (0x80 | (wc & 0x3f));
+    }
+    else if (0x800 <= wc && wc <= 0xffff)
+    {
+      dest += (0xe0 | (wc >> 12));
+      dest += (0x80 | ((wc >> 6) & 0x3f));
+      dest += (0x80 | (wc & 0x3f));
+    }
+    else if (0x10000 <= wc && wc <= 0x1fffff)
+    {
+      dest += (0xf0 | (wc >> 18));
+      dest += (0x80 | ((wc >> 12) & 0x3f));
+      dest += (0x80 | ((wc >> 6) & 0x3f));
+      dest += (0x80 | (wc & 0x3f));
+    }
+    else if (0x200000 <= wc && wc <= 0x3ffffff)
+    {
+      dest += (0xf8 | (wc >> 24));
+      dest += (0x80 | ((wc >> 18) & 0x3f));
+      dest += (0x80 | ((wc >> 12) & 0x3f));
+      dest += (0x80 | ((wc >> 6) & 0x3f));
+      dest += (0x80 | (wc & 0x3f));
+    }
+    else if (0x4000000 <= wc && wc <= 0x7fffffff)
+    {
+      dest += (0xfc | (wc >> 30));
+      dest += (0x80 | ((wc >> 24) & 0x3f));
+      dest += (0x80 | ((wc >> 18) & 0x3f));
+      dest += (0x80 | ((wc >> 12) & 0x3f));
+      dest += (0x80 | ((wc >> 6) & 0x3f));
+      dest += (0x80 | (wc & 0x3f));
+    }
+  };
+
+  dest.reserve(dest.size() + src.length());
+
+  const char* p = src.data();
+  const char* end = p + src.size();
+  // Character at position, or '\0' when past the end (like a null-terminated string)
+  auto at = [&end](const char* pos) -> char { return (pos < end) ? *pos : '\0'; };
+  while (p < end)
+  {
+    if (*p == '\\')
+    {
+      p++;
+      if (p >= end)
+        break;
+
+      switch (*p)
+      {
+      case 'a':
+        dest += '\a';
+        p++;
+        continue;
+      case 'b':
+        dest += '\b';
+        p++;
+        continue;
+      case 'e':
+        dest += '\e';
+        p++;
+        continue;
+      case 'f':
+        dest += '\f';
+        p++;
+        continue;
+      case 'n':
+        dest += '\n';
+        p++;
+        continue;
+      case 'r':
+        dest += '\r';
+        p++;
+        continue;
+      case 't':
+        dest += '\t';
+        p++;
+        continue;
+      case 'v':
+        dest += '\v';
+        p++;
+        continue;
+
+      // hex escape
+      case 'x':
+        p++;
+        if (!std::isxdigit(at(p)))
+          dest += 'x';
+        else
+        {
+          wchar_t wch = to_hex(*p++);
+          if (std::isxdigit(at(p)))
+            wch = (wch * 16) + to_hex(*p++);
+          if (std::isxdigit(at(p)))
+            wch = (wch * 16) + to_hex(*p++);
+          if (std::isxdigit(at(p)))
+            wch = (wch * 16) + to_hex(*p++);
+          append_utf8(wch);
+        }
+        continue;
+
+      // octal escape
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      {
+        wchar_t wch = *p++ - '0';
+        if (at(p) >= '0' && at(p) <= '7')
+          wch = (wch * 8) + (*p++ - '0');
+        if (at(p) >= '0' && at(p) <= '7')
+          wch = (wch * 8) + (*p++ - '0');
+        append_utf8(wch);
+        continue;
+      }
+      }
+      // unrecognized escape: fall through to normal char handling
+    }
+
+    dest += *p++;
+  }
+}
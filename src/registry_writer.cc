@@ -0,0 +1,381 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    registry_writer.cc
+ * \brief   Offline Wine registry writer (batched changes, atomically written)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "registry_writer.h"
+#include "registry_hive.h"
+#include "registry_tokenizer.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+//// Seconds between 1601-01-01 (Windows FILETIME epoch) and 1970-01-01
+static const std::uint64_t FileTimeEpochOffset = 11644473600ULL;
+
+/**
+ * \brief Change (or add) a value of a key
+ * \param[in] file_path  File path of registry
+ * \param[in] key_name   Full path of the key, including brackets (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Registry value name (eg. Desktop), empty string for the default value (@)
+ * \param[in] data       String data (UTF-8), escaping is done by the writer
+ */
+void RegistryWriter::set_value(const string& file_path, const string& key_name, const string& value_name, const string& data)
+{
+  changes_.insert_or_assign(std::make_tuple(file_path, key_name, value_name), data);
+}
+
+/**
+ * \brief Delete a value of a key (if present)
+ * \param[in] file_path  File path of registry
+ * \param[in] key_name   Full path of the key, including brackets (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Registry value name (eg. Desktop)
+ */
+void RegistryWriter::delete_value(const string& file_path, const string& key_name, const string& value_name)
+{
+  changes_.insert_or_assign(std::make_tuple(file_path, key_name, value_name), std::nullopt);
+}
+
+/**
+ * \brief Check if there are any changes
+ * \return True when there is nothing to write
+ */
+bool RegistryWriter::empty() const
+{
+  return changes_.empty();
+}
+
+/**
+ * \brief Remove all the changes
+ */
+void RegistryWriter::clear()
+{
+  changes_.clear();
+}
+
+/**
+ * \brief Write all the changes directly into the registry files, each registry file is only written once.
+ * \throws runtime_error when a registry file could not be read or written
+ */
+void RegistryWriter::commit() const
+{
+  auto it = changes_.begin();
+  while (it != changes_.end())
+  {
+    const string& file_path = std::get<0>(it->first);
+    // All changes of the same registry file are next to each other (sorted map)
+    auto file_end = it;
+    while (file_end != changes_.end() && std::get<0>(file_end->first) == file_path)
+      ++file_end;
+    commit_file(file_path, it, file_end);
+    it = file_end;
+  }
+}
+
+/**
+ * \brief Export the changes of a single registry file as regedit (REGEDIT4) sections
+ * \param[in] file_path File path of registry
+ * \param[in] root_key  Root key of the registry file (eg. HKEY_CURRENT_USER for user.reg)
+ * \return Key sections, to be imported via 'regedit /S'. Empty string if there are no changes for this file.
+ */
+string RegistryWriter::to_regedit(const string& file_path, const string& root_key) const
+{
+  // Regedit strings only escape the backslash and quote characters
+  auto escape_regedit = [](const string& src)
+  {
+    string dest;
+    dest.reserve(src.size());
+    for (char ch : src)
+    {
+      if (ch == '\\' || ch == '"')
+        dest += '\\';
+      dest += ch;
+    }
+    return dest;
+  };
+
+  std::ostringstream output;
+  string current_key;
+  for (const auto& [change, data] : changes_)
+  {
+    const auto& [change_file_path, key_name, value_name] = change;
+    if (change_file_path != file_path)
+      continue;
+    if (key_name != current_key)
+    {
+      // Registry files are using escaped key names (double backslashes), regedit uses the plain key name
+      string plain_key_name = RegistryTokenizer::unescape(std::string_view(key_name).substr(1, key_name.size() - 2));
+      output << "\n[" << root_key << "\\" << plain_key_name << "]\n";
+      current_key = key_name;
+    }
+    if (value_name.empty())
+      output << "@=";
+    else
+      output << "\"" << escape_regedit(value_name) << "\"=";
+    if (data)
+      output << "\"" << escape_regedit(*data) << "\"\n";
+    else
+      output << "-\n";
+  }
+  return output.str();
+}
+
+/**
+ * \brief Apply the changes of one registry file and write the file
+ * \param[in] file_path File path of registry
+ * \param[in] begin     First change of this file
+ * \param[in] end       End of the changes of this file
+ * \throws runtime_error when the registry file could not be read or written
+ */
+void RegistryWriter::commit_file(const string& file_path, ChangeMap::const_iterator begin, ChangeMap::const_iterator end)
+{
+  std::ifstream reg_file(file_path, std::ios::binary);
+  if (!reg_file.is_open())
+  {
+    std::cerr << "Error: Couldn't open registry file for writing. File: " << file_path << std::endl;
+    throw std::runtime_error("Could not open registry file!");
+  }
+  string contents((std::istreambuf_iterator<char>(reg_file)), std::istreambuf_iterator<char>());
+  reg_file.close();
+
+  auto it = begin;
+  while (it != end)
+  {
+    const string& key_name = std::get<1>(it->first);
+    auto key_end = it;
+    while (key_end != end && std::get<1>(key_end->first) == key_name)
+      ++key_end;
+
+    // Registry lines of the changed values, an empty line means the value gets deleted
+    std::map<string, string> value_lines;
+    for (auto change = it; change != key_end; ++change)
+    {
+      const string& value_name = std::get<2>(change->first);
+      string escaped_name = value_name.empty() ? "@" : "\"" + escape(value_name) + "\"";
+      value_lines[escaped_name] = change->second ? escaped_name + "=\"" + escape(*change->second) + "\"" : "";
+    }
+
+    // Search the key section, the key name line also contains a timestamp (eg. [Software\\Wine] 1700000000)
+    struct Edit
+    {
+      std::size_t offset;
+      std::size_t length;
+      string replacement;
+    };
+    std::vector<Edit> edits;
+    std::size_t body_end = string::npos;
+    RegistryTokenizer tokenizer(contents);
+    std::string_view line;
+    while (tokenizer.next_line(line))
+    {
+      std::size_t offset = static_cast<std::size_t>(line.data() - contents.data());
+      if (body_end == string::npos)
+      {
+        if (line.starts_with(key_name) && (line.size() == key_name.size() || line[key_name.size()] == ' '))
+          body_end = offset + line.size();
+        continue;
+      }
+      if (line.empty())
+        break; // End of key section
+      body_end = offset + line.size();
+
+      RegistryValue value;
+      if (!RegistryTokenizer::parse_value(line, value))
+        continue;
+      // Escaped name including the quotes (or @ for the default value)
+      std::string_view line_name = line.starts_with('@') ? line.substr(0, 1) : line.substr(0, value.name.size() + 2);
+      auto value_line = value_lines.find(string(line_name));
+      if (value_line != value_lines.end())
+      {
+        if (value_line->second.empty())
+          edits.push_back({offset, line.size() + 1, ""}); // Including the newline
+        else
+          edits.push_back({offset, line.size(), value_line->second});
+        value_lines.erase(value_line);
+      }
+    }
+
+    // New values are added at the end of the key
+    string new_lines;
+    for (const auto& [escaped_name, value_line] : value_lines)
+    {
+      if (!value_line.empty())
+        new_lines += value_line + "\n";
+    }
+
+    if (body_end != string::npos)
+    {
+      if (!new_lines.empty())
+      {
+        new_lines.pop_back(); // The newline is already there
+        contents.insert(body_end, "\n" + new_lines);
+      }
+      // Apply the edits in reverse order, so the offsets stay valid
+      for (auto edit = edits.rbegin(); edit != edits.rend(); ++edit)
+        contents.replace(edit->offset, std::min(edit->length, contents.size() - edit->offset), edit->replacement);
+    }
+    else if (!new_lines.empty())
+    {
+      // Append a new key, just like Wine saves a key
+      std::uint64_t now = static_cast<std::uint64_t>(std::time(nullptr));
+      std::uint64_t file_time = (now + FileTimeEpochOffset) * 10000000ULL;
+      std::ostringstream key;
+      key << "\n" << key_name << " " << now << "\n#time=" << std::hex << file_time << "\n" << new_lines;
+      if (!contents.empty() && !contents.ends_with('\n'))
+        contents += '\n';
+      contents += key.str();
+    }
+    it = key_end;
+  }
+
+  write_file_atomic(file_path, contents);
+  RegistryHive::invalidate(file_path);
+}
+
+/**
+ * \brief Write file contents via a temporary file in the same directory, which is renamed over the original file.
+ * Readers either see the old or the new file, never a partial written file.
+ * \param[in] file_path File path
+ * \param[in] contents  New file contents
+ * \throws runtime_error when the file could not be written
+ */
+void RegistryWriter::write_file_atomic(const string& file_path, const string& contents)
+{
+  struct stat file_stat;
+  mode_t mode = (stat(file_path.c_str(), &file_stat) == 0) ? (file_stat.st_mode & 07777) : 0644;
+
+  string tmp_path = file_path + ".XXXXXX";
+  int fd = mkstemp(tmp_path.data());
+  if (fd < 0)
+  {
+    std::cerr << "Error: Couldn't create temporary registry file. File: " << tmp_path << ", error: " << std::strerror(errno) << std::endl;
+    throw std::runtime_error("Could not write registry file!");
+  }
+  bool success = (fchmod(fd, mode) == 0);
+  const char* data = contents.data();
+  std::size_t remaining = contents.size();
+  while (success && remaining > 0)
+  {
+    ssize_t written = write(fd, data, remaining);
+    if (written < 0 && errno == EINTR)
+      continue;
+    success = (written > 0);
+    if (success)
+    {
+      data += written;
+      remaining -= static_cast<std::size_t>(written);
+    }
+  }
+  success = success && (fsync(fd) == 0);
+  success = (close(fd) == 0) && success;
+  success = success && (rename(tmp_path.c_str(), file_path.c_str()) == 0);
+  if (!success)
+  {
+    std::cerr << "Error: Couldn't write registry file. File: " << file_path << ", error: " << std::strerror(errno) << std::endl;
+    unlink(tmp_path.c_str());
+    throw std::runtime_error("Could not write registry file!");
+  }
+}
+
+/**
+ * \brief Escape an UTF-8 string into a Wine registry string (reverse of RegistryTokenizer::unescape).
+ * The code is adopted from the dump_strW() method:
+ * https://source.winehq.org/git/wine.git/blob/refs/heads/master:/server/unicode.c
+ *
+ * \param[in] src UTF-8 string
+ * \return Escaped string (without quotes)
+ */
+string RegistryWriter::escape(std::string_view src)
+{
+  static const char escapes[33] = ".......abtnvfr.............e....";
+
+  // Decode UTF-8 into UTF-16 code units, which are escaped by Wine
+  std::vector<std::uint16_t> units;
+  units.reserve(src.size());
+  for (std::size_t i = 0; i < src.size();)
+  {
+    unsigned char ch = static_cast<unsigned char>(src[i]);
+    std::uint32_t code_point = ch;
+    std::size_t length = 1;
+    if (ch >= 0xf0 && i + 3 < src.size())
+    {
+      code_point = ((ch & 0x07) << 18) | ((src[i + 1] & 0x3f) << 12) | ((src[i + 2] & 0x3f) << 6) | (src[i + 3] & 0x3f);
+      length = 4;
+    }
+    else if (ch >= 0xe0 && i + 2 < src.size())
+    {
+      code_point = ((ch & 0x0f) << 12) | ((src[i + 1] & 0x3f) << 6) | (src[i + 2] & 0x3f);
+      length = 3;
+    }
+    else if (ch >= 0xc0 && i + 1 < src.size())
+    {
+      code_point = ((ch & 0x1f) << 6) | (src[i + 1] & 0x3f);
+      length = 2;
+    }
+    if (code_point > 0xffff)
+    {
+      code_point -= 0x10000;
+      units.push_back(static_cast<std::uint16_t>(0xd800 | (code_point >> 10)));
+      units.push_back(static_cast<std::uint16_t>(0xdc00 | (code_point & 0x3ff)));
+    }
+    else
+    {
+      units.push_back(static_cast<std::uint16_t>(code_point));
+    }
+    i += length;
+  }
+
+  std::ostringstream dest;
+  for (std::size_t i = 0; i < units.size(); i++)
+  {
+    std::uint16_t unit = units[i];
+    if (unit < 32)
+    {
+      // C or octal escape
+      if (escapes[unit] != '.')
+        dest << '\\' << escapes[unit];
+      else
+        dest << '\\' << std::oct << std::setw(3) << std::setfill('0') << unit << std::dec;
+    }
+    else if (unit < 127)
+    {
+      if (unit == '\\' || unit == '"')
+        dest << '\\';
+      dest << static_cast<char>(unit);
+    }
+    else
+    {
+      // Hex escape, use 4 digits when the next character is a hex digit
+      bool is_next_hex = (i + 1 < units.size() && units[i + 1] < 128 && std::isxdigit(units[i + 1]));
+      dest << "\\x" << std::hex << std::setw(is_next_hex ? 4 : 0) << std::setfill('0') << unit << std::dec;
+    }
+  }
+  return dest.str();
+}
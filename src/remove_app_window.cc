@@ -20,7 +20,7 @@
  */
 #include "remove_app_window.h"
 #include "bottle_config_file.h"
-#include "bottle_item.h"
+#include "bottle_record.h"
 #include <iostream>
 
 /**
@@ -129,7 +129,7 @@ void RemoveAppWindow::show()
  * \brief Signal handler when a new bottle is set in the main window
  * \param[in] bottle Current active bottle
  */
-void RemoveAppWindow::set_active_bottle(BottleItem* bottle)
+void RemoveAppWindow::set_active_bottle(BottleRecord* bottle)
 {
   active_bottle_ = bottle;
 }
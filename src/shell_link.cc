@@ -0,0 +1,398 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    shell_link.cc
+ * \brief   Reader of Windows shortcut files (*.lnk, MS-SHLLINK binary format)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "shell_link.h"
+#include "file_cache.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+//// Size of the ShellLinkHeader
+static const std::size_t HeaderSize = 0x4C;
+//// LinkCLSID of the header: 00021401-0000-0000-C000-000000000046
+static const unsigned char LinkClsid[16] = {0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46};
+//// Shortcuts are small, larger files are not parsed
+static const std::size_t MaxFileSize = 1024 * 1024;
+//// Maximum number of shortcuts kept in the cache (least recently used shortcut is dropped first)
+static const std::size_t MaxCachedLinks = 4096;
+
+//// LinkFlags of the header
+static const std::uint32_t HasLinkTargetIDList = 0x00000001;
+static const std::uint32_t HasLinkInfo = 0x00000002;
+static const std::uint32_t HasName = 0x00000004;
+static const std::uint32_t HasRelativePath = 0x00000008;
+static const std::uint32_t HasWorkingDir = 0x00000010;
+static const std::uint32_t HasArguments = 0x00000020;
+static const std::uint32_t HasIconLocation = 0x00000040;
+static const std::uint32_t IsUnicode = 0x00000080;
+static const std::uint32_t ForceNoLinkInfo = 0x00000100;
+//// LinkInfoFlags of the LinkInfo section
+static const std::uint32_t VolumeIDAndLocalBasePath = 0x00000001;
+static const std::uint32_t CommonNetworkRelativeLinkAndPathSuffix = 0x00000002;
+//// Signature of the EnvironmentVariableDataBlock (ExtraData section)
+static const std::uint32_t EnvironmentVariableDataBlock = 0xA0000001;
+
+//// Parsed shortcuts, the file is only parsed again when it changed on disk
+static FileCache<ShellLink> link_cache(MaxCachedLinks);
+
+/**
+ * \brief Read a little-endian 16-bit value
+ * \return False when the value is out of bounds
+ */
+static bool read_u16(std::string_view data, std::size_t offset, std::uint16_t& value)
+{
+  if (offset > data.size() || data.size() - offset < 2)
+    return false;
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data.data() + offset);
+  value = static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+  return true;
+}
+
+/**
+ * \brief Read a little-endian 32-bit value
+ * \return False when the value is out of bounds
+ */
+static bool read_u32(std::string_view data, std::size_t offset, std::uint32_t& value)
+{
+  if (offset > data.size() || data.size() - offset < 4)
+    return false;
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data.data() + offset);
+  value = static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8) | (static_cast<std::uint32_t>(bytes[2]) << 16) |
+          (static_cast<std::uint32_t>(bytes[3]) << 24);
+  return true;
+}
+
+/**
+ * \brief Append a Unicode code point as UTF-8
+ */
+static void append_utf8(string& dest, std::uint32_t code_point)
+{
+  if (code_point < 0x80)
+  {
+    dest += static_cast<char>(code_point);
+  }
+  else if (code_point < 0x800)
+  {
+    dest += static_cast<char>(0xC0 | (code_point >> 6));
+    dest += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+  else if (code_point < 0x10000)
+  {
+    dest += static_cast<char>(0xE0 | (code_point >> 12));
+    dest += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    dest += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+  else
+  {
+    dest += static_cast<char>(0xF0 | (code_point >> 18));
+    dest += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    dest += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    dest += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+/**
+ * \brief Convert UTF-16LE to UTF-8, invalid surrogates are replaced by U+FFFD
+ */
+static string utf16_to_utf8(std::string_view data)
+{
+  string result;
+  result.reserve(data.size() / 2);
+  std::uint16_t unit = 0;
+  for (std::size_t offset = 0; read_u16(data, offset, unit); offset += 2)
+  {
+    std::uint32_t code_point = unit;
+    if (unit >= 0xD800 && unit <= 0xDBFF)
+    {
+      std::uint16_t low = 0;
+      if (read_u16(data, offset + 2, low) && low >= 0xDC00 && low <= 0xDFFF)
+      {
+        code_point = 0x10000 + ((static_cast<std::uint32_t>(unit) - 0xD800) << 10) + (low - 0xDC00);
+        offset += 2;
+      }
+      else
+      {
+        code_point = 0xFFFD;
+      }
+    }
+    else if (unit >= 0xDC00 && unit <= 0xDFFF)
+    {
+      code_point = 0xFFFD;
+    }
+    append_utf8(result, code_point);
+  }
+  return result;
+}
+
+/**
+ * \brief Convert an ANSI string to UTF-8. The code page of the system that created the shortcut is unknown,
+ * so Latin-1 is assumed (the ASCII part, which includes the file extension, is always correct).
+ */
+static string ansi_to_utf8(std::string_view data)
+{
+  string result;
+  result.reserve(data.size());
+  for (char c : data)
+    append_utf8(result, static_cast<unsigned char>(c));
+  return result;
+}
+
+/**
+ * \brief Null-terminated ANSI string at offset (until the end of the data when there is no terminator)
+ */
+static string read_ansi_string(std::string_view data, std::size_t offset)
+{
+  if (offset >= data.size())
+    return "";
+  std::string_view text = data.substr(offset);
+  return ansi_to_utf8(text.substr(0, text.find('\0')));
+}
+
+/**
+ * \brief Null-terminated UTF-16LE string at offset (until the end of the data when there is no terminator)
+ */
+static string read_unicode_string(std::string_view data, std::size_t offset)
+{
+  std::size_t end = offset;
+  std::uint16_t unit = 0;
+  while (read_u16(data, end, unit) && unit != 0)
+    end += 2;
+  if (end == offset)
+    return "";
+  return utf16_to_utf8(data.substr(offset, end - offset));
+}
+
+/**
+ * \brief Target path from the LinkInfo section (local base path or network share, plus the common path suffix)
+ * \param[in] link_info LinkInfo section
+ * \return Target path or empty string
+ */
+static string parse_link_info(std::string_view link_info)
+{
+  std::uint32_t header_size = 0, flags = 0, local_base_path_offset = 0, network_link_offset = 0, suffix_offset = 0;
+  if (!read_u32(link_info, 4, header_size) || !read_u32(link_info, 8, flags) || !read_u32(link_info, 16, local_base_path_offset) ||
+      !read_u32(link_info, 20, network_link_offset) || !read_u32(link_info, 24, suffix_offset))
+    return "";
+  // Optional Unicode offsets, when the header is large enough
+  std::uint32_t local_base_path_offset_unicode = 0, suffix_offset_unicode = 0;
+  if (header_size >= 0x24)
+  {
+    read_u32(link_info, 28, local_base_path_offset_unicode);
+    read_u32(link_info, 32, suffix_offset_unicode);
+  }
+
+  string base_path;
+  if ((flags & VolumeIDAndLocalBasePath) != 0)
+  {
+    base_path = local_base_path_offset_unicode != 0 ? read_unicode_string(link_info, local_base_path_offset_unicode)
+                                                     : read_ansi_string(link_info, local_base_path_offset);
+  }
+  else if ((flags & CommonNetworkRelativeLinkAndPathSuffix) != 0 && network_link_offset < link_info.size())
+  {
+    std::string_view network_link = link_info.substr(network_link_offset);
+    std::uint32_t net_name_offset = 0, net_name_offset_unicode = 0;
+    if (read_u32(network_link, 8, net_name_offset))
+    {
+      if (net_name_offset > 0x14 && read_u32(network_link, 20, net_name_offset_unicode))
+        base_path = read_unicode_string(network_link, net_name_offset_unicode);
+      else
+        base_path = read_ansi_string(network_link, net_name_offset);
+    }
+  }
+  if (base_path.empty())
+    return "";
+
+  string suffix = suffix_offset_unicode != 0 ? read_unicode_string(link_info, suffix_offset_unicode) : read_ansi_string(link_info, suffix_offset);
+  if (!suffix.empty() && !base_path.ends_with('\\'))
+    base_path += '\\';
+  return base_path + suffix;
+}
+
+/**
+ * \brief Target path from the shell items of the LinkTargetIDList (drive item followed by file entry items)
+ * \param[in] id_list IDList (without the size field)
+ * \return Target path or empty string (eg. when the target is not on a drive)
+ */
+static string parse_id_list(std::string_view id_list)
+{
+  string path;
+  bool has_drive = false;
+  std::uint16_t item_size = 0;
+  for (std::size_t offset = 0; read_u16(id_list, offset, item_size) && item_size >= 3 && item_size <= id_list.size() - offset; offset += item_size)
+  {
+    std::string_view item = id_list.substr(offset, item_size);
+    unsigned char type = static_cast<unsigned char>(item[2]);
+    if ((type & 0x70) == 0x20)
+    {
+      // Drive (volume) item, eg. "C:\"
+      path = read_ansi_string(item, 3);
+      has_drive = !path.empty();
+    }
+    else if ((type & 0x70) == 0x30 && has_drive)
+    {
+      // File entry item, the primary name starts after the size, date, time and attributes fields
+      string name = (type & 0x04) != 0 ? read_unicode_string(item, 14) : read_ansi_string(item, 14);
+      if (name.empty())
+        return "";
+      if (!path.ends_with('\\'))
+        path += '\\';
+      path += name;
+    }
+  }
+  return has_drive ? path : "";
+}
+
+/**
+ * \brief Parse a shortcut file, sections that are truncated are skipped (the sections before are still used)
+ * \param[in] data Contents of the shortcut file
+ * \param[out] link Parsed shortcut
+ * \return False when the data is not a shortcut file (invalid header)
+ */
+bool ShellLinkReader::parse(std::string_view data, ShellLink& link)
+{
+  std::uint32_t header_size = 0, flags = 0, icon_index = 0;
+  if (!read_u32(data, 0, header_size) || header_size != HeaderSize || data.size() < HeaderSize ||
+      std::memcmp(data.data() + 4, LinkClsid, sizeof(LinkClsid)) != 0)
+    return false;
+  read_u32(data, 20, flags);
+  read_u32(data, 56, icon_index);
+  link = ShellLink{};
+  link.icon_index = static_cast<std::int32_t>(icon_index);
+
+  std::size_t offset = HeaderSize;
+  string id_list_path;
+  if ((flags & HasLinkTargetIDList) != 0)
+  {
+    std::uint16_t id_list_size = 0;
+    if (!read_u16(data, offset, id_list_size) || data.size() - offset - 2 < id_list_size)
+      return true;
+    id_list_path = parse_id_list(data.substr(offset + 2, id_list_size));
+    offset += 2 + id_list_size;
+  }
+
+  if ((flags & HasLinkInfo) != 0 && (flags & ForceNoLinkInfo) == 0)
+  {
+    std::uint32_t link_info_size = 0;
+    if (!read_u32(data, offset, link_info_size) || link_info_size < 4 || data.size() - offset < link_info_size)
+    {
+      link.target_path = id_list_path;
+      return true;
+    }
+    link.target_path = parse_link_info(data.substr(offset, link_info_size));
+    offset += link_info_size;
+  }
+
+  // StringData section, the strings are counted (not null-terminated)
+  const std::pair<std::uint32_t, string*> strings[] = {{HasName, &link.description},
+                                                        {HasRelativePath, &link.relative_path},
+                                                        {HasWorkingDir, &link.working_dir},
+                                                        {HasArguments, &link.arguments},
+                                                        {HasIconLocation, &link.icon_location}};
+  std::size_t char_size = (flags & IsUnicode) != 0 ? 2 : 1;
+  bool is_complete = true;
+  for (const auto& [flag, value] : strings)
+  {
+    if ((flags & flag) == 0)
+      continue;
+    std::uint16_t count = 0;
+    if (!read_u16(data, offset, count) || data.size() - offset - 2 < count * char_size)
+    {
+      is_complete = false;
+      break;
+    }
+    std::string_view text = data.substr(offset + 2, count * char_size);
+    *value = char_size == 2 ? utf16_to_utf8(text) : ansi_to_utf8(text);
+    offset += 2 + count * char_size;
+  }
+
+  // ExtraData section, only the environment variable block is used (target path with eg. %ProgramFiles%)
+  string environment_target;
+  std::uint32_t block_size = 0, signature = 0;
+  while (is_complete && read_u32(data, offset, block_size) && block_size >= 8 && data.size() - offset >= block_size)
+  {
+    read_u32(data, offset + 4, signature);
+    if (signature == EnvironmentVariableDataBlock && block_size >= 0x314)
+    {
+      std::string_view block = data.substr(offset, block_size);
+      environment_target = read_unicode_string(block.substr(0, 0x314), 0x10C);
+      if (environment_target.empty())
+        environment_target = read_ansi_string(block.substr(0, 0x10C), 8);
+    }
+    offset += block_size;
+  }
+
+  if (link.target_path.empty())
+    link.target_path = !environment_target.empty() ? environment_target : id_list_path;
+  return true;
+}
+
+/**
+ * \brief Get the (cached) parsed shortcut file. The file is only parsed again when it changed on disk since the previous call.
+ * \param[in] file_path Shortcut file path
+ * \return Shared shortcut or nullptr when the file could not be read or is not a shortcut file
+ */
+std::shared_ptr<const ShellLink> ShellLinkReader::open(const string& file_path)
+{
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0)
+    return nullptr;
+
+  if (auto link = link_cache.get(file_path, file_stat))
+    return link;
+
+  int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+  // Use the status of the opened file, the path could be replaced in the meantime
+  if (fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) > MaxFileSize)
+  {
+    close(fd);
+    return nullptr;
+  }
+  string data(static_cast<std::size_t>(file_stat.st_size), '\0');
+  std::size_t length = 0;
+  while (length < data.size())
+  {
+    ssize_t count = read(fd, data.data() + length, data.size() - length);
+    if (count <= 0)
+      break;
+    length += static_cast<std::size_t>(count);
+  }
+  close(fd);
+  data.resize(length);
+
+  auto link = std::make_shared<ShellLink>();
+  if (!parse(data, *link))
+    return nullptr;
+
+  link_cache.insert(file_path, file_stat, link);
+  return link;
+}
+
+/**
+ * \brief Drop a shortcut file from the cache, forcing a parse during the next open()
+ * \param[in] file_path Shortcut file path
+ */
+void ShellLinkReader::invalidate(const string& file_path)
+{
+  link_cache.erase(file_path);
+}
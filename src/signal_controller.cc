@@ -28,6 +28,7 @@
 #include "bottle_configure_window.h"
 #include "bottle_edit_window.h"
 #include "bottle_manager.h"
+#include "console_window.h"
 #include "helper.h"
 #include "main_window.h"
 #include "menu.h"
@@ -37,27 +38,20 @@
 /**
  * \brief Signal Dispatcher Constructor
  */
-SignalController::SignalController(BottleManager& manager,
-                                   Menu& menu,
-                                   PreferencesWindow& preferences_window,
-                                   AboutDialog& about_dialog,
-                                   BottleEditWindow& edit_window,
-                                   BottleCloneWindow& clone_window,
-                                   BottleConfigureEnvVarWindow& configure_env_var_window,
-                                   BottleConfigureWindow& configure_window,
-                                   AddAppWindow& add_app_window,
-                                   RemoveAppWindow& remove_app_window)
+SignalController::SignalController(BottleManager& manager, Menu& menu)
     : main_window_(nullptr),
       manager_(manager),
       menu_(menu),
-      preferences_window_(preferences_window),
-      about_dialog_(about_dialog),
-      edit_window_(edit_window),
-      clone_window_(clone_window),
-      configure_env_var_window_(configure_env_var_window),
-      configure_window_(configure_window),
-      add_app_window_(add_app_window),
-      remove_app_window_(remove_app_window)
+      active_bottle_(nullptr),
+      preferences_window_("Preferences", [this] { return std::make_unique<PreferencesWindow>(*main_window_); }),
+      about_dialog_("About", [this] { return std::make_unique<AboutDialog>(*main_window_); }),
+      edit_window_("Edit bottle", [this] { return std::make_unique<BottleEditWindow>(*main_window_); }),
+      clone_window_("Clone bottle", [this] { return std::make_unique<BottleCloneWindow>(*main_window_); }),
+      configure_env_var_window_("Environment variables", [this] { return std::make_unique<BottleConfigureEnvVarWindow>(edit_window_.get()); }),
+      configure_window_("Configure bottle", [this] { return std::make_unique<BottleConfigureWindow>(*main_window_); }),
+      add_app_window_("Add application", [this] { return std::make_unique<AddAppWindow>(*main_window_); }),
+      remove_app_window_("Remove application", [this] { return std::make_unique<RemoveAppWindow>(*main_window_); }),
+      console_window_("Console", [this] { return std::make_unique<ConsoleWindow>(*main_window_, manager_.get_console_buffer()); })
 {
   // Nothing
 }
@@ -92,71 +86,72 @@ void SignalController::set_main_window(MainWindow* main_window)
 void SignalController::dispatch_signals()
 {
   // Menu buttons
-  menu_.preferences.connect(sigc::mem_fun(preferences_window_, &PreferencesWindow::show));
+  menu_.preferences.connect([this] { preferences_window_.get().show(); });
   menu_.quit.connect(
       sigc::mem_fun(*main_window_, &MainWindow::on_hide_window)); /*!< When quit button is pressed, hide main window and therefore closes the app */
   menu_.refresh_view.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+  menu_.show_console.connect([this] { console_window_.get().show(); });
   menu_.new_bottle.connect(sigc::mem_fun(*main_window_, &MainWindow::on_new_bottle_button_clicked));
   menu_.run.connect(sigc::mem_fun(*main_window_, &MainWindow::on_run_button_clicked));
-  menu_.edit_bottle.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::show));
-  menu_.clone_bottle.connect(sigc::mem_fun(clone_window_, &BottleCloneWindow::show));
-  menu_.configure_bottle.connect(sigc::mem_fun(configure_window_, &BottleConfigureWindow::show));
+  menu_.edit_bottle.connect([this] { edit_window_.get().show(); });
+  menu_.clone_bottle.connect([this] { clone_window_.get().show(); });
+  menu_.configure_bottle.connect([this] { configure_window_.get().show(); });
   menu_.remove_bottle.connect(sigc::mem_fun(manager_, &BottleManager::delete_bottle));
   menu_.open_c_drive.connect(sigc::mem_fun(manager_, &BottleManager::open_c_drive));
   menu_.open_log_file.connect(sigc::mem_fun(manager_, &BottleManager::open_log_file));
+  menu_.open_previous_log_file.connect(sigc::mem_fun(manager_, &BottleManager::open_previous_log_file));
   menu_.give_feedback.connect(sigc::mem_fun(*main_window_, &MainWindow::on_give_feedback));
   menu_.list_issues.connect(sigc::mem_fun(*main_window_, &MainWindow::on_issue_tickets));
   menu_.check_version.connect(sigc::mem_fun(main_window_, &MainWindow::on_check_version));
-  menu_.show_about.connect(sigc::mem_fun(about_dialog_, &AboutDialog::run_dialog));
-  about_dialog_.signal_response().connect(sigc::mem_fun(about_dialog_, &AboutDialog::hide_dialog));
+  menu_.show_about.connect([this] { about_dialog_.get().run_dialog(); });
 
   // Distribute the active bottle signal from Main Window
   main_window_->active_bottle.connect(sigc::mem_fun(manager_, &BottleManager::set_active_bottle));
-  main_window_->active_bottle.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::set_active_bottle));
-  main_window_->active_bottle.connect(sigc::mem_fun(clone_window_, &BottleCloneWindow::set_active_bottle));
-  main_window_->active_bottle.connect(sigc::mem_fun(configure_env_var_window_, &BottleConfigureEnvVarWindow::set_active_bottle));
-  main_window_->active_bottle.connect(sigc::mem_fun(configure_window_, &BottleConfigureWindow::set_active_bottle));
-  main_window_->active_bottle.connect(sigc::mem_fun(add_app_window_, &AddAppWindow::set_active_bottle));
-  main_window_->active_bottle.connect(sigc::mem_fun(remove_app_window_, &RemoveAppWindow::set_active_bottle));
+  main_window_->active_bottle.connect(sigc::mem_fun(this, &SignalController::on_active_bottle));
+  main_window_->load_bottle_details.connect(sigc::mem_fun(manager_, &BottleManager::load_bottle_details));
   // Distribute the reset bottle signal from the manager
-  manager_.reset_active_bottle.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::reset_active_bottle));
-  manager_.reset_active_bottle.connect(sigc::mem_fun(clone_window_, &BottleCloneWindow::reset_active_bottle));
-  manager_.reset_active_bottle.connect(sigc::mem_fun(configure_env_var_window_, &BottleConfigureEnvVarWindow::reset_active_bottle));
-  manager_.reset_active_bottle.connect(sigc::mem_fun(configure_window_, &BottleConfigureWindow::reset_active_bottle));
-  manager_.reset_active_bottle.connect(sigc::mem_fun(add_app_window_, &AddAppWindow::reset_active_bottle));
-  manager_.reset_active_bottle.connect(sigc::mem_fun(remove_app_window_, &RemoveAppWindow::reset_active_bottle));
+  manager_.reset_active_bottle.connect(sigc::mem_fun(this, &SignalController::on_reset_active_bottle));
   manager_.reset_active_bottle.connect(sigc::mem_fun(*main_window_, &MainWindow::reset_detailed_info));
   manager_.reset_active_bottle.connect(sigc::mem_fun(*main_window_, &MainWindow::reset_application_list));
   // Removed bottle signal from the manager
-  manager_.bottle_removed.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::bottle_removed));
+  manager_.bottle_removed.connect(
+      [this]
+      {
+        if (BottleEditWindow* edit_window = edit_window_.get_if_created())
+          edit_window->bottle_removed();
+      });
+  // New output of the running programs, only shown when the console window exists (otherwise the lines are read when it's opened)
+  manager_.console_output_dispatcher.connect(
+      [this]
+      {
+        if (ConsoleWindow* console_window = console_window_.get_if_created())
+          console_window->update();
+      });
   // Package install finished (in settings window), close the busy dialog & refresh the settings window
   manager_.finished_package_install_dispatcher.connect(sigc::mem_fun(*main_window_, &MainWindow::close_busy_dialog));
-  manager_.finished_package_install_dispatcher.connect(sigc::mem_fun(configure_window_, &BottleConfigureWindow::update_installed));
+  manager_.finished_package_install_dispatcher.connect(
+      [this]
+      {
+        if (BottleConfigureWindow* configure_window = configure_window_.get_if_created())
+          configure_window->update_installed();
+      });
 
   // Menu / Toolbar actions
   main_window_->new_bottle.connect(sigc::mem_fun(this, &SignalController::on_new_bottle));
   main_window_->finished_new_bottle.connect(sigc::bind<1>(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), false));
   main_window_->run_executable.connect(sigc::mem_fun(manager_, &BottleManager::run_executable));
   main_window_->run_program.connect(sigc::mem_fun(manager_, &BottleManager::run_program));
-  main_window_->show_edit_window.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::show));
-  main_window_->show_clone_window.connect(sigc::mem_fun(clone_window_, &BottleCloneWindow::show));
-  main_window_->show_configure_window.connect(sigc::mem_fun(configure_window_, &BottleConfigureWindow::show));
+  main_window_->show_edit_window.connect([this] { edit_window_.get().show(); });
+  main_window_->show_clone_window.connect([this] { clone_window_.get().show(); });
+  main_window_->show_configure_window.connect([this] { configure_window_.get().show(); });
   main_window_->open_c_drive.connect(sigc::mem_fun(manager_, &BottleManager::open_c_drive));
   main_window_->reboot_bottle.connect(sigc::mem_fun(manager_, &BottleManager::reboot));
   main_window_->update_bottle.connect(sigc::mem_fun(manager_, &BottleManager::update));
   main_window_->open_log_file.connect(sigc::mem_fun(manager_, &BottleManager::open_log_file));
   main_window_->kill_running_processes.connect(sigc::mem_fun(manager_, &BottleManager::kill_processes));
   // App list
-  main_window_->show_add_app_window.connect(sigc::mem_fun(add_app_window_, &AddAppWindow::show));
-  main_window_->show_remove_app_window.connect(sigc::mem_fun(remove_app_window_, &RemoveAppWindow::show));
-
-  // Edit Window
-  edit_window_.configure_environment_variables.connect(sigc::mem_fun(configure_env_var_window_, &BottleConfigureEnvVarWindow::show));
-  edit_window_.update_bottle.connect(sigc::mem_fun(this, &SignalController::on_update_bottle));
-  edit_window_.remove_bottle.connect(sigc::mem_fun(manager_, &BottleManager::delete_bottle));
-
-  // Clone Window
-  clone_window_.clone_bottle.connect(sigc::mem_fun(this, &SignalController::on_clone_bottle));
+  main_window_->show_add_app_window.connect([this] { add_app_window_.get().show(); });
+  main_window_->show_remove_app_window.connect([this] { remove_app_window_.get().show(); });
 
   // Right click menu in listbox
   main_window_->right_click_menu.connect(sigc::mem_fun(this, &SignalController::on_mouse_button_pressed));
@@ -174,27 +169,79 @@ void SignalController::dispatch_signals()
   // Using Dispatcher instead of signal, will result in that the message box runs in the main thread.
   helper.failure_on_exec.connect(sigc::mem_fun(*main_window_, &MainWindow::on_exec_failure));
 
-  // Settings gaming package buttons
-  configure_window_.directx9.connect(sigc::mem_fun(manager_, &BottleManager::install_d3dx9));
-  configure_window_.dxvk.connect(sigc::mem_fun(manager_, &BottleManager::install_dxvk));
-  configure_window_.vkd3d.connect(sigc::mem_fun(manager_, &BottleManager::install_vkd3d));
-  // Settings additional package buttons
-  configure_window_.liberation_fonts.connect(sigc::mem_fun(manager_, &BottleManager::install_liberation));
-  configure_window_.corefonts.connect(sigc::mem_fun(manager_, &BottleManager::install_core_fonts));
-  configure_window_.dotnet.connect(sigc::mem_fun(manager_, &BottleManager::install_dot_net));
-  configure_window_.visual_cpp_package.connect(sigc::mem_fun(manager_, &BottleManager::install_visual_cpp_package));
+  // Signals of the secondary windows (connected once a window is constructed)
+  dispatch_window_signals();
+}
+
+/**
+ * \brief Connect the signals of the secondary windows, each window is connected right after it's constructed (on first use)
+ */
+void SignalController::dispatch_window_signals()
+{
+  about_dialog_.created.connect([](AboutDialog& about_dialog)
+                                { about_dialog.signal_response().connect(sigc::mem_fun(about_dialog, &AboutDialog::hide_dialog)); });
+
+  // Edit Window
+  edit_window_.created.connect(
+      [this](BottleEditWindow& edit_window)
+      {
+        edit_window.set_active_bottle(active_bottle_);
+        edit_window.configure_environment_variables.connect([this] { configure_env_var_window_.get().show(); });
+        edit_window.update_bottle.connect(sigc::mem_fun(this, &SignalController::on_update_bottle));
+        edit_window.remove_bottle.connect(sigc::mem_fun(manager_, &BottleManager::delete_bottle));
+      });
+
+  // Clone Window
+  clone_window_.created.connect(
+      [this](BottleCloneWindow& clone_window)
+      {
+        clone_window.set_active_bottle(active_bottle_);
+        clone_window.clone_bottle.connect(sigc::mem_fun(this, &SignalController::on_clone_bottle));
+      });
+
+  configure_window_.created.connect(
+      [this](BottleConfigureWindow& configure_window)
+      {
+        configure_window.set_active_bottle(active_bottle_);
+        // Settings gaming package buttons
+        configure_window.directx9.connect(sigc::mem_fun(manager_, &BottleManager::install_d3dx9));
+        configure_window.dxvk.connect(sigc::mem_fun(manager_, &BottleManager::install_dxvk));
+        configure_window.vkd3d.connect(sigc::mem_fun(manager_, &BottleManager::install_vkd3d));
+        // Settings additional package buttons
+        configure_window.liberation_fonts.connect(sigc::mem_fun(manager_, &BottleManager::install_liberation));
+        configure_window.corefonts.connect(sigc::mem_fun(manager_, &BottleManager::install_core_fonts));
+        configure_window.dotnet.connect(sigc::mem_fun(manager_, &BottleManager::install_dot_net));
+        configure_window.visual_cpp_package.connect(sigc::mem_fun(manager_, &BottleManager::install_visual_cpp_package));
+      });
 
   // Add new application Window
-  add_app_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+  add_app_window_.created.connect(
+      [this](AddAppWindow& add_app_window)
+      {
+        add_app_window.set_active_bottle(active_bottle_);
+        add_app_window.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+      });
 
   // Configure environment variables Window
-  configure_env_var_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+  configure_env_var_window_.created.connect(
+      [this](BottleConfigureEnvVarWindow& configure_env_var_window)
+      {
+        configure_env_var_window.set_active_bottle(active_bottle_);
+        configure_env_var_window.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+      });
 
   // Remove application Window
-  remove_app_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+  remove_app_window_.created.connect(
+      [this](RemoveAppWindow& remove_app_window)
+      {
+        remove_app_window.set_active_bottle(active_bottle_);
+        remove_app_window.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+      });
 
   // WineGUI Preference Window
-  preferences_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false));
+  preferences_window_.created.connect(
+      [this](PreferencesWindow& preferences_window)
+      { preferences_window.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), "", false)); });
 }
 
 /**
@@ -328,11 +375,13 @@ void SignalController::on_update_bottle(const UpdateBottleStruct& update_bottle_
   }
   else
   {
+    // The bottle is copied in the GUI thread, the bottle list can change while the thread is running
+    std::optional<BottleRecord> bottle = manager_.begin_update_bottle();
     // Start a new manager thread
     thread_bottle_manager_ = std::make_unique<std::thread>(
-        [this, update_bottle_struct]
+        [this, update_bottle_struct, bottle]
         {
-          manager_.update_bottle(this, update_bottle_struct.name, update_bottle_struct.folder_name, update_bottle_struct.description,
+          manager_.update_bottle(this, bottle, update_bottle_struct.name, update_bottle_struct.folder_name, update_bottle_struct.description,
                                  update_bottle_struct.windows_version, update_bottle_struct.virtual_desktop_resolution, update_bottle_struct.audio,
                                  update_bottle_struct.is_debug_logging, update_bottle_struct.debug_log_level);
         });
@@ -364,6 +413,47 @@ void SignalController::on_clone_bottle(const CloneBottleStruct& clone_bottle_str
  * (indirectly from other classes)        *
  ******************************************/
 
+/**
+ * \brief Signal handler when the active bottle changed, passed on to the windows that are already constructed
+ * \param[in] bottle New active bottle
+ */
+void SignalController::on_active_bottle(BottleRecord* bottle)
+{
+  active_bottle_ = bottle;
+  if (BottleEditWindow* edit_window = edit_window_.get_if_created())
+    edit_window->set_active_bottle(bottle);
+  if (BottleCloneWindow* clone_window = clone_window_.get_if_created())
+    clone_window->set_active_bottle(bottle);
+  if (BottleConfigureEnvVarWindow* configure_env_var_window = configure_env_var_window_.get_if_created())
+    configure_env_var_window->set_active_bottle(bottle);
+  if (BottleConfigureWindow* configure_window = configure_window_.get_if_created())
+    configure_window->set_active_bottle(bottle);
+  if (AddAppWindow* add_app_window = add_app_window_.get_if_created())
+    add_app_window->set_active_bottle(bottle);
+  if (RemoveAppWindow* remove_app_window = remove_app_window_.get_if_created())
+    remove_app_window->set_active_bottle(bottle);
+}
+
+/**
+ * \brief Signal handler for resetting the active bottle, passed on to the windows that are already constructed
+ */
+void SignalController::on_reset_active_bottle()
+{
+  active_bottle_ = nullptr;
+  if (BottleEditWindow* edit_window = edit_window_.get_if_created())
+    edit_window->reset_active_bottle();
+  if (BottleCloneWindow* clone_window = clone_window_.get_if_created())
+    clone_window->reset_active_bottle();
+  if (BottleConfigureEnvVarWindow* configure_env_var_window = configure_env_var_window_.get_if_created())
+    configure_env_var_window->reset_active_bottle();
+  if (BottleConfigureWindow* configure_window = configure_window_.get_if_created())
+    configure_window->reset_active_bottle();
+  if (AddAppWindow* add_app_window = add_app_window_.get_if_created())
+    add_app_window->reset_active_bottle();
+  if (RemoveAppWindow* remove_app_window = remove_app_window_.get_if_created())
+    remove_app_window->reset_active_bottle();
+}
+
 /**
  * \brief Signal handler when a new bottle is created, dispatched from the manager thread
  */
@@ -383,7 +473,10 @@ void SignalController::on_bottle_updated()
   this->cleanup_bottle_manager_thread();
 
   // Inform the edit window
-  edit_window_.on_bottle_updated();
+  edit_window_.get().on_bottle_updated();
+
+  // Changes of the bottle files are no longer ignored
+  manager_.end_update_bottle();
 
   // Update bottle list
   manager_.update_config_and_bottles("", false);
@@ -397,7 +490,7 @@ void SignalController::on_bottle_cloned()
   this->cleanup_bottle_manager_thread();
 
   // Inform the clone window, returns newly cloned bottle name
-  Glib::ustring new_cloned_bottle_name = clone_window_.on_bottle_cloned();
+  Glib::ustring new_cloned_bottle_name = clone_window_.get().on_bottle_cloned();
 
   // Update bottle list and select the cloned bottle
   manager_.update_config_and_bottles(new_cloned_bottle_name, false);
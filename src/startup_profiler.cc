@@ -0,0 +1,288 @@
+/**
+ * Copyright (c) 2025 WineGUI
+ *
+ * \file    startup_profiler.cc
+ * \brief   Lightweight tracing of the start-up phases (--profile-startup)
+ * \author  Melroy van den Berg <melroy@melroy.org>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "startup_profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <glibmm/fileutils.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * \brief Recorded phase or milestone (duration -1)
+ */
+struct TraceEvent
+{
+  string name;
+  string detail;
+  gint64 start_time; /*!< Relative to the start of the profile (µs) */
+  gint64 duration;   /*!< Duration (µs), -1 for a milestone */
+  int thread;
+  long resident_kb; /*!< Resident memory of the process at the milestone (KiB), 0 for a phase */
+};
+
+//// The profiler state is shared by all threads (eg. the bottle inspection workers)
+static std::atomic<bool> is_profiler_enabled(false);
+static std::mutex profiler_mutex;
+static gint64 profile_start_time = 0;
+static string trace_output_path;
+static std::set<string> pending_milestones;
+static std::vector<TraceEvent> trace_events;
+static std::map<std::thread::id, int> thread_numbers; /*!< Thread -> thread number in the trace (0 is the main thread) */
+
+/**
+ * \brief Thread number of the current thread (profiler_mutex is locked)
+ */
+static int current_thread_number()
+{
+  auto [it, _] = thread_numbers.try_emplace(std::this_thread::get_id(), static_cast<int>(thread_numbers.size()));
+  return it->second;
+}
+
+/**
+ * \brief Current resident memory (RSS) of the process
+ * \return Resident memory in KiB, 0 when unknown
+ */
+static long resident_memory()
+{
+  long pages = 0, resident_pages = 0;
+  FILE* file = std::fopen("/proc/self/statm", "r");
+  if (file == nullptr)
+    return 0;
+  if (std::fscanf(file, "%ld %ld", &pages, &resident_pages) != 2)
+    resident_pages = 0;
+  std::fclose(file);
+  return resident_pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * \brief Escape a string for a JSON string value
+ */
+static string escape_json(const string& text)
+{
+  string result;
+  result.reserve(text.size());
+  for (char c : text)
+  {
+    switch (c)
+    {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+        result += buffer;
+      }
+      else
+      {
+        result += c;
+      }
+    }
+  }
+  return result;
+}
+
+/**
+ * \brief Start a phase, nothing is recorded when the profiler is disabled
+ * \param[in] name Phase name (string literal), phases with the same name are summed in the breakdown
+ * \param[in] detail Optional detail, only shown in the trace file (eg. the bottle prefix)
+ */
+StartupProfiler::Scope::Scope(const char* name, const string& detail)
+    : name_(name), start_time_(is_profiler_enabled.load(std::memory_order_relaxed) ? g_get_monotonic_time() : 0)
+{
+  if (start_time_ != 0)
+    detail_ = detail;
+}
+
+/**
+ * \brief End of the phase
+ */
+StartupProfiler::Scope::~Scope()
+{
+  if (start_time_ != 0)
+    StartupProfiler::record(name_, detail_, start_time_, g_get_monotonic_time());
+}
+
+/**
+ * \brief Enable the profiler, the start of the profile is now. Call this from the main thread.
+ * \param[in] trace_file_path Write a Chrome trace file (JSON) to this path, empty to only print the breakdown
+ * \param[in] milestones The profile is reported once all these milestones are reached (see milestone())
+ */
+void StartupProfiler::enable(const string& trace_file_path, const std::set<string>& milestones)
+{
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  profile_start_time = g_get_monotonic_time();
+  trace_output_path = trace_file_path;
+  pending_milestones = milestones;
+  trace_events.clear();
+  thread_numbers.clear();
+  current_thread_number();
+  is_profiler_enabled = true;
+}
+
+/**
+ * \brief Is the profiler enabled (and not yet reported)
+ */
+bool StartupProfiler::is_enabled()
+{
+  return is_profiler_enabled;
+}
+
+/**
+ * \brief Record a phase of the current thread
+ * \param[in] name Phase name
+ * \param[in] detail Optional detail
+ * \param[in] start_time Start time (monotonic, µs)
+ * \param[in] end_time End time (monotonic, µs)
+ */
+void StartupProfiler::record(const char* name, const string& detail, gint64 start_time, gint64 end_time)
+{
+  if (!is_profiler_enabled)
+    return;
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  trace_events.push_back({name, detail, start_time - profile_start_time, end_time - start_time, current_thread_number(), 0});
+}
+
+/**
+ * \brief Milestone is reached (only the first time is recorded), the profile is reported once all milestones are reached
+ * \param[in] name Milestone name
+ */
+void StartupProfiler::milestone(const string& name)
+{
+  if (!is_profiler_enabled)
+    return;
+  bool is_done;
+  {
+    std::lock_guard<std::mutex> lock(profiler_mutex);
+    if (pending_milestones.erase(name) == 0)
+      return;
+    trace_events.push_back({name, "", g_get_monotonic_time() - profile_start_time, -1, current_thread_number(), resident_memory()});
+    is_done = pending_milestones.empty();
+  }
+  if (is_done)
+    report();
+}
+
+/**
+ * \brief Print the breakdown per phase (sorted on total duration) and write the trace file (if requested).
+ * The profiler is disabled afterwards, phases that are still running are not included.
+ */
+void StartupProfiler::report()
+{
+  if (!is_profiler_enabled.exchange(false))
+    return;
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+
+  struct PhaseTotal
+  {
+    string name;
+    int count = 0;
+    gint64 total = 0;
+    gint64 max = 0;
+  };
+  std::map<string, PhaseTotal> phases;
+  std::vector<const TraceEvent*> milestones;
+  for (const TraceEvent& event : trace_events)
+  {
+    if (event.duration < 0)
+    {
+      milestones.push_back(&event);
+      continue;
+    }
+    PhaseTotal& phase = phases[event.name];
+    phase.name = event.name;
+    phase.count++;
+    phase.total += event.duration;
+    phase.max = std::max(phase.max, event.duration);
+  }
+  std::vector<PhaseTotal> sorted_phases;
+  for (const auto& [_, phase] : phases)
+    sorted_phases.push_back(phase);
+  std::sort(sorted_phases.begin(), sorted_phases.end(), [](const PhaseTotal& a, const PhaseTotal& b) { return a.total > b.total; });
+
+  std::ostringstream output;
+  output << std::fixed << std::setprecision(1);
+  output << "Start-up profile:" << std::endl;
+  for (const TraceEvent* event : milestones)
+    output << "  " << std::left << std::setw(36) << event->name << std::right << std::setw(10) << (event->start_time / 1000.0) << " ms"
+           << std::setw(10) << (event->resident_kb / 1024.0) << " MB resident" << std::endl;
+  for (const string& name : pending_milestones)
+    output << "  " << std::left << std::setw(36) << name << std::right << std::setw(13) << "not reached" << std::endl;
+  output << std::endl;
+  output << "  " << std::left << std::setw(36) << "Phase" << std::right << std::setw(7) << "Count" << std::setw(13) << "Total (ms)" << std::setw(11)
+         << "Max (ms)" << std::endl;
+  for (const PhaseTotal& phase : sorted_phases)
+  {
+    output << "  " << std::left << std::setw(36) << phase.name << std::right << std::setw(7) << phase.count << std::setw(13) << (phase.total / 1000.0)
+           << std::setw(11) << (phase.max / 1000.0) << std::endl;
+  }
+  std::cout << output.str();
+
+  if (trace_output_path.empty())
+    return;
+  // Chrome trace event format, see chrome://tracing or https://ui.perfetto.dev
+  std::ostringstream trace;
+  const char* separator = "";
+  trace << "{\"traceEvents\":[";
+  for (const auto& [_, thread] : thread_numbers)
+  {
+    string thread_name = (thread == 0) ? "Main" : "Thread " + std::to_string(thread);
+    trace << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\"" << thread_name << "\"}}";
+    separator = ",";
+  }
+  for (const TraceEvent& event : trace_events)
+  {
+    trace << separator << "{\"name\":\"" << escape_json(event.name) << "\",\"cat\":\"startup\",\"pid\":1,\"tid\":" << event.thread
+          << ",\"ts\":" << event.start_time;
+    if (event.duration < 0)
+      trace << ",\"ph\":\"i\",\"s\":\"g\"";
+    else
+      trace << ",\"ph\":\"X\",\"dur\":" << event.duration;
+    if (!event.detail.empty())
+      trace << ",\"args\":{\"detail\":\"" << escape_json(event.detail) << "\"}";
+    trace << "}";
+  }
+  trace << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  try
+  {
+    Glib::file_set_contents(trace_output_path, trace.str());
+    std::cout << "INFO: Start-up trace is written to: " << trace_output_path << std::endl;
+  }
+  catch (const Glib::FileError& error)
+  {
+    std::cerr << "Error: Could not write start-up trace file: " << trace_output_path << ", error: " << error.what() << std::endl;
+  }
+}